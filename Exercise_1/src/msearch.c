@@ -0,0 +1,377 @@
+/**
+ * @file msearch.c
+ * @author Daniele Di Palma
+ * @brief Search functions on sorted arrays
+ * @date 2021-11-09
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "msort.h"
+#include "msearch.h"
+#include "msort_internal.h"
+
+#ifdef TEST
+    #define TEST_SESSION (1)
+  #else
+    #define TEST_SESSION (0)
+#endif
+
+#define ERROR_EXIT(x) { if(TEST_SESSION == 0){                        \
+                          fprintf(stderr, "[%s]-Line:%d >> "x"\n",    \
+                          __FILE__,                                   \
+                          __LINE__ );                                 \
+                        exit(EXIT_FAILURE);}}                         \
+
+// Context used for sorting indexes of keys in batch search
+typedef struct _KeysContext{
+  const char *keys;
+  unsigned long size_el;
+  int (*cmp)(const void *, const void *, void *);
+  void *ctx;
+} KeysContext;
+
+/**
+ * @brief Three-way comparator between two indexes of keys, it compares the keys
+ *
+ * @param idx_1   pointer to first index
+ * @param idx_2   pointer to second index
+ * @param ctx     pointer to KeysContext
+ * @return int    result of keys comparator
+ */
+static int keys_index_cmp(const void *idx_1, const void *idx_2, void *ctx){
+  KeysContext *keys_ctx = (KeysContext *)ctx;
+  const char *key_1 = &keys_ctx->keys[keys_ctx->size_el * *(const unsigned long *)idx_1];
+  const char *key_2 = &keys_ctx->keys[keys_ctx->size_el * *(const unsigned long *)idx_2];
+  return (*keys_ctx->cmp)(key_1, key_2, keys_ctx->ctx);
+}
+
+/**
+ * @brief Search the first position where key can be inserted in sorted array, with a branchless binary search
+ *
+ * @param key      pointer to a key element
+ * @param array_p  sorted array pointer
+ * @param size_el  size of array element
+ * @param el_num   number of array elements
+ * @param cmp      three-way comparator used for sorting
+ * @param ctx      user context passed to comparator
+ * @return unsigned long  index of first element not going before key
+ */
+unsigned long lower_bound_r(const void *key, const void *array_p, unsigned long size_el, unsigned long el_num, int (*cmp)(const void *, const void *, void *), void *ctx){
+  const char *array = (const char *)array_p;
+  unsigned long base = 0, half;
+
+  if(array == NULL && el_num > 0){
+    ERROR_EXIT("array reference can't be NULL");
+  }
+  if(cmp == NULL){
+    ERROR_EXIT("function pointer for comparison can't be NULL");
+  }
+  if(el_num == 0){
+    return 0;
+  }
+
+  // invariant: elements before base go before key, answer is in [base, base + el_num]
+  while(el_num > 1){
+    half = el_num / 2;
+    base = ((*cmp)(&array[size_el * (base + half - 1)], key, ctx) < 0) ? base + half : base;
+    el_num -= half;
+  }
+  return base + ((*cmp)(&array[size_el * base], key, ctx) < 0);
+}
+
+/**
+ * @brief Search the last position where key can be inserted in sorted array, with a branchless binary search
+ *
+ * @param key      pointer to a key element
+ * @param array_p  sorted array pointer
+ * @param size_el  size of array element
+ * @param el_num   number of array elements
+ * @param cmp      three-way comparator used for sorting
+ * @param ctx      user context passed to comparator
+ * @return unsigned long  index of first element going after key
+ */
+unsigned long upper_bound_r(const void *key, const void *array_p, unsigned long size_el, unsigned long el_num, int (*cmp)(const void *, const void *, void *), void *ctx){
+  const char *array = (const char *)array_p;
+  unsigned long base = 0, half;
+
+  if(array == NULL && el_num > 0){
+    ERROR_EXIT("array reference can't be NULL");
+  }
+  if(cmp == NULL){
+    ERROR_EXIT("function pointer for comparison can't be NULL");
+  }
+  if(el_num == 0){
+    return 0;
+  }
+
+  // invariant: elements before base don't go after key, answer is in [base, base + el_num]
+  while(el_num > 1){
+    half = el_num / 2;
+    base = ((*cmp)(&array[size_el * (base + half - 1)], key, ctx) <= 0) ? base + half : base;
+    el_num -= half;
+  }
+  return base + ((*cmp)(&array[size_el * base], key, ctx) <= 0);
+}
+
+/**
+ * @brief Search the range of elements equal to key in sorted array
+ *
+ * @param key      pointer to a key element
+ * @param array_p  sorted array pointer
+ * @param size_el  size of array element
+ * @param el_num   number of array elements
+ * @param cmp      three-way comparator used for sorting
+ * @param ctx      user context passed to comparator
+ * @param first    where index of first element equal to key is stored
+ * @param last     where index after last element equal to key is stored
+ */
+void equal_range_r(const void *key, const void *array_p, unsigned long size_el, unsigned long el_num, int (*cmp)(const void *, const void *, void *), void *ctx, unsigned long *first, unsigned long *last){
+  const char *array = (const char *)array_p;
+
+  if(first == NULL || last == NULL){
+    ERROR_EXIT("range references can't be NULL");
+  }
+
+  *first = lower_bound_r(key, array, size_el, el_num, cmp, ctx);
+  *last = *first + upper_bound_r(key, &array[size_el * *first], size_el, el_num - *first, cmp, ctx);
+}
+
+/**
+ * @brief Search the range of elements between two keys (both included) in sorted array
+ *
+ * @param min_key  pointer to the smallest key of range
+ * @param max_key  pointer to the greatest key of range
+ * @param array_p  sorted array pointer
+ * @param size_el  size of array element
+ * @param el_num   number of array elements
+ * @param cmp      three-way comparator used for sorting
+ * @param ctx      user context passed to comparator
+ * @param first    where index of first element not going before min_key is stored
+ * @param last     where index of first element going after max_key is stored
+ */
+void key_range_r(const void *min_key, const void *max_key, const void *array_p, unsigned long size_el, unsigned long el_num, int (*cmp)(const void *, const void *, void *), void *ctx, unsigned long *first, unsigned long *last){
+  const char *array = (const char *)array_p;
+
+  if(first == NULL || last == NULL){
+    ERROR_EXIT("range references can't be NULL");
+  }
+
+  *first = lower_bound_r(min_key, array, size_el, el_num, cmp, ctx);
+  *last = *first + upper_bound_r(max_key, &array[size_el * *first], size_el, el_num - *first, cmp, ctx);
+}
+
+/**
+ * @brief Search lower bound of many keys sweeping sorted array once, in order of keys
+ *
+ * @param keys     array of keys
+ * @param key_num  number of keys
+ * @param array_p  sorted array pointer
+ * @param size_el  size of array element
+ * @param el_num   number of array elements
+ * @param cmp      three-way comparator used for sorting
+ * @param ctx      user context passed to comparator
+ * @param results  where lower bound of keys[i] is stored in results[i]
+ */
+void batch_lower_bound_r(const void *keys, unsigned long key_num, const void *array_p, unsigned long size_el, unsigned long el_num, int (*cmp)(const void *, const void *, void *), void *ctx, unsigned long *results){
+  const char *array = (const char *)array_p;
+  unsigned long *order = NULL;
+  unsigned long pos = 0, step, end;
+  const char *key;
+
+  if(keys == NULL || results == NULL){
+    ERROR_EXIT("keys and results references can't be NULL");
+  }
+  if(key_num == 0){
+    return;
+  }
+
+  order = (unsigned long *)malloc(key_num * sizeof(unsigned long));
+  if(order == NULL){
+    ERROR_EXIT("unable to allocate memory for keys order");
+  }
+  for(unsigned long i = 0; i < key_num; i++){
+    order[i] = i;
+  }
+
+  KeysContext keys_ctx = { (const char *)keys, size_el, cmp, ctx };
+  sort_r(order, sizeof(unsigned long), 0, key_num - 1, keys_index_cmp, &keys_ctx);
+
+  for(unsigned long i = 0; i < key_num; i++){
+    key = &((const char *)keys)[size_el * order[i]];
+
+    // exponential steps from previous lower bound, then binary search in the last step
+    step = 1;
+    end = pos;
+    while(end < el_num && (*cmp)(&array[size_el * end], key, ctx) < 0){
+      pos = end + 1;
+      end += step;
+      step *= 2;
+    }
+    if(end > el_num){
+      end = el_num;
+    }
+    pos += lower_bound_r(key, &array[size_el * pos], size_el, end - pos, cmp, ctx);
+    results[order[i]] = pos;
+  }
+
+  free(order);
+}
+
+/**
+ * @brief Search the first position where key can be inserted in array sorted using precedes function pointer
+ *
+ * @param key       pointer to a key element
+ * @param array     sorted array pointer
+ * @param size_el   size of array element
+ * @param el_num    number of array elements
+ * @param precedes  pointer function for precedence relation between elements. 
+ *                  This function must return 2 if elements are equal, 1 if first element precede second, 0 otherwise.
+ * @return unsigned long  index of first element not going before key
+ */
+unsigned long lower_bound(const void *key, const void *array, unsigned long size_el, unsigned long el_num, int(*precedes)(void *, void *)){
+  if(precedes == NULL){
+    ERROR_EXIT("function pointer for precedence relation can't be NULL");
+  }
+
+  PrecedesContext precedes_ctx = { precedes };
+  return lower_bound_r(key, array, size_el, el_num, precedes_cmp, &precedes_ctx);
+}
+
+/**
+ * @brief Search the last position where key can be inserted in array sorted using precedes function pointer
+ *
+ * @param key       pointer to a key element
+ * @param array     sorted array pointer
+ * @param size_el   size of array element
+ * @param el_num    number of array elements
+ * @param precedes  pointer function for precedence relation between elements (see lower_bound)
+ * @return unsigned long  index of first element going after key
+ */
+unsigned long upper_bound(const void *key, const void *array, unsigned long size_el, unsigned long el_num, int(*precedes)(void *, void *)){
+  if(precedes == NULL){
+    ERROR_EXIT("function pointer for precedence relation can't be NULL");
+  }
+
+  PrecedesContext precedes_ctx = { precedes };
+  return upper_bound_r(key, array, size_el, el_num, precedes_cmp, &precedes_ctx);
+}
+
+/**
+ * @brief Search the range of elements equal to key in array sorted using precedes function pointer
+ *
+ * @param key       pointer to a key element
+ * @param array     sorted array pointer
+ * @param size_el   size of array element
+ * @param el_num    number of array elements
+ * @param precedes  pointer function for precedence relation between elements (see lower_bound)
+ * @param first     where index of first element equal to key is stored
+ * @param last      where index after last element equal to key is stored
+ */
+void equal_range(const void *key, const void *array, unsigned long size_el, unsigned long el_num, int(*precedes)(void *, void *), unsigned long *first, unsigned long *last){
+  if(precedes == NULL){
+    ERROR_EXIT("function pointer for precedence relation can't be NULL");
+  }
+
+  PrecedesContext precedes_ctx = { precedes };
+  equal_range_r(key, array, size_el, el_num, precedes_cmp, &precedes_ctx, first, last);
+}
+
+/**
+ * @brief Copy sorted elements in Eytzinger order with an in-order visit of the implicit tree
+ *
+ * @param eytzinger     destination structure
+ * @param sorted_array  sorted array pointer
+ * @param next          index of next sorted element to copy
+ * @param k             position of actual tree node
+ */
+static void eytzinger_fill(EytzingerArray *eytzinger, const char *sorted_array, unsigned long *next, unsigned long k){
+  if(k <= eytzinger->el_num){
+    eytzinger_fill(eytzinger, sorted_array, next, 2*k);
+    memcpy(&eytzinger->array[eytzinger->size_el * k], &sorted_array[eytzinger->size_el * *next], eytzinger->size_el);
+    (*next)++;
+    eytzinger_fill(eytzinger, sorted_array, next, 2*k + 1);
+  }
+}
+
+/**
+ * @brief Build Eytzinger layout copying a sorted array
+ *
+ * @param sorted_array  sorted array pointer
+ * @param size_el       size of array element
+ * @param el_num        number of array elements
+ * @return EytzingerArray*  allocated structure
+ */
+EytzingerArray *eytzinger_build(const void *sorted_array, unsigned long size_el, unsigned long el_num){
+  EytzingerArray *eytzinger = NULL;
+  unsigned long next = 0;
+
+  if(sorted_array == NULL && el_num > 0){
+    ERROR_EXIT("array reference can't be NULL");
+  }
+
+  eytzinger = (EytzingerArray *)malloc(sizeof(EytzingerArray));
+  if(eytzinger == NULL){
+    ERROR_EXIT("unable to allocate memory for Eytzinger structure");
+  }
+  eytzinger->array = (char *)malloc((el_num + 1) * size_el);
+  if(eytzinger->array == NULL){
+    ERROR_EXIT("unable to allocate memory for Eytzinger array");
+  }
+  eytzinger->size_el = size_el;
+  eytzinger->el_num = el_num;
+
+  eytzinger_fill(eytzinger, (const char *)sorted_array, &next, 1);
+  return eytzinger;
+}
+
+/**
+ * @brief Search first element not going before key descending the implicit tree, next levels are prefetched
+ *
+ * @param key        pointer to a key element
+ * @param eytzinger  Eytzinger array
+ * @param cmp        three-way comparator used for sorting
+ * @param ctx        user context passed to comparator
+ * @return void*  pointer to found element, NULL if all elements go before key
+ */
+void *eytzinger_lower_bound_r(const void *key, const EytzingerArray *eytzinger, int (*cmp)(const void *, const void *, void *), void *ctx){
+  unsigned long k = 1, ahead;
+
+  if(eytzinger == NULL){
+    ERROR_EXIT("Eytzinger reference can't be NULL");
+  }
+  if(cmp == NULL){
+    ERROR_EXIT("function pointer for comparison can't be NULL");
+  }
+
+  // go left if node doesn't go before key, right otherwise,
+  // prefetched position (four levels down) is clamped to last element of array
+  while(k <= eytzinger->el_num){
+    ahead = (16 * k <= eytzinger->el_num) ? 16 * k : eytzinger->el_num;
+    __builtin_prefetch(&eytzinger->array[eytzinger->size_el * ahead]);
+    k = 2*k + ((*cmp)(&eytzinger->array[eytzinger->size_el * k], key, ctx) < 0);
+  }
+
+  // remove right turns (trailing ones) and last left turn to find the node of lower bound
+  k >>= __builtin_ffsl((long)~k);
+  if(k == 0){
+    return NULL;
+  }
+  return &eytzinger->array[eytzinger->size_el * k];
+}
+
+/**
+ * @brief Free Eytzinger array
+ *
+ * @param eytzinger  structure to free
+ */
+void eytzinger_free(EytzingerArray *eytzinger){
+  if(eytzinger != NULL){
+    free(eytzinger->array);
+    free(eytzinger);
+  }
+}
@@ -0,0 +1,164 @@
+#ifndef _M_SEARCH_H_
+#define _M_SEARCH_H_
+
+// Search in an array sorted with sort() or sort_r()
+/**
+ * @brief Search the first position in sorted array where key can be inserted keeping the order,
+ *        before all elements equal to key.
+ *
+ * @param key       pointer to a key element
+ * @param array     sorted array pointer
+ * @param size_el   size of array element
+ * @param el_num    number of array elements
+ * @param precedes  pointer function for precedence relation between elements used for sorting.
+ *                  This function must return 2 if elements are equal, 1 if first element precede second, 0 otherwise.
+ * @return          index of first element not going before key, el_num if there is no such element
+ */
+unsigned long lower_bound(const void *key, const void *array, unsigned long size_el, unsigned long el_num, int(*precedes)(void *, void *));
+
+/**
+ * @brief Search the last position in sorted array where key can be inserted keeping the order,
+ *        after all elements equal to key.
+ *
+ * @param key       pointer to a key element
+ * @param array     sorted array pointer
+ * @param size_el   size of array element
+ * @param el_num    number of array elements
+ * @param precedes  pointer function for precedence relation between elements used for sorting (see lower_bound)
+ * @return          index of first element going after key, el_num if there is no such element
+ */
+unsigned long upper_bound(const void *key, const void *array, unsigned long size_el, unsigned long el_num, int(*precedes)(void *, void *));
+
+/**
+ * @brief Search the range of elements equal to key in sorted array.
+ *        Range is empty (first == last) when key is not found.
+ *
+ * @param key       pointer to a key element
+ * @param array     sorted array pointer
+ * @param size_el   size of array element
+ * @param el_num    number of array elements
+ * @param precedes  pointer function for precedence relation between elements used for sorting (see lower_bound)
+ * @param first     where index of first element equal to key is stored
+ * @param last      where index after last element equal to key is stored
+ */
+void equal_range(const void *key, const void *array, unsigned long size_el, unsigned long el_num, int(*precedes)(void *, void *), unsigned long *first, unsigned long *last);
+
+// Same functions using a three-way comparator with user context (see sort_r)
+/**
+ * @brief Search the first position in sorted array where key can be inserted, before all elements equal to key.
+ *        Binary search is branchless: the loop runs always ceil(log2(el_num)) + 1 comparisons
+ *        and the index update compiles to a conditional move.
+ *
+ * @param key       pointer to a key element
+ * @param array     sorted array pointer
+ * @param size_el   size of array element
+ * @param el_num    number of array elements
+ * @param cmp       three-way comparator used for sorting, it receives an array element as first argument
+ *                  and key as second one
+ * @param ctx       user context passed unchanged to cmp, can be NULL
+ * @return          index of first element not going before key, el_num if there is no such element
+ */
+unsigned long lower_bound_r(const void *key, const void *array, unsigned long size_el, unsigned long el_num, int (*cmp)(const void *, const void *, void *), void *ctx);
+
+/**
+ * @brief Search the last position in sorted array where key can be inserted, after all elements equal to key.
+ *        Branchless as lower_bound_r.
+ *
+ * @param key       pointer to a key element
+ * @param array     sorted array pointer
+ * @param size_el   size of array element
+ * @param el_num    number of array elements
+ * @param cmp       three-way comparator used for sorting (see lower_bound_r)
+ * @param ctx       user context passed unchanged to cmp, can be NULL
+ * @return          index of first element going after key, el_num if there is no such element
+ */
+unsigned long upper_bound_r(const void *key, const void *array, unsigned long size_el, unsigned long el_num, int (*cmp)(const void *, const void *, void *), void *ctx);
+
+/**
+ * @brief Search the range of elements equal to key in sorted array.
+ *
+ * @param key       pointer to a key element
+ * @param array     sorted array pointer
+ * @param size_el   size of array element
+ * @param el_num    number of array elements
+ * @param cmp       three-way comparator used for sorting (see lower_bound_r)
+ * @param ctx       user context passed unchanged to cmp, can be NULL
+ * @param first     where index of first element equal to key is stored
+ * @param last      where index after last element equal to key is stored
+ */
+void equal_range_r(const void *key, const void *array, unsigned long size_el, unsigned long el_num, int (*cmp)(const void *, const void *, void *), void *ctx, unsigned long *first, unsigned long *last);
+
+/**
+ * @brief Search the range of elements between two keys (both included) in sorted array.
+ *
+ * @param min_key   pointer to the smallest key of range
+ * @param max_key   pointer to the greatest key of range
+ * @param array     sorted array pointer
+ * @param size_el   size of array element
+ * @param el_num    number of array elements
+ * @param cmp       three-way comparator used for sorting (see lower_bound_r)
+ * @param ctx       user context passed unchanged to cmp, can be NULL
+ * @param first     where index of first element not going before min_key is stored
+ * @param last      where index of first element going after max_key is stored
+ */
+void key_range_r(const void *min_key, const void *max_key, const void *array, unsigned long size_el, unsigned long el_num, int (*cmp)(const void *, const void *, void *), void *ctx, unsigned long *first, unsigned long *last);
+
+/**
+ * @brief Search lower bound of many keys with a single sweep of the sorted array.
+ *        Keys are sorted (by index, keys array is not modified), then every lower bound
+ *        is searched with exponential steps starting from the previous one.
+ *        For q keys it costs O(q log(el_num/q)) comparisons instead of O(q log el_num).
+ *
+ * @param keys      array of keys, elements of same type of array
+ * @param key_num   number of keys
+ * @param array     sorted array pointer
+ * @param size_el   size of array element
+ * @param el_num    number of array elements
+ * @param cmp       three-way comparator used for sorting (see lower_bound_r)
+ * @param ctx       user context passed unchanged to cmp, can be NULL
+ * @param results   array of key_num indexes where lower bound of keys[i] is stored in results[i]
+ */
+void batch_lower_bound_r(const void *keys, unsigned long key_num, const void *array, unsigned long size_el, unsigned long el_num, int (*cmp)(const void *, const void *, void *), void *ctx, unsigned long *results);
+
+// Sorted array in Eytzinger (breadth first) layout
+/**
+ * @brief It rappresents a sorted array stored in Eytzinger order: element in position k
+ *        has children in positions 2k and 2k+1 (position 0 is not used).
+ *        First levels of the implicit tree are contiguous in memory, so a search
+ *        touches few cache lines and next levels can be prefetched.
+ */
+typedef struct _EytzingerArray{
+  char *array;            // elements in Eytzinger order, (el_num + 1) * size_el bytes
+  unsigned long size_el;  // size of element
+  unsigned long el_num;   // number of elements
+} EytzingerArray;
+
+/**
+ * @brief Build Eytzinger layout from a sorted array. Sorted array is copied, it is not modified.
+ *
+ * @param sorted_array  sorted array pointer
+ * @param size_el       size of array element
+ * @param el_num        number of array elements
+ * @return EytzingerArray*  allocated structure, to free with eytzinger_free
+ */
+EytzingerArray *eytzinger_build(const void *sorted_array, unsigned long size_el, unsigned long el_num);
+
+/**
+ * @brief Search first element not going before key in Eytzinger layout.
+ *
+ * @param key       pointer to a key element
+ * @param eytzinger Eytzinger array
+ * @param cmp       three-way comparator used for sorting (see lower_bound_r)
+ * @param ctx       user context passed unchanged to cmp, can be NULL
+ * @return void*    pointer to found element in Eytzinger array, NULL if all elements go before key
+ */
+void *eytzinger_lower_bound_r(const void *key, const EytzingerArray *eytzinger, int (*cmp)(const void *, const void *, void *), void *ctx);
+
+/**
+ * @brief Free Eytzinger array
+ *
+ * @param eytzinger structure to free
+ */
+void eytzinger_free(EytzingerArray *eytzinger);
+
+#endif
@@ -0,0 +1,184 @@
+/**
+ * @file msearch_test.c
+ * @author Daniele Di Palma
+ * @brief Test suite for search functions on sorted arrays
+ * @date 2021-11-09
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "msort.h"
+#include "msearch.h"
+
+/*
+ * Test suite for search library on sorted arrays
+ */
+
+// precedence relation and comparator used in tests
+static int precedes_int(void *el_1, void *el_2){
+  int *iel_1_p = (int *)el_1;
+  int *iel_2_p = (int *)el_2;
+  if(*iel_1_p == *iel_2_p){
+    return (2);
+  }else if(*iel_1_p > *iel_2_p)
+    return (1);
+  return (0);
+}
+
+static int compare_int(const void *el_1, const void *el_2, void *ctx){
+  (void)ctx;
+  int iel_1_v = *(const int *)el_1;
+  int iel_2_v = *(const int *)el_2;
+  return (iel_1_v > iel_2_v) - (iel_1_v < iel_2_v);
+}
+
+// sorted array used in tests
+static int sorted_arr[] = {-5, 0, 3, 3, 3, 7, 10, 10, 42};
+static const unsigned long sorted_num = 9;
+
+void setUp(void){
+}
+
+void tearDown(void){
+}
+
+static void test_lower_bound_found(void){
+  int key = 3;
+  TEST_ASSERT_EQUAL_UINT64(2, lower_bound(&key, sorted_arr, sizeof(int), sorted_num, precedes_int));
+}
+
+static void test_lower_bound_not_found(void){
+  int key = 5;
+  TEST_ASSERT_EQUAL_UINT64(5, lower_bound(&key, sorted_arr, sizeof(int), sorted_num, precedes_int));
+}
+
+static void test_lower_bound_before_all(void){
+  int key = -100;
+  TEST_ASSERT_EQUAL_UINT64(0, lower_bound_r(&key, sorted_arr, sizeof(int), sorted_num, compare_int, NULL));
+}
+
+static void test_lower_bound_after_all(void){
+  int key = 100;
+  TEST_ASSERT_EQUAL_UINT64(sorted_num, lower_bound_r(&key, sorted_arr, sizeof(int), sorted_num, compare_int, NULL));
+}
+
+static void test_lower_bound_empty_array(void){
+  int key = 1;
+  TEST_ASSERT_EQUAL_UINT64(0, lower_bound_r(&key, sorted_arr, sizeof(int), 0, compare_int, NULL));
+}
+
+static void test_upper_bound_found(void){
+  int key = 10;
+  TEST_ASSERT_EQUAL_UINT64(8, upper_bound(&key, sorted_arr, sizeof(int), sorted_num, precedes_int));
+}
+
+static void test_upper_bound_after_all(void){
+  int key = 42;
+  TEST_ASSERT_EQUAL_UINT64(sorted_num, upper_bound_r(&key, sorted_arr, sizeof(int), sorted_num, compare_int, NULL));
+}
+
+static void test_equal_range_found(void){
+  int key = 3;
+  unsigned long first, last;
+
+  equal_range(&key, sorted_arr, sizeof(int), sorted_num, precedes_int, &first, &last);
+  TEST_ASSERT_EQUAL_UINT64(2, first);
+  TEST_ASSERT_EQUAL_UINT64(5, last);
+}
+
+static void test_equal_range_not_found(void){
+  int key = 8;
+  unsigned long first, last;
+
+  equal_range_r(&key, sorted_arr, sizeof(int), sorted_num, compare_int, NULL, &first, &last);
+  TEST_ASSERT_EQUAL_UINT64(first, last);
+  TEST_ASSERT_EQUAL_UINT64(6, first);
+}
+
+static void test_key_range(void){
+  int min_key = 1, max_key = 10;
+  unsigned long first, last;
+
+  key_range_r(&min_key, &max_key, sorted_arr, sizeof(int), sorted_num, compare_int, NULL, &first, &last);
+  TEST_ASSERT_EQUAL_UINT64(2, first);
+  TEST_ASSERT_EQUAL_UINT64(8, last);
+}
+
+static void test_key_range_inverted_keys(void){
+  int min_key = 10, max_key = 1;
+  unsigned long first, last;
+
+  key_range_r(&min_key, &max_key, sorted_arr, sizeof(int), sorted_num, compare_int, NULL, &first, &last);
+  TEST_ASSERT_EQUAL_UINT64(first, last);
+}
+
+static void test_batch_lower_bound(void){
+  int keys[] = {42, -10, 3, 100, 7, 3, 0};
+  unsigned long exp_results[] = {8, 0, 2, 9, 5, 2, 1};
+  unsigned long results[7];
+
+  batch_lower_bound_r(keys, 7, sorted_arr, sizeof(int), sorted_num, compare_int, NULL, results);
+  TEST_ASSERT_EQUAL_UINT64_ARRAY(exp_results, results, 7);
+}
+
+static void test_batch_lower_bound_same_as_lower_bound(void){
+  int arr[1000], keys[300];
+  unsigned long results[300];
+
+  srand(5);
+  for(int i = 0; i < 1000; i++){
+    arr[i] = rand() % 2000;
+  }
+  for(int i = 0; i < 300; i++){
+    keys[i] = rand() % 2200 - 100;
+  }
+  sort_r(arr, sizeof(int), 0, 999, compare_int, NULL);
+  batch_lower_bound_r(keys, 300, arr, sizeof(int), 1000, compare_int, NULL, results);
+  for(int i = 0; i < 300; i++){
+    TEST_ASSERT_EQUAL_UINT64(lower_bound_r(&keys[i], arr, sizeof(int), 1000, compare_int, NULL), results[i]);
+  }
+}
+
+static void test_eytzinger_lower_bound(void){
+  EytzingerArray *eytzinger = eytzinger_build(sorted_arr, sizeof(int), sorted_num);
+  int key;
+
+  for(key = -6; key <= 42; key++){
+    unsigned long pos = lower_bound_r(&key, sorted_arr, sizeof(int), sorted_num, compare_int, NULL);
+    int *found = (int *)eytzinger_lower_bound_r(&key, eytzinger, compare_int, NULL);
+    TEST_ASSERT_NOT_NULL(found);
+    TEST_ASSERT_EQUAL_INT(sorted_arr[pos], *found);
+  }
+  key = 43;
+  TEST_ASSERT_NULL(eytzinger_lower_bound_r(&key, eytzinger, compare_int, NULL));
+
+  eytzinger_free(eytzinger);
+}
+
+int main(void){
+
+  // test session
+  UNITY_BEGIN();
+
+  RUN_TEST(test_lower_bound_found);
+  RUN_TEST(test_lower_bound_not_found);
+  RUN_TEST(test_lower_bound_before_all);
+  RUN_TEST(test_lower_bound_after_all);
+  RUN_TEST(test_lower_bound_empty_array);
+  RUN_TEST(test_upper_bound_found);
+  RUN_TEST(test_upper_bound_after_all);
+  RUN_TEST(test_equal_range_found);
+  RUN_TEST(test_equal_range_not_found);
+  RUN_TEST(test_key_range);
+  RUN_TEST(test_key_range_inverted_keys);
+  RUN_TEST(test_batch_lower_bound);
+  RUN_TEST(test_batch_lower_bound_same_as_lower_bound);
+  RUN_TEST(test_eytzinger_lower_bound);
+
+  return UNITY_END();
+}
@@ -12,6 +12,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "msort.h"
+#include "msort_internal.h"
 
 #ifdef TEST
     #define TEST_SESSION (1)
@@ -26,84 +27,381 @@
                         exit(EXIT_FAILURE);}}                         \
 
 #define K (10)
+#define SWAP_CHUNK (64)
+#define MIN_GALLOP (7)
+#define MAX_DISTINCT_KEYS (64)
 
-static void binary_insertion_sort(void *array, unsigned long size_el, unsigned long left, unsigned long right, int (precedes)(void *, void*));
-static unsigned long binary_search(void *key, void *array, unsigned long size_el, unsigned long left, unsigned long right, int (precedes)(void *,void *));
+static void sort_buffered(char *array, unsigned long size_el, unsigned long first, unsigned long last, char *buffer, int gallop, int (*cmp)(const void *, const void *, void *), void *ctx);
+static void sort_inplace(char *array, unsigned long size_el, unsigned long first, unsigned long last, int (*cmp)(const void *, const void *, void *), void *ctx);
 
 /**
- * @brief Merge two sub-array in a single array, using specified rule for sorting 
+ * @brief Swap two elements of size_el bytes, using a small fixed buffer on the stack
  * 
- * @param array     array pointer that will be merged
+ * @param el_1      pointer to first element
+ * @param el_2      pointer to second element
+ * @param size_el   size of element
+ */
+static void swap_elements(char *el_1, char *el_2, unsigned long size_el){
+  char temp[SWAP_CHUNK];
+  unsigned long chunk;
+
+  while(size_el > 0){
+    chunk = size_el < SWAP_CHUNK ? size_el : SWAP_CHUNK;
+    memcpy(temp, el_1, chunk);
+    memcpy(el_1, el_2, chunk);
+    memcpy(el_2, temp, chunk);
+    el_1 += chunk;
+    el_2 += chunk;
+    size_el -= chunk;
+  }
+}
+
+/**
+ * @brief Reverse elements of array in range [first, last)
+ * 
+ * @param array     array pointer
  * @param size_el   size of array element
- * @param left      start index of array
- * @param mid       mid position index of array
- * @param right     last index of array
- * @param precedes  pointer to a function that implement the precedence relation between the array elements,
- *                  this function have to return 2 if first and second element are equal
- *                  1 if the first element precede the second one, 0 otherwise
- * @return void*    return pointer to ordinated array memory allocation
+ * @param first     first index of range
+ * @param last      index after the last element of range
  */
-static void merge(void *array_p, unsigned long size_el, unsigned long left, unsigned long mid, unsigned long right, int(*precedes)(void *, void *)){
-  
-  char *ordered_array = (char *)malloc((right-left + 1) * size_el);
-  if(ordered_array == NULL){
-    ERROR_EXIT("unable to allocate memory for ordered_array");
+static void reverse(char *array, unsigned long size_el, unsigned long first, unsigned long last){
+  while(first + 1 < last){
+    last--;
+    swap_elements(&array[size_el * first], &array[size_el * last], size_el);
+    first++;
   }
+}
 
-  char *array = (char *)array_p;
+/**
+ * @brief Rotate elements of array in range [first, last) so that element in middle position becomes the first one
+ * 
+ * @param array     array pointer
+ * @param size_el   size of array element
+ * @param first     first index of range
+ * @param middle    index of element that will be moved in first position
+ * @param last      index after the last element of range
+ */
+static void rotate(char *array, unsigned long size_el, unsigned long first, unsigned long middle, unsigned long last){
+  if(first == middle || middle == last){
+    return;
+  }
+  reverse(array, size_el, first, middle);
+  reverse(array, size_el, middle, last);
+  reverse(array, size_el, first, last);
+}
+
+/**
+ * @brief Search in sorted range [first, last) the first element that does not go before key
+ *        (first position where key can be inserted before equal elements)
+ * 
+ * @param key       pointer to a key element
+ * @param array     array pointer
+ * @param size_el   size of array element
+ * @param first     first index of range
+ * @param last      index after the last element of range
+ * @param cmp       three-way comparator
+ * @param ctx       user context passed to comparator
+ * @return          index of found position, last if all elements go before key
+ */
+static unsigned long lower_position(const void *key, char *array, unsigned long size_el, unsigned long first, unsigned long last, int (*cmp)(const void *, const void *, void *), void *ctx){
+  unsigned long mid;
+
+  while(first < last){
+    mid = first + (last - first)/2;
+    if((*cmp)(&array[size_el * mid], key, ctx) < 0){
+      first = mid + 1;
+    }else{
+      last = mid;
+    }
+  }
+  return first;
+}
+
+/**
+ * @brief Search in sorted range [first, last) the first element that goes after key
+ *        (first position where key can be inserted after equal elements)
+ * 
+ * @param key       pointer to a key element
+ * @param array     array pointer
+ * @param size_el   size of array element
+ * @param first     first index of range
+ * @param last      index after the last element of range
+ * @param cmp       three-way comparator
+ * @param ctx       user context passed to comparator
+ * @return          index of found position, last if no element goes after key
+ */
+static unsigned long upper_position(const void *key, char *array, unsigned long size_el, unsigned long first, unsigned long last, int (*cmp)(const void *, const void *, void *), void *ctx){
+  unsigned long mid;
 
-  unsigned long i = left;     // index for left sub-array
-  unsigned long j = mid + 1;  // index for right sub-array
-  unsigned long k = 0;        // index for ordered array
+  while(first < last){
+    mid = first + (last - first)/2;
+    if((*cmp)(key, &array[size_el * mid], ctx) < 0){
+      last = mid;
+    }else{
+      first = mid + 1;
+    }
+  }
+  return first;
+}
+
+/**
+ * @brief Stable binary insertion sort of range [first, last).
+ *        The insertion position is found by binary search, then the block of greater elements
+ *        is shifted with a single memmove.
+ * 
+ * @param array     array pointer
+ * @param size_el   size of array element
+ * @param first     first index of range
+ * @param last      index after the last element of range
+ * @param temp      memory area for one element
+ * @param cmp       three-way comparator
+ * @param ctx       user context passed to comparator
+ */
+static void binary_insertion_sort(char *array, unsigned long size_el, unsigned long first, unsigned long last, char *temp, int (*cmp)(const void *, const void *, void *), void *ctx){
+  unsigned long pos;
 
-  void *el_sx = NULL, *el_dx = NULL, *to_pos = NULL, *from_pos = NULL;
+  for(unsigned long i = first + 1; i < last; i++){
+    pos = upper_position(&array[size_el * i], array, size_el, first, i, cmp, ctx);
+    if(pos < i){
+      memcpy(temp, &array[size_el * i], size_el);
+      memmove(&array[size_el * (pos+1)], &array[size_el * pos], (i - pos) * size_el);
+      memcpy(&array[size_el * pos], temp, size_el);
+    }
+  }
+}
 
-  while(i <= mid && j <= right){
-    el_sx = &array[size_el * i];
-    el_dx = &array[size_el * j];
-    to_pos = &ordered_array[size_el * k];
-    
-    if((*precedes)(el_sx, el_dx)){
-      memmove(to_pos, el_dx, size_el);
+/**
+ * @brief Merge sorted ranges [first, middle) and [middle, last).
+ *        Left range is copied in buffer, then merged with right range directly into array.
+ *        Equal elements are taken from left range first, so merge is stable.
+ * 
+ * @param array     array pointer
+ * @param size_el   size of array element
+ * @param first     first index of left range
+ * @param middle    first index of right range
+ * @param last      index after the last element of right range
+ * @param buffer    memory area for at least (middle - first) elements
+ * @param cmp       three-way comparator
+ * @param ctx       user context passed to comparator
+ */
+static void merge(char *array, unsigned long size_el, unsigned long first, unsigned long middle, unsigned long last, char *buffer, int (*cmp)(const void *, const void *, void *), void *ctx){
+  
+  // ranges already in order, nothing to do
+  if((*cmp)(&array[size_el * (middle-1)], &array[size_el * middle], ctx) <= 0){
+    return;
+  }
+
+  unsigned long len_sx = middle - first;
+  unsigned long i = 0;        // index for left sub-array (in buffer)
+  unsigned long j = middle;   // index for right sub-array
+  unsigned long k = first;    // index for ordered array
+
+  memcpy(buffer, &array[size_el * first], len_sx * size_el);
+
+  while(i < len_sx && j < last){
+    if((*cmp)(&array[size_el * j], &buffer[size_el * i], ctx) < 0){
+      memcpy(&array[size_el * k], &array[size_el * j], size_el);
       j++;
     }else{
-      memmove(to_pos, el_sx, size_el);
-      i++;            
+      memcpy(&array[size_el * k], &buffer[size_el * i], size_el);
+      i++;
     }
     k++;
   }
 
-  if(i <= mid){
+  // remaining elements of right sub-array are already in place
+  memcpy(&array[size_el * k], &buffer[size_el * i], (len_sx - i) * size_el);
+}
 
-    while(i <= mid){
-      to_pos = &ordered_array[size_el * k];
-      from_pos = &array[size_el * i];
-      memmove(to_pos, from_pos, size_el);
+/**
+ * @brief Search forward in sorted range [first, last) the first element that does not go before key,
+ *        with exponential steps (1, 2, 4, ...) from first and binary search in the last step.
+ *        Cost is logarithmic in the distance from first.
+ * 
+ * @param key       pointer to a key element
+ * @param array     array pointer
+ * @param size_el   size of array element
+ * @param first     first index of range
+ * @param last      index after the last element of range
+ * @param cmp       three-way comparator
+ * @param ctx       user context passed to comparator
+ * @return          index of found position, last if all elements go before key
+ */
+static unsigned long gallop_lower_position(const void *key, char *array, unsigned long size_el, unsigned long first, unsigned long last, int (*cmp)(const void *, const void *, void *), void *ctx){
+  unsigned long bound = first, step = 1;
+
+  // elements in [first, bound) go before key
+  while(bound < last && (*cmp)(&array[size_el * bound], key, ctx) < 0){
+    first = bound + 1;
+    bound = first + step;
+    step *= 2;
+  }
+  if(bound > last){
+    bound = last;
+  }
+  return lower_position(key, array, size_el, first, bound, cmp, ctx);
+}
+
+/**
+ * @brief Search forward in sorted range [first, last) the first element that goes after key,
+ *        with exponential steps (1, 2, 4, ...) from first and binary search in the last step.
+ * 
+ * @param key       pointer to a key element
+ * @param array     array pointer
+ * @param size_el   size of array element
+ * @param first     first index of range
+ * @param last      index after the last element of range
+ * @param cmp       three-way comparator
+ * @param ctx       user context passed to comparator
+ * @return          index of found position, last if no element goes after key
+ */
+static unsigned long gallop_upper_position(const void *key, char *array, unsigned long size_el, unsigned long first, unsigned long last, int (*cmp)(const void *, const void *, void *), void *ctx){
+  unsigned long bound = first, step = 1;
+
+  // elements in [first, bound) don't go after key
+  while(bound < last && (*cmp)(&array[size_el * bound], key, ctx) <= 0){
+    first = bound + 1;
+    bound = first + step;
+    step *= 2;
+  }
+  if(bound > last){
+    bound = last;
+  }
+  return upper_position(key, array, size_el, first, bound, cmp, ctx);
+}
+
+/**
+ * @brief Merge sorted ranges [first, middle) and [middle, last) moving runs of elements in blocks.
+ *        Merge starts element by element as merge(); when one range wins MIN_GALLOP times in a row
+ *        (long runs, typically of equal keys) it switches to galloping: the length of the run
+ *        is found by exponential search and the whole run is copied with a single memcpy.
+ *        Equal elements are taken from left range first, so merge is stable.
+ * 
+ * @param array     array pointer
+ * @param size_el   size of array element
+ * @param first     first index of left range
+ * @param middle    first index of right range
+ * @param last      index after the last element of right range
+ * @param buffer    memory area for at least (middle - first) elements
+ * @param cmp       three-way comparator
+ * @param ctx       user context passed to comparator
+ */
+static void merge_gallop(char *array, unsigned long size_el, unsigned long first, unsigned long middle, unsigned long last, char *buffer, int (*cmp)(const void *, const void *, void *), void *ctx){
+  
+  // ranges already in order, nothing to do
+  if((*cmp)(&array[size_el * (middle-1)], &array[size_el * middle], ctx) <= 0){
+    return;
+  }
+
+  unsigned long len_sx = middle - first;
+  unsigned long i = 0;        // index for left sub-array (in buffer)
+  unsigned long j = middle;   // index for right sub-array
+  unsigned long k = first;    // index for ordered array
+  unsigned long wins_sx = 0, wins_dx = 0, run_sx, run_dx;
+
+  memcpy(buffer, &array[size_el * first], len_sx * size_el);
+
+  while(i < len_sx && j < last){
+    if((*cmp)(&array[size_el * j], &buffer[size_el * i], ctx) < 0){
+      memcpy(&array[size_el * k], &array[size_el * j], size_el);
+      j++;
+      wins_dx++;
+      wins_sx = 0;
+    }else{
+      memcpy(&array[size_el * k], &buffer[size_el * i], size_el);
       i++;
-      k++;
+      wins_sx++;
+      wins_dx = 0;
     }
-  }else{
+    k++;
 
-    while(j <= right){
-      to_pos = &ordered_array[size_el * k];
-      from_pos = &array[size_el * j];
-      memmove(to_pos, from_pos, size_el);
-      j++;
-      k++;
+    if(wins_sx >= MIN_GALLOP || wins_dx >= MIN_GALLOP){
+      do{
+        // left elements that don't go after head of right range
+        run_sx = 0;
+        if(j < last){
+          run_sx = gallop_upper_position(&array[size_el * j], buffer, size_el, i, len_sx, cmp, ctx) - i;
+          memcpy(&array[size_el * k], &buffer[size_el * i], run_sx * size_el);
+          i += run_sx;
+          k += run_sx;
+        }
+        if(i == len_sx || j == last){
+          break;
+        }
+
+        // right elements that go before head of left range
+        run_dx = gallop_lower_position(&buffer[size_el * i], array, size_el, j, last, cmp, ctx) - j;
+        memmove(&array[size_el * k], &array[size_el * j], run_dx * size_el);
+        j += run_dx;
+        k += run_dx;
+      }while(j < last && (run_sx >= MIN_GALLOP || run_dx >= MIN_GALLOP));
+      wins_sx = wins_dx = 0;
     }
   }
 
-  i = 0;
-  j = left;
+  // remaining elements of right sub-array are already in place
+  memcpy(&array[size_el * k], &buffer[size_el * i], (len_sx - i) * size_el);
+}
 
-  while(j <= right){
-    to_pos = &array[size_el * j];
-    from_pos = &ordered_array[size_el * i];
-    memmove(to_pos, from_pos, size_el);
-    ++i;
-    ++j;
+/**
+ * @brief Stable sort of range [first, last) using buffer for merging
+ * 
+ * @param array     array pointer
+ * @param size_el   size of array element
+ * @param first     first index of range
+ * @param last      index after the last element of range
+ * @param buffer    memory area for at least half of range elements (at least one)
+ * @param gallop    if not 0 runs are merged with merge_gallop, otherwise with merge
+ * @param cmp       three-way comparator
+ * @param ctx       user context passed to comparator
+ */
+static void sort_buffered(char *array, unsigned long size_el, unsigned long first, unsigned long last, char *buffer, int gallop, int (*cmp)(const void *, const void *, void *), void *ctx){
+  if(last - first <= K){
+    binary_insertion_sort(array, size_el, first, last, buffer, cmp, ctx);
+    return;
+  }
+
+  unsigned long middle = first + (last - first)/2;
+
+  sort_buffered(array, size_el, first, middle, buffer, gallop, cmp, ctx);
+  sort_buffered(array, size_el, middle, last, buffer, gallop, cmp, ctx);
+  if(gallop){
+    merge_gallop(array, size_el, first, middle, last, buffer, cmp, ctx);
+  }else{
+    merge(array, size_el, first, middle, last, buffer, cmp, ctx);
+  }
+}
+
+/**
+ * @brief Sort passed array using three-way comparator and user context.
+ * 
+ * @param array     array pointer to sort
+ * @param size_el   size of array element
+ * @param left      start index of array
+ * @param right     last index of array
+ * @param cmp       three-way comparator
+ * @param ctx       user context passed to comparator
+ */
+void sort_r(void *array, unsigned long size_el, unsigned long left, unsigned long right, int (*cmp)(const void *, const void *, void *), void *ctx){
+  
+  if(array == NULL){
+    ERROR_EXIT("array reference can't be NULL");
+  }
+  if(cmp == NULL){
+    ERROR_EXIT("function pointer for comparison can't be NULL");
+  }
+  if(right < left){
+    ERROR_EXIT("right must be greater or equal to left");
+  }
+  if(left < right){
+    char *buffer = (char *)malloc(((right - left + 2)/2) * size_el);
+    if(buffer == NULL){
+      ERROR_EXIT("unable to allocate memory for merge buffer");
+    }
+
+    sort_buffered((char *)array, size_el, left, right + 1, buffer, 0, cmp, ctx);
+    free(buffer);
   }
-  free(ordered_array);
 }
 
 /**
@@ -118,113 +416,399 @@ static void merge(void *array_p, unsigned long size_el, unsigned long left, unsi
  */
 void sort(void *array, unsigned long size_el, unsigned long left, unsigned long right, int(*precedes)(void *, void *)){
   
+  if(precedes == NULL){
+    ERROR_EXIT("function pointer for precedence relation can't be NULL");
+  }
+
+  PrecedesContext precedes_ctx = { precedes };
+  sort_r(array, size_el, left, right, precedes_cmp, &precedes_ctx);
+}
+
+/**
+ * @brief Stable counting sort of range [first, last) for arrays with few distinct keys.
+ *        Every element is searched by binary search in a sorted table of distinct keys
+ *        (one representative element per key) and its key slot is recorded; then elements
+ *        are distributed in buffer by prefix sums of key counts and copied back.
+ *        Gives up as soon as more than MAX_DISTINCT_KEYS distinct keys are found.
+ * 
+ * @param array     array pointer
+ * @param size_el   size of array element
+ * @param first     first index of range
+ * @param last      index after the last element of range
+ * @param buffer    memory area for (last - first) elements
+ * @param cmp       three-way comparator
+ * @param ctx       user context passed to comparator
+ * @return int      1 if range has been sorted, 0 if there are too many distinct keys
+ */
+static int counting_sort(char *array, unsigned long size_el, unsigned long first, unsigned long last, char *buffer, int (*cmp)(const void *, const void *, void *), void *ctx){
+  unsigned long representative[MAX_DISTINCT_KEYS];  // index of first element with key, by slot
+  unsigned long count[MAX_DISTINCT_KEYS];           // number of elements with key, by slot
+  unsigned char order[MAX_DISTINCT_KEYS];           // slots in key order
+  unsigned long distinct = 0, lo, hi, mid, offset, c;
+  unsigned char *slot = NULL;
+  int res = 0;
+
+  slot = (unsigned char *)malloc(last - first);
+  if(slot == NULL){
+    ERROR_EXIT("unable to allocate memory for key slots");
+  }
+
+  for(unsigned long i = first; i < last; i++){
+    // binary search of element key in table of distinct keys
+    lo = 0;
+    hi = distinct;
+    res = 1;
+    while(lo < hi){
+      mid = lo + (hi - lo)/2;
+      res = (*cmp)(&array[size_el * representative[order[mid]]], &array[size_el * i], ctx);
+      if(res == 0){
+        lo = mid;
+        break;
+      }else if(res < 0){
+        lo = mid + 1;
+      }else{
+        hi = mid;
+      }
+    }
+
+    if(res == 0){
+      count[order[lo]]++;
+      slot[i - first] = order[lo];
+    }else{
+      if(distinct == MAX_DISTINCT_KEYS){
+        free(slot);
+        return 0;
+      }
+      memmove(&order[lo+1], &order[lo], distinct - lo);
+      order[lo] = (unsigned char)distinct;
+      representative[distinct] = i;
+      count[distinct] = 1;
+      slot[i - first] = (unsigned char)distinct;
+      distinct++;
+    }
+  }
+
+  // count becomes position of next element with key
+  offset = 0;
+  for(unsigned long s = 0; s < distinct; s++){
+    c = count[order[s]];
+    count[order[s]] = offset;
+    offset += c;
+  }
+
+  for(unsigned long i = first; i < last; i++){
+    memcpy(&buffer[size_el * count[slot[i - first]]], &array[size_el * i], size_el);
+    count[slot[i - first]]++;
+  }
+  memcpy(&array[size_el * first], buffer, (last - first) * size_el);
+
+  free(slot);
+  return 1;
+}
+
+/**
+ * @brief Stable sort of passed array optimized for many duplicate keys, using three-way comparator and user context.
+ * 
+ * @param array     array pointer to sort
+ * @param size_el   size of array element
+ * @param left      start index of array
+ * @param right     last index of array
+ * @param cmp       three-way comparator
+ * @param ctx       user context passed to comparator
+ */
+void sort_dup_r(void *array, unsigned long size_el, unsigned long left, unsigned long right, int (*cmp)(const void *, const void *, void *), void *ctx){
+  
   if(array == NULL){
     ERROR_EXIT("array reference can't be NULL");
   }
-  if(precedes == NULL){
-    ERROR_EXIT("function pointer for precedence relation can't be NULL");
+  if(cmp == NULL){
+    ERROR_EXIT("function pointer for comparison can't be NULL");
   }
   if(right < left){
     ERROR_EXIT("right must be greater or equal to left");
   }
   if(left < right){
-    unsigned long mid = (left + right)/2;
+    char *buffer = (char *)malloc((right - left + 1) * size_el);
+    if(buffer == NULL){
+      ERROR_EXIT("unable to allocate memory for merge buffer");
+    }
 
-    if((right - left + 1) <= K){
-      binary_insertion_sort(array, size_el, left, right, precedes);
-    }else{
-      sort(array, size_el, left, mid, precedes);    
-      sort(array, size_el, mid + 1, right, precedes); 
+    if(!counting_sort((char *)array, size_el, left, right + 1, buffer, cmp, ctx)){
+      sort_buffered((char *)array, size_el, left, right + 1, buffer, 1, cmp, ctx);
     }
-  
-    merge(array, size_el, left, mid, right, precedes);    
+    free(buffer);
   }
 }
 
 /**
- * @brief sort an array of elements using precedes function pointer for sort in ascending or discending mode
+ * @brief Stable sort of passed array optimized for many duplicate keys, using precedes function pointer.
  * 
- * @param array       pointer to array 
- * @param size_el     size of one array element
- * @param left        start index of array
- * @param right       last index of array
- * @param precedes    pointer function for precedence relation between elements. 
- *                    This function must return 2 if elements are equal, 1 if first element precede second, 0 otherwise.
+ * @param array     array pointer to sort
+ * @param size_el   size of array element
+ * @param left      start index of array
+ * @param right     last index of array
+ * @param precedes  pointer function for precedence relation between elements. 
+ *                  This function must return 2 if elements are equal, 1 if first element precede second, 0 otherwise.
  */
-static void binary_insertion_sort(void *array_p, unsigned long size_el, unsigned long left, unsigned long right, int (precedes)(void *, void*)){
-  unsigned long pos, j;
+void sort_dup(void *array, unsigned long size_el, unsigned long left, unsigned long right, int(*precedes)(void *, void *)){
   
+  if(precedes == NULL){
+    ERROR_EXIT("function pointer for precedence relation can't be NULL");
+  }
+
+  PrecedesContext precedes_ctx = { precedes };
+  sort_dup_r(array, size_el, left, right, precedes_cmp, &precedes_ctx);
+}
+
+/**
+ * @brief Search backwards in sorted range [first, last) the first element that goes after key,
+ *        starting from the end of range with exponential steps (1, 2, 4, ...) and then
+ *        with binary search in the last step. Cost is logarithmic in the distance from the end.
+ * 
+ * @param key       pointer to a key element
+ * @param array     array pointer
+ * @param size_el   size of array element
+ * @param first     first index of range
+ * @param last      index after the last element of range
+ * @param cmp       three-way comparator
+ * @param ctx       user context passed to comparator
+ * @return          index of found position, last if no element goes after key
+ */
+static unsigned long gallop_back_upper_position(const void *key, char *array, unsigned long size_el, unsigned long first, unsigned long last, int (*cmp)(const void *, const void *, void *), void *ctx){
+  unsigned long bound, step = 1;
+
+  if(first == last || (*cmp)(&array[size_el * (last-1)], key, ctx) <= 0){
+    return last;
+  }
+
+  // element in bound position goes after key, search position in [first, bound]
+  bound = last - 1;
+  while(bound - first >= step && (*cmp)(&array[size_el * (bound-step)], key, ctx) > 0){
+    bound -= step;
+    step *= 2;
+  }
+
+  if(bound - first >= step){
+    first = bound - step + 1;
+  }
+  return upper_position(key, array, size_el, first, bound, cmp, ctx);
+}
+
+/**
+ * @brief Sort elements appended to an already sorted array and merge them in.
+ *        Appended batch is sorted with sort_r, then merged from the end of array:
+ *        for every batch element the insertion point is found by galloping search,
+ *        so the cost is O(m log n) comparisons and at most n moves for a batch of m elements.
+ *        Needs an auxiliary buffer of batch elements.
+ * 
+ * @param array       array pointer, elements in [0, sorted_num) must be sorted
+ * @param size_el     size of array element
+ * @param sorted_num  number of sorted elements at the beginning of array
+ * @param el_num      total number of elements, elements in [sorted_num, el_num) are the new batch
+ * @param cmp         three-way comparator
+ * @param ctx         user context passed to comparator
+ */
+void sort_append_r(void *array_p, unsigned long size_el, unsigned long sorted_num, unsigned long el_num, int (*cmp)(const void *, const void *, void *), void *ctx){
+
+  if(array_p == NULL){
+    ERROR_EXIT("array reference can't be NULL");
+  }
+  if(cmp == NULL){
+    ERROR_EXIT("function pointer for comparison can't be NULL");
+  }
+  if(el_num < sorted_num){
+    ERROR_EXIT("number of elements must be greater or equal to number of sorted elements");
+  }
+  if(el_num == sorted_num){
+    return;
+  }
+
   char *array = (char *)array_p;
+  unsigned long batch_num = el_num - sorted_num;
 
-  void *key, *temp, *next_pos, *pre_pos;
-  
-  temp = (void *)malloc(size_el);
+  sort_r(array, size_el, sorted_num, el_num - 1, cmp, ctx);
 
-  for(unsigned long i = left+1; i <= right; i++){
-    j = i - 1;
+  // batch goes after all sorted elements, nothing to merge
+  if(sorted_num == 0 || (*cmp)(&array[size_el * (sorted_num-1)], &array[size_el * sorted_num], ctx) <= 0){
+    return;
+  }
+
+  char *buffer = (char *)malloc(batch_num * size_el);
+  if(buffer == NULL){
+    ERROR_EXIT("unable to allocate memory for merge buffer");
+  }
+  memcpy(buffer, &array[size_el * sorted_num], batch_num * size_el);
+
+  unsigned long i = sorted_num;  // end of sorted elements still to merge
+  unsigned long j = batch_num;   // end of batch elements still to merge (in buffer)
+  unsigned long k = el_num;      // end of free positions in array
+  unsigned long pos;
 
-    key = &array[size_el * i];
-    pos = binary_search(key, array, size_el, left, j, precedes);
-    
-    memmove(temp, key, size_el);
-    
-    // move all elements by one to create space for key element
-    while(j > pos){
-      next_pos = &array[size_el * (j+1)];
-      pre_pos = &array[size_el * j];
-    
-      memmove(next_pos, pre_pos, size_el);
-      j--;
+  while(i > 0 && j > 0){
+    // sorted elements that go after last batch element are moved in a single block
+    pos = gallop_back_upper_position(&buffer[size_el * (j-1)], array, size_el, 0, i, cmp, ctx);
+    if(pos < i){
+      k -= i - pos;
+      memmove(&array[size_el * k], &array[size_el * pos], (i - pos) * size_el);
+      i = pos;
     }
+    k--;
+    j--;
+    memcpy(&array[size_el * k], &buffer[size_el * j], size_el);
+  }
+
+  // remaining batch elements go before all sorted elements
+  memcpy(array, buffer, j * size_el);
+  free(buffer);
+}
 
-    pre_pos = &array[size_el * pos];
-    next_pos = &array[size_el * (j+1)];
+/**
+ * @brief Sort elements appended to an already sorted array and merge them in, using precedes function pointer.
+ * 
+ * @param array       array pointer, elements in [0, sorted_num) must be sorted
+ * @param size_el     size of array element
+ * @param sorted_num  number of sorted elements at the beginning of array
+ * @param el_num      total number of elements, elements in [sorted_num, el_num) are the new batch
+ * @param precedes    pointer function for precedence relation between elements. 
+ *                    This function must return 2 if elements are equal, 1 if first element precede second, 0 otherwise.
+ */
+void sort_append(void *array, unsigned long size_el, unsigned long sorted_num, unsigned long el_num, int(*precedes)(void *, void *)){
 
-    memmove(next_pos, pre_pos, size_el);
-    memmove(pre_pos, temp, size_el); 
-    
+  if(precedes == NULL){
+    ERROR_EXIT("function pointer for precedence relation can't be NULL");
   }
-  free(temp);
+
+  PrecedesContext precedes_ctx = { precedes };
+  sort_append_r(array, size_el, sorted_num, el_num, precedes_cmp, &precedes_ctx);
 }
 
 /**
- * @brief search using precedes pointer function, the position where element pointed by key can be insert.
+ * @brief Merge sorted ranges [first, middle) and [middle, last) without auxiliary buffer.
+ *        The longest range is cut in half, the cut of the other range is found by binary search,
+ *        the two inner blocks are swapped by rotation and the two halves are merged recursively.
  * 
- * @param key       pointer to a key element
- * @param array     pointer to array where search
- * @param size_el   size of single element of array
- * @param left      array start index
- * @param right     array last index
- * @param precedes  pointer function for precedence relation between elements. 
- *                  This function must return 2 if elements are equal, 1 if first element precede second, 0 otherwise.
- * @return          The index where insert element.
+ * @param array     array pointer
+ * @param size_el   size of array element
+ * @param first     first index of left range
+ * @param middle    first index of right range
+ * @param last      index after the last element of right range
+ * @param cmp       three-way comparator
+ * @param ctx       user context passed to comparator
  */
-static unsigned long binary_search(void *key, void *array_p, unsigned long size_el, unsigned long left, unsigned long right, int (precedes)(void *,void *)){
+static void merge_inplace(char *array, unsigned long size_el, unsigned long first, unsigned long middle, unsigned long last, int (*cmp)(const void *, const void *, void *), void *ctx){
+  unsigned long len_sx, len_dx, cut_sx, cut_dx, new_middle;
 
-  char *array = (char *)array_p;
+  while(first < middle && middle < last){
+    // ranges already in order, nothing to do
+    if((*cmp)(&array[size_el * (middle-1)], &array[size_el * middle], ctx) <= 0){
+      return;
+    }
 
-  void *act_search = NULL;
+    len_sx = middle - first;
+    len_dx = last - middle;
 
-  if(right <= left){
-    act_search = &array[size_el * left];
-    if((precedes)(key, act_search)){
-        return left + 1;
+    if(len_sx + len_dx == 2){
+      swap_elements(&array[size_el * first], &array[size_el * middle], size_el);
+      return;
+    }
+
+    if(len_sx >= len_dx){
+      cut_sx = first + len_sx/2;
+      cut_dx = lower_position(&array[size_el * cut_sx], array, size_el, middle, last, cmp, ctx);
     }else{
-        return left;
+      cut_dx = middle + len_dx/2;
+      cut_sx = upper_position(&array[size_el * cut_dx], array, size_el, first, middle, cmp, ctx);
+    }
+
+    rotate(array, size_el, cut_sx, middle, cut_dx);
+    new_middle = cut_sx + (cut_dx - middle);
+
+    // recurse on the smaller half, iterate on the bigger one to bound stack depth
+    if((new_middle - first) < (last - new_middle)){
+      merge_inplace(array, size_el, first, cut_sx, new_middle, cmp, ctx);
+      first = new_middle;
+      middle = cut_dx;
+    }else{
+      merge_inplace(array, size_el, new_middle, cut_dx, last, cmp, ctx);
+      middle = cut_sx;
+      last = new_middle;
     }
   }
-  
-  unsigned long mid = (right + left)/2;
-  
-  act_search = &array[size_el * mid];
-
-  int cmp = (precedes)(key, act_search);
-    
-  if(cmp == 2){
-    return mid+1;
-  }else if(cmp){
-    return binary_search(key, array, size_el, mid+1, right, precedes);
-  }else{
-    return binary_search(key, array, size_el, left, mid, precedes);
+}
+
+/**
+ * @brief Stable sort of range [first, last) without auxiliary buffer
+ * 
+ * @param array     array pointer
+ * @param size_el   size of array element
+ * @param first     first index of range
+ * @param last      index after the last element of range
+ * @param cmp       three-way comparator
+ * @param ctx       user context passed to comparator
+ */
+static void sort_inplace(char *array, unsigned long size_el, unsigned long first, unsigned long last, int (*cmp)(const void *, const void *, void *), void *ctx){
+  unsigned long pos, j;
+
+  if(last - first <= K){
+    // insertion by adjacent swaps, no temporary element needed
+    for(unsigned long i = first + 1; i < last; i++){
+      pos = upper_position(&array[size_el * i], array, size_el, first, i, cmp, ctx);
+      for(j = i; j > pos; j--){
+        swap_elements(&array[size_el * (j-1)], &array[size_el * j], size_el);
+      }
+    }
+    return;
   }
-}
\ No newline at end of file
+
+  unsigned long middle = first + (last - first)/2;
+
+  sort_inplace(array, size_el, first, middle, cmp, ctx);
+  sort_inplace(array, size_el, middle, last, cmp, ctx);
+  merge_inplace(array, size_el, first, middle, last, cmp, ctx);
+}
+
+/**
+ * @brief Stable sort of passed array using three-way comparator and user context, without auxiliary buffer.
+ * 
+ * @param array     array pointer to sort
+ * @param size_el   size of array element
+ * @param left      start index of array
+ * @param right     last index of array
+ * @param cmp       three-way comparator
+ * @param ctx       user context passed to comparator
+ */
+void sort_inplace_stable_r(void *array, unsigned long size_el, unsigned long left, unsigned long right, int (*cmp)(const void *, const void *, void *), void *ctx){
+
+  if(array == NULL){
+    ERROR_EXIT("array reference can't be NULL");
+  }
+  if(cmp == NULL){
+    ERROR_EXIT("function pointer for comparison can't be NULL");
+  }
+  if(right < left){
+    ERROR_EXIT("right must be greater or equal to left");
+  }
+  if(left < right){
+    sort_inplace((char *)array, size_el, left, right + 1, cmp, ctx);
+  }
+}
+
+/**
+ * @brief Stable sort of passed array using precedes function pointer, without auxiliary buffer.
+ * 
+ * @param array     array pointer to sort
+ * @param size_el   size of array element
+ * @param left      start index of array
+ * @param right     last index of array
+ * @param precedes  pointer function for precedence relation between elements. 
+ *                  This function must return 2 if elements are equal, 1 if first element precede second, 0 otherwise.
+ */
+void sort_inplace_stable(void *array, unsigned long size_el, unsigned long left, unsigned long right, int(*precedes)(void *, void *)){
+
+  if(precedes == NULL){
+    ERROR_EXIT("function pointer for precedence relation can't be NULL");
+  }
+
+  PrecedesContext precedes_ctx = { precedes };
+  sort_inplace_stable_r(array, size_el, left, right, precedes_cmp, &precedes_ctx);
+}
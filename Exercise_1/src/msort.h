@@ -3,7 +3,8 @@
 
 // Sort an array of elements
 /**
- * @brief Sort passed array using precedes function pointer.
+ * @brief Stable sort of passed array using precedes function pointer.
+ *        Needs an auxiliary buffer of half the array elements.
  * 
  * @param array     array pointer to sort
  * @param size_el   size of array element
@@ -14,4 +15,113 @@
  */
 void sort(void *array, unsigned long size_el ,unsigned long left, unsigned long right,  int(*precedes)(void *, void *));
 
+/**
+ * @brief Stable sort of passed array using precedes function pointer, without auxiliary buffer.
+ *        Runs are merged by rotation (binary cut + block rotation), so no heap memory is used
+ *        and extra space is O(log n) stack frames. Equal elements keep their original order.
+ *
+ *        Compared with sort(), which needs an auxiliary buffer of n/2 elements,
+ *        this version performs O(n log n) comparisons but O(n log^2 n) element moves:
+ *        on 10^6 random 24-byte elements it is about 5 times slower (see msort_bench).
+ *        Use it when the array size is close to the available memory.
+ * 
+ * @param array     array pointer to sort
+ * @param size_el   size of array element
+ * @param left      start index of array
+ * @param right     last index of array
+ * @param precedes  pointer function for precedence relation between elements. 
+ *                  This function must return 2 if elements are equal, 1 if first element precede second, 0 otherwise.
+ */
+void sort_inplace_stable(void *array, unsigned long size_el, unsigned long left, unsigned long right, int(*precedes)(void *, void *));
+
+/**
+ * @brief Sort a batch of elements appended to an already sorted array and merge it in.
+ *        The batch is sorted, then merged with a single galloping merge from the end of array:
+ *        O(m log n) comparisons and at most n moves for a batch of m elements,
+ *        with an auxiliary buffer of m elements. Elements already sorted go before equal batch elements.
+ * 
+ * @param array       array pointer, elements in [0, sorted_num) must be sorted
+ * @param size_el     size of array element
+ * @param sorted_num  number of sorted elements at the beginning of array
+ * @param el_num      total number of elements, elements in [sorted_num, el_num) are the new batch
+ * @param precedes    pointer function for precedence relation between elements. 
+ *                    This function must return 2 if elements are equal, 1 if first element precede second, 0 otherwise.
+ */
+void sort_append(void *array, unsigned long size_el, unsigned long sorted_num, unsigned long el_num, int(*precedes)(void *, void *));
+
+/**
+ * @brief Stable sort of passed array optimized for arrays with many duplicate keys.
+ *        If the array has at most 64 distinct keys it is sorted by a counting sort:
+ *        O(n log d) comparisons for d distinct keys, and 2 moves per element.
+ *        Otherwise it is sorted as sort(), but merges switch to galloping when a run
+ *        is taken from the same side many times in a row, so runs of equal keys
+ *        are found with few comparisons and moved in blocks.
+ *        Needs an auxiliary buffer of n elements and n bytes.
+ *        On 10^6 elements with 16 skewed keys it is 3.5 times faster than sort_r(),
+ *        with uniform random keys it is about 15% slower (see msort_bench).
+ * 
+ * @param array     array pointer to sort
+ * @param size_el   size of array element
+ * @param left      start index of array
+ * @param right     last index of array
+ * @param precedes  pointer function for precedence relation between elements. 
+ *                  This function must return 2 if elements are equal, 1 if first element precede second, 0 otherwise.
+ */
+void sort_dup(void *array, unsigned long size_el, unsigned long left, unsigned long right, int(*precedes)(void *, void *));
+
+// Same functions using a three-way comparator with user context (qsort_r style)
+/**
+ * @brief Stable sort of passed array using three-way comparator and user context.
+ *        Needs an auxiliary buffer of half the array elements.
+ * 
+ * @param array     array pointer to sort
+ * @param size_el   size of array element
+ * @param left      start index of array
+ * @param right     last index of array
+ * @param cmp       three-way comparator. It receives two elements and ctx, it must return
+ *                  a negative value if first element goes before second, 0 if they are equal,
+ *                  a positive value if first element goes after second (like strcmp).
+ * @param ctx       user context passed unchanged to cmp, can be NULL
+ */
+void sort_r(void *array, unsigned long size_el, unsigned long left, unsigned long right, int (*cmp)(const void *, const void *, void *), void *ctx);
+
+/**
+ * @brief Stable sort of passed array using three-way comparator and user context, without auxiliary buffer.
+ *        See sort_inplace_stable() for memory and time trade-off.
+ * 
+ * @param array     array pointer to sort
+ * @param size_el   size of array element
+ * @param left      start index of array
+ * @param right     last index of array
+ * @param cmp       three-way comparator (see sort_r)
+ * @param ctx       user context passed unchanged to cmp, can be NULL
+ */
+void sort_inplace_stable_r(void *array, unsigned long size_el, unsigned long left, unsigned long right, int (*cmp)(const void *, const void *, void *), void *ctx);
+
+/**
+ * @brief Stable sort of passed array optimized for arrays with many duplicate keys,
+ *        using three-way comparator and user context. See sort_dup().
+ * 
+ * @param array     array pointer to sort
+ * @param size_el   size of array element
+ * @param left      start index of array
+ * @param right     last index of array
+ * @param cmp       three-way comparator (see sort_r)
+ * @param ctx       user context passed unchanged to cmp, can be NULL
+ */
+void sort_dup_r(void *array, unsigned long size_el, unsigned long left, unsigned long right, int (*cmp)(const void *, const void *, void *), void *ctx);
+
+/**
+ * @brief Sort a batch of elements appended to an already sorted array and merge it in,
+ *        using three-way comparator and user context. See sort_append().
+ * 
+ * @param array       array pointer, elements in [0, sorted_num) must be sorted
+ * @param size_el     size of array element
+ * @param sorted_num  number of sorted elements at the beginning of array
+ * @param el_num      total number of elements, elements in [sorted_num, el_num) are the new batch
+ * @param cmp         three-way comparator (see sort_r)
+ * @param ctx         user context passed unchanged to cmp, can be NULL
+ */
+void sort_append_r(void *array, unsigned long size_el, unsigned long sorted_num, unsigned long el_num, int (*cmp)(const void *, const void *, void *), void *ctx);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,186 @@
+/**
+ * @file msort_bench.c
+ * @author Daniele Di Palma
+ * @brief Benchmark of sorting functions on random data
+ * @date 2021-11-09
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "msort.h"
+
+#define ERROR_EXIT(x) { fprintf(stderr, "[%s]-Line:%d >> "x"\n",    \
+                          __FILE__,                                 \
+                          __LINE__ );                               \
+                        exit(EXIT_FAILURE);}                        \
+
+#define DEFAULT_EL_NUM (1000000UL)
+#define KEY_RANGE (1000000)
+#define STATUS_CODES (16)
+#define ZIPF_KEYS (10000)
+
+// Element of benchmark, size similar to a record of ordered_records_main
+typedef struct _BenchRecord{
+  int key;
+  int id;
+  char *string_field;
+  double float_field;
+} BenchRecord;
+
+static int precedes_bench_record(void *r1_p, void *r2_p){
+  BenchRecord *rec1_p = (BenchRecord *)r1_p;
+  BenchRecord *rec2_p = (BenchRecord *)r2_p;
+  if(rec1_p->key == rec2_p->key){
+    return (2);
+  }else if(rec1_p->key > rec2_p->key)
+    return (1);
+  return (0);
+}
+
+static int compare_bench_record(const void *r1_p, const void *r2_p, void *ctx){
+  (void)ctx;
+  const BenchRecord *rec1_p = (const BenchRecord *)r1_p;
+  const BenchRecord *rec2_p = (const BenchRecord *)r2_p;
+  return (rec1_p->key > rec2_p->key) - (rec1_p->key < rec2_p->key);
+}
+
+/**
+ * @brief Fill array with uniform random keys, id field keeps the original position
+ *
+ * @param array   array to fill
+ * @param el_num  number of elements
+ */
+static void fill_random(BenchRecord *array, unsigned long el_num){
+  srand(1);
+  for(unsigned long i = 0; i < el_num; i++){
+    array[i].key = rand() % KEY_RANGE;
+    array[i].id = (int)i;
+    array[i].string_field = NULL;
+    array[i].float_field = 0.0;
+  }
+}
+
+/**
+ * @brief Fill array with few distinct keys (like status codes), skewed towards the first ones
+ *
+ * @param array   array to fill
+ * @param el_num  number of elements
+ */
+static void fill_status_codes(BenchRecord *array, unsigned long el_num){
+  fill_random(array, el_num);
+  for(unsigned long i = 0; i < el_num; i++){
+    // code c has probability 1/2^(c+1)
+    int code = 0;
+    while(code < STATUS_CODES - 1 && (rand() & 1)){
+      code++;
+    }
+    array[i].key = 100 * code;
+  }
+}
+
+/**
+ * @brief Fill array with keys following a Zipf-like distribution over ZIPF_KEYS keys
+ *        (key k has probability proportional to 1/k)
+ *
+ * @param array   array to fill
+ * @param el_num  number of elements
+ */
+static void fill_zipf(BenchRecord *array, unsigned long el_num){
+  fill_random(array, el_num);
+  for(unsigned long i = 0; i < el_num; i++){
+    double u = (double)rand() / ((double)RAND_MAX + 1.0);
+    array[i].key = (int)exp(u * log((double)ZIPF_KEYS));
+  }
+}
+
+/**
+ * @brief Check array is sorted and return 1 if equal elements keep their original order
+ *
+ * @param array   array to check
+ * @param el_num  number of elements
+ * @return int    1 if sort was stable, 0 otherwise
+ */
+static int check_sorted(const BenchRecord *array, unsigned long el_num){
+  int stable = 1;
+  for(unsigned long i = 1; i < el_num; i++){
+    if(array[i-1].key > array[i].key){
+      ERROR_EXIT("array is not sorted");
+    }
+    if(array[i-1].key == array[i].key && array[i-1].id > array[i].id){
+      stable = 0;
+    }
+  }
+  return stable;
+}
+
+/**
+ * @brief Run a sorting function on random data and print elapsed time.
+ *        Exactly one between sort_fun and sort_r_fun must be given.
+ *
+ * @param name        name of benchmarked function
+ * @param fill        function filling array with data
+ * @param sort_fun    sorting function with precedes relation
+ * @param sort_r_fun  sorting function with three-way comparator
+ * @param el_num      number of elements
+ * @param aux_memory  auxiliary memory used by sorting function, in bytes
+ */
+static void run_bench(const char *name, void (*fill)(BenchRecord *, unsigned long), void (*sort_fun)(void *, unsigned long, unsigned long, unsigned long, int(*)(void *, void *)),
+                      void (*sort_r_fun)(void *, unsigned long, unsigned long, unsigned long, int (*)(const void *, const void *, void *), void *),
+                      unsigned long el_num, unsigned long aux_memory){
+  BenchRecord *array = (BenchRecord *)malloc(el_num * sizeof(BenchRecord));
+  if(array == NULL){
+    ERROR_EXIT("unable to allocate memory for benchmark array");
+  }
+  (*fill)(array, el_num);
+
+  clock_t start_time = clock();
+  if(sort_fun != NULL){
+    (*sort_fun)(array, sizeof(BenchRecord), 0, el_num - 1, precedes_bench_record);
+  }else{
+    (*sort_r_fun)(array, sizeof(BenchRecord), 0, el_num - 1, compare_bench_record, NULL);
+  }
+  double elapsed_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
+
+  int stable = check_sorted(array, el_num);
+  printf("%-22s %10lu el  %10.3f sec  aux memory %8.2f MB  %s\n", name, el_num, elapsed_time,
+          (double)aux_memory/(1024*1024), stable ? "stable" : "unstable");
+  free(array);
+}
+
+int main(int argc, char **argv){
+  unsigned long el_num = DEFAULT_EL_NUM;
+
+  if(argc > 1){
+    el_num = strtoul(argv[1], NULL, 10);
+  }
+  if(el_num < 2){
+    printf("Usage: msort_bench [number of elements >= 2]\n");
+    exit(EXIT_FAILURE);
+  }
+
+  printf("Element size: %lu bytes, array size: %.2f MB\n", (unsigned long)sizeof(BenchRecord),
+          (double)(el_num * sizeof(BenchRecord))/(1024*1024));
+
+  printf("\nUniform random keys\n");
+  run_bench("sort", fill_random, sort, NULL, el_num, el_num/2 * sizeof(BenchRecord));
+  run_bench("sort_inplace_stable", fill_random, sort_inplace_stable, NULL, el_num, 0);
+  run_bench("sort_r", fill_random, NULL, sort_r, el_num, el_num/2 * sizeof(BenchRecord));
+  run_bench("sort_inplace_stable_r", fill_random, NULL, sort_inplace_stable_r, el_num, 0);
+  run_bench("sort_dup_r", fill_random, NULL, sort_dup_r, el_num, el_num * (sizeof(BenchRecord) + 1));
+
+  printf("\n%d status codes, skewed\n", STATUS_CODES);
+  run_bench("sort_r", fill_status_codes, NULL, sort_r, el_num, el_num/2 * sizeof(BenchRecord));
+  run_bench("sort_dup_r", fill_status_codes, NULL, sort_dup_r, el_num, el_num * (sizeof(BenchRecord) + 1));
+
+  printf("\nZipf keys over %d values\n", ZIPF_KEYS);
+  run_bench("sort_r", fill_zipf, NULL, sort_r, el_num, el_num/2 * sizeof(BenchRecord));
+  run_bench("sort_dup_r", fill_zipf, NULL, sort_dup_r, el_num, el_num * (sizeof(BenchRecord) + 1));
+
+  exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,30 @@
+#ifndef _M_SORT_INTERNAL_H_
+#define _M_SORT_INTERNAL_H_
+
+// Internal helpers shared by msort.c and msearch.c, not part of the public interface
+
+/**
+ * @brief It rappresents the context that adapts a precedes function to the three-way
+ *        comparator used internally
+ */
+typedef struct _PrecedesContext{
+  int (*precedes)(void *, void *);
+} PrecedesContext;
+
+/**
+ * @brief Three-way comparator built on top of a precedes function
+ * 
+ * @param el_1    pointer to first element
+ * @param el_2    pointer to second element
+ * @param ctx     pointer to PrecedesContext with the precedes function
+ * @return int    0 if elements are equal, positive if first element goes after second, negative otherwise
+ */
+static inline int precedes_cmp(const void *el_1, const void *el_2, void *ctx){
+  int result = (*((PrecedesContext *)ctx)->precedes)((void *)el_1, (void *)el_2);
+  if(result == 2){
+    return 0;
+  }
+  return result ? 1 : -1;
+}
+
+#endif
@@ -51,6 +51,37 @@ static int precedes_string(void *el_1, void *el_2){
   return (0);
 }
 
+// element with a key used for sorting and a tag used for checking stability
+typedef struct _TaggedInt{
+  int key;
+  int tag;
+} TaggedInt;
+
+static int precedes_tagged_int(void *el_1, void *el_2){
+  TaggedInt *tel_1_p = (TaggedInt *)el_1;
+  TaggedInt *tel_2_p = (TaggedInt *)el_2;
+  if(tel_1_p->key == tel_2_p->key){
+    return (2);
+  }else if(tel_1_p->key > tel_2_p->key)
+    return (1);
+  return (0);
+}
+
+// three-way comparator, context points to sort direction (1 ascending, -1 descending)
+static int compare_int(const void *el_1, const void *el_2, void *ctx){
+  int iel_1_v = *(const int *)el_1;
+  int iel_2_v = *(const int *)el_2;
+  int direction = *(int *)ctx;
+  return direction * ((iel_1_v > iel_2_v) - (iel_1_v < iel_2_v));
+}
+
+static int compare_tagged_int(const void *el_1, const void *el_2, void *ctx){
+  (void)ctx;
+  const TaggedInt *tel_1_p = (const TaggedInt *)el_1;
+  const TaggedInt *tel_2_p = (const TaggedInt *)el_2;
+  return (tel_1_p->key > tel_2_p->key) - (tel_1_p->key < tel_2_p->key);
+}
+
 // Data elements that are initialized befor each test
 static int iel_1, iel_2, iel_3, iel_4, iel_5, iel_6;
 static char *sel_1, *sel_2, *sel_3;
@@ -275,6 +306,219 @@ static void test_sort_three_double_el(void){
   TEST_ASSERT_EQUAL_INT_ARRAY(exp_arr, array_d, 3);
 }
 
+static void test_sort_inplace_stable_six_int_el(void){
+  int exp_arr[] = {iel_4, iel_1, iel_2, iel_3, iel_5, iel_6};
+  int arr[] = {iel_6, iel_3, iel_2, iel_5, iel_1, iel_4};
+
+  sort_inplace_stable(arr, sizeof(int), 0, 5, precedes_int);
+  TEST_ASSERT_EQUAL_INT_ARRAY(exp_arr, arr, 6);
+}
+
+static void test_sort_inplace_stable_string_el(void){
+  char *exp_arr[] = {sel_1, sel_1, sel_3};
+
+  array_s[0] = sel_3;
+  array_s[1] = sel_1;
+  array_s[2] = sel_1;
+  sort_inplace_stable(array_s, sizeof(char *), 0, 2, precedes_string);
+  TEST_ASSERT_EQUAL_PTR_ARRAY(exp_arr, array_s, 3);
+}
+
+static void test_sort_inplace_stable_keeps_equal_order(void){
+  TaggedInt arr[100];
+  
+  for(int i = 0; i < 100; i++){
+    arr[i].key = (i * 7) % 5;
+    arr[i].tag = i;
+  }
+  sort_inplace_stable(arr, sizeof(TaggedInt), 0, 99, precedes_tagged_int);
+  for(int i = 1; i < 100; i++){
+    TEST_ASSERT_TRUE(arr[i-1].key <= arr[i].key);
+    if(arr[i-1].key == arr[i].key){
+      TEST_ASSERT_TRUE(arr[i-1].tag < arr[i].tag);
+    }
+  }
+}
+
+static void test_sort_inplace_stable_same_as_sort(void){
+  int arr[1000], exp_arr[1000];
+
+  srand(42);
+  for(int i = 0; i < 1000; i++){
+    arr[i] = exp_arr[i] = rand() % 500 - 250;
+  }
+  sort(exp_arr, sizeof(int), 0, 999, precedes_int);
+  sort_inplace_stable(arr, sizeof(int), 0, 999, precedes_int);
+  TEST_ASSERT_EQUAL_INT_ARRAY(exp_arr, arr, 1000);
+}
+
+static void test_sort_inplace_stable_null_array(void){
+  int *array = NULL;  
+  
+  sort_inplace_stable(array, 0, 0, 0, precedes_int);
+  TEST_ASSERT_EQUAL_PTR(NULL, array);
+}
+
+static void test_sort_r_ascending_int_el(void){
+  int exp_arr[] = {iel_4, iel_1, iel_2, iel_3, iel_5, iel_6};
+  int arr[] = {iel_6, iel_3, iel_2, iel_5, iel_1, iel_4};
+  int direction = 1;
+
+  sort_r(arr, sizeof(int), 0, 5, compare_int, &direction);
+  TEST_ASSERT_EQUAL_INT_ARRAY(exp_arr, arr, 6);
+}
+
+static void test_sort_r_descending_int_el(void){
+  int exp_arr[] = {iel_6, iel_5, iel_3, iel_2, iel_1, iel_4};
+  int arr[] = {iel_6, iel_3, iel_2, iel_5, iel_1, iel_4};
+  int direction = -1;
+
+  sort_r(arr, sizeof(int), 0, 5, compare_int, &direction);
+  TEST_ASSERT_EQUAL_INT_ARRAY(exp_arr, arr, 6);
+}
+
+static void test_sort_r_keeps_equal_order(void){
+  TaggedInt arr[100];
+  
+  for(int i = 0; i < 100; i++){
+    arr[i].key = (i * 7) % 5;
+    arr[i].tag = i;
+  }
+  sort_r(arr, sizeof(TaggedInt), 0, 99, compare_tagged_int, NULL);
+  for(int i = 1; i < 100; i++){
+    TEST_ASSERT_TRUE(arr[i-1].key <= arr[i].key);
+    if(arr[i-1].key == arr[i].key){
+      TEST_ASSERT_TRUE(arr[i-1].tag < arr[i].tag);
+    }
+  }
+}
+
+static void test_sort_inplace_stable_r_descending(void){
+  int arr[1000], exp_arr[1000];
+  int direction = -1;
+
+  srand(7);
+  for(int i = 0; i < 1000; i++){
+    arr[i] = exp_arr[i] = rand() % 100;
+  }
+  sort_r(exp_arr, sizeof(int), 0, 999, compare_int, &direction);
+  sort_inplace_stable_r(arr, sizeof(int), 0, 999, compare_int, &direction);
+  TEST_ASSERT_EQUAL_INT_ARRAY(exp_arr, arr, 1000);
+  for(int i = 1; i < 1000; i++){
+    TEST_ASSERT_TRUE(arr[i-1] >= arr[i]);
+  }
+}
+
+static void test_sort_append_batch(void){
+  int exp_arr[] = {iel_4, iel_1, iel_2, iel_3, iel_5, iel_6};
+  int arr[] = {iel_1, iel_3, iel_5, iel_6, iel_2, iel_4};
+
+  sort_append(arr, sizeof(int), 4, 6, precedes_int);
+  TEST_ASSERT_EQUAL_INT_ARRAY(exp_arr, arr, 6);
+}
+
+static void test_sort_append_empty_batch(void){
+  int exp_arr[] = {iel_4, iel_1, iel_2};
+  int arr[] = {iel_4, iel_1, iel_2};
+
+  sort_append(arr, sizeof(int), 3, 3, precedes_int);
+  TEST_ASSERT_EQUAL_INT_ARRAY(exp_arr, arr, 3);
+}
+
+static void test_sort_append_empty_sorted(void){
+  int exp_arr[] = {iel_1, iel_2, iel_3};
+  int arr[] = {iel_3, iel_1, iel_2};
+
+  sort_append(arr, sizeof(int), 0, 3, precedes_int);
+  TEST_ASSERT_EQUAL_INT_ARRAY(exp_arr, arr, 3);
+}
+
+static void test_sort_append_r_keeps_equal_order(void){
+  TaggedInt arr[300];
+  
+  for(int i = 0; i < 300; i++){
+    arr[i].key = (i * 13) % 17;
+    arr[i].tag = i;
+  }
+  sort_r(arr, sizeof(TaggedInt), 0, 199, compare_tagged_int, NULL);
+  sort_append_r(arr, sizeof(TaggedInt), 200, 300, compare_tagged_int, NULL);
+  for(int i = 1; i < 300; i++){
+    TEST_ASSERT_TRUE(arr[i-1].key <= arr[i].key);
+    if(arr[i-1].key == arr[i].key){
+      TEST_ASSERT_TRUE(arr[i-1].tag < arr[i].tag);
+    }
+  }
+}
+
+static void test_sort_append_r_same_as_sort(void){
+  int arr[1000], exp_arr[1000];
+  int direction = 1;
+
+  srand(3);
+  for(int i = 0; i < 1000; i++){
+    arr[i] = exp_arr[i] = rand() % 5000;
+  }
+  sort_r(exp_arr, sizeof(int), 0, 999, compare_int, &direction);
+  sort_r(arr, sizeof(int), 0, 899, compare_int, &direction);
+  sort_append_r(arr, sizeof(int), 900, 1000, compare_int, &direction);
+  TEST_ASSERT_EQUAL_INT_ARRAY(exp_arr, arr, 1000);
+}
+
+static void test_sort_dup_six_int_el(void){
+  int exp_arr[] = {iel_4, iel_1, iel_2, iel_3, iel_5, iel_6};
+  int arr[] = {iel_6, iel_3, iel_2, iel_5, iel_1, iel_4};
+
+  sort_dup(arr, sizeof(int), 0, 5, precedes_int);
+  TEST_ASSERT_EQUAL_INT_ARRAY(exp_arr, arr, 6);
+}
+
+static void test_sort_dup_r_few_keys_keeps_equal_order(void){
+  TaggedInt arr[1000];
+  
+  for(int i = 0; i < 1000; i++){
+    arr[i].key = (i * 7) % 13;
+    arr[i].tag = i;
+  }
+  sort_dup_r(arr, sizeof(TaggedInt), 0, 999, compare_tagged_int, NULL);
+  for(int i = 1; i < 1000; i++){
+    TEST_ASSERT_TRUE(arr[i-1].key <= arr[i].key);
+    if(arr[i-1].key == arr[i].key){
+      TEST_ASSERT_TRUE(arr[i-1].tag < arr[i].tag);
+    }
+  }
+}
+
+static void test_sort_dup_r_many_keys_keeps_equal_order(void){
+  TaggedInt arr[2000];
+  
+  srand(11);
+  for(int i = 0; i < 2000; i++){
+    // skewed keys: few very frequent keys and a long tail
+    arr[i].key = (rand() % 4 == 0) ? rand() % 1000 : rand() % 3;
+    arr[i].tag = i;
+  }
+  sort_dup_r(arr, sizeof(TaggedInt), 0, 1999, compare_tagged_int, NULL);
+  for(int i = 1; i < 2000; i++){
+    TEST_ASSERT_TRUE(arr[i-1].key <= arr[i].key);
+    if(arr[i-1].key == arr[i].key){
+      TEST_ASSERT_TRUE(arr[i-1].tag < arr[i].tag);
+    }
+  }
+}
+
+static void test_sort_dup_r_same_as_sort(void){
+  int arr[1000], exp_arr[1000];
+  int direction = -1;
+
+  srand(13);
+  for(int i = 0; i < 1000; i++){
+    arr[i] = exp_arr[i] = rand() % 100000;
+  }
+  sort_r(exp_arr, sizeof(int), 0, 999, compare_int, &direction);
+  sort_dup_r(arr, sizeof(int), 0, 999, compare_int, &direction);
+  TEST_ASSERT_EQUAL_INT_ARRAY(exp_arr, arr, 1000);
+}
+
 int main(void){
   
   // test session
@@ -302,6 +546,28 @@ int main(void){
   RUN_TEST(test_sort_ascending_double_array);
   RUN_TEST(test_sort_three_double_el);
 
+  RUN_TEST(test_sort_inplace_stable_six_int_el);
+  RUN_TEST(test_sort_inplace_stable_string_el);
+  RUN_TEST(test_sort_inplace_stable_keeps_equal_order);
+  RUN_TEST(test_sort_inplace_stable_same_as_sort);
+  RUN_TEST(test_sort_inplace_stable_null_array);
+
+  RUN_TEST(test_sort_r_ascending_int_el);
+  RUN_TEST(test_sort_r_descending_int_el);
+  RUN_TEST(test_sort_r_keeps_equal_order);
+  RUN_TEST(test_sort_inplace_stable_r_descending);
+
+  RUN_TEST(test_sort_append_batch);
+  RUN_TEST(test_sort_append_empty_batch);
+  RUN_TEST(test_sort_append_empty_sorted);
+  RUN_TEST(test_sort_append_r_keeps_equal_order);
+  RUN_TEST(test_sort_append_r_same_as_sort);
+
+  RUN_TEST(test_sort_dup_six_int_el);
+  RUN_TEST(test_sort_dup_r_few_keys_keeps_equal_order);
+  RUN_TEST(test_sort_dup_r_many_keys_keeps_equal_order);
+  RUN_TEST(test_sort_dup_r_same_as_sort);
+
   return UNITY_END();
 }
 
@@ -13,6 +13,7 @@
 #include <string.h>
 #include <time.h>
 #include "msort.h"
+#include "msearch.h"
 
 #define ERROR_EXIT(x) { fprintf(stderr, "[%s]-Line:%d >> "x"\n",    \
                           __FILE__,                                 \
@@ -41,43 +42,26 @@ typedef struct _RecordArray{
 
 } RecordArray;
 
-/**
- * @brief       It takes as input two record pointer and compare integer fields 
- *              of two records using ascending method
- * 
- * @param r1_p  first record pointer
- * @param r2_p  second record pointer
- * @return      int return 1 if the integer field of the first record is greater than
- *              second, 2 if are equals, 0 otherwise
- */
-static int precedes_record_int_ascending(void *r1_p, void *r2_p){
-  if(r1_p == NULL){
-    ERROR_EXIT("first parameter is a null pointer");
-  }
-  if(r2_p == NULL){
-    ERROR_EXIT("second parameter is a null pointer");
-  }
+// It rappresents a view of records sorted by a field, it grows when new batches of records are appended
+typedef struct _SortedRecords{
 
-  Record *rec1_p = *(Record **)r1_p;
-  Record *rec2_p = *(Record **)r2_p;
+  Record **array;
+  unsigned long el_num;
+  unsigned long array_capacity;
 
-  if (rec1_p->integer_field == rec2_p->integer_field){
-    return (2);
-  }else if (rec1_p->integer_field > rec2_p->integer_field)
-    return (1);
-  return (0);
-}
+} SortedRecords;
 
 /**
  * @brief       It takes as input two record pointer and compare integer fields 
- *              of two records using descending method
+ *              of two records using the sort direction given in context
  * 
  * @param r1_p  first record pointer
  * @param r2_p  second record pointer
- * @return      int return 1 if the integer field of the first record is less than
- *              second, 2 if are equals, 0 otherwise
+ * @param ctx   pointer to sort direction, 1 for ascending and -1 for descending order
+ * @return      int return a positive value if the first record goes after the second,
+ *              0 if integer fields are equals, a negative value otherwise
  */
-static int precedes_record_int_descending(void *r1_p, void *r2_p){
+static int compare_record_int(const void *r1_p, const void *r2_p, void *ctx){
   if(r1_p == NULL){
     ERROR_EXIT("first parameter is a null pointer");
   }
@@ -85,52 +69,24 @@ static int precedes_record_int_descending(void *r1_p, void *r2_p){
     ERROR_EXIT("second parameter is a null pointer");
   }
 
-  Record *rec1_p = *(Record **)r1_p;
-  Record *rec2_p = *(Record **)r2_p;
-  if (rec1_p->integer_field == rec2_p->integer_field){
-    return (2);
-  }else if (rec1_p->integer_field < rec2_p->integer_field)
-    return (1);
-  return (0);
-}
-
-/**
- * @brief       It takes as input two record pointer and compare string fields 
- *              of two records using ascending method
- * 
- * @param r1_p  first record pointer
- * @param r2_p  second record pointer
- * @return      int return 1 if the string field of the first record is greater than
- *              second, 2 if are equals, 0 otherwise
- */
-static int precedes_record_string_ascending(void *r1_p, void *r2_p){
-  if(r1_p == NULL){
-    ERROR_EXIT("first parameter is a null pointer");
-  }
-  if(r2_p == NULL){
-    ERROR_EXIT("second parameter is a null pointer");
-  }
+  const Record *rec1_p = *(Record * const *)r1_p;
+  const Record *rec2_p = *(Record * const *)r2_p;
+  int direction = *(int *)ctx;
 
-  Record *rec1_p = *(Record **)r1_p;
-  Record *rec2_p = *(Record **)r2_p;
-  int cmp = strcmp(rec1_p->string_field, rec2_p->string_field);
-  if (cmp == 0){
-    return (2);
-  }else if (cmp > 0)
-    return (1);
-  return (0);
+  return direction * ((rec1_p->integer_field > rec2_p->integer_field) - (rec1_p->integer_field < rec2_p->integer_field));
 }
 
 /**
  * @brief       It takes as input two record pointer and compare string fields 
- *              of two records using descending method
+ *              of two records using the sort direction given in context
  * 
  * @param r1_p  first record pointer
  * @param r2_p  second record pointer
- * @return      int return 1 if the string field of the first record is less than
- *              second, 2 if are equals, 0 otherwise
+ * @param ctx   pointer to sort direction, 1 for ascending and -1 for descending order
+ * @return      int return a positive value if the first record goes after the second,
+ *              0 if string fields are equals, a negative value otherwise
  */
-static int precedes_record_string_descending(void *r1_p, void *r2_p){
+static int compare_record_string(const void *r1_p, const void *r2_p, void *ctx){
   if(r1_p == NULL){
     ERROR_EXIT("first parameter is a null pointer");
   }
@@ -138,52 +94,25 @@ static int precedes_record_string_descending(void *r1_p, void *r2_p){
     ERROR_EXIT("second parameter is a null pointer");
   }
 
-  Record *rec1_p = *(Record **)r1_p;
-  Record *rec2_p = *(Record **)r2_p;
+  const Record *rec1_p = *(Record * const *)r1_p;
+  const Record *rec2_p = *(Record * const *)r2_p;
+  int direction = *(int *)ctx;
   int cmp = strcmp(rec1_p->string_field, rec2_p->string_field);
-  if (cmp == 0){
-    return (2);
-  }else if (cmp < 0)
-    return (1);
-  return (0);
-}
-
-/**
- * @brief       It takes as input two record pointer and compare double fields 
- *              of two records using ascending method
- * 
- * @param r1_p  first record pointer
- * @param r2_p  second record pointer
- * @return      int return 1 if the double field of the first record is greater than
- *              second, 2 if are equals, 0 otherwise
- */
-static int precedes_record_double_ascending(void *r1_p, void *r2_p){
-  if(r1_p == NULL){
-    ERROR_EXIT("first parameter is a null pointer");
-  }
-  if(r2_p == NULL){
-    ERROR_EXIT("second parameter is a null pointer");
-  }
 
-  Record *rec1_p = *(Record **)r1_p;
-  Record *rec2_p = *(Record **)r2_p;
-  if (rec1_p->float_field == rec2_p->float_field){
-    return (2);
-  }else if (rec1_p->float_field > rec2_p->float_field)
-    return (1);
-  return (0);
+  return direction * ((cmp > 0) - (cmp < 0));
 }
 
 /**
  * @brief       It takes as input two record pointer and compare double fields 
- *              of two records using descending method
+ *              of two records using the sort direction given in context
  * 
  * @param r1_p  first record pointer
  * @param r2_p  second record pointer
- * @return      int return 1 if the double field of the first record is less than
- *              second, 2 if are equals, 0 otherwise
+ * @param ctx   pointer to sort direction, 1 for ascending and -1 for descending order
+ * @return      int return a positive value if the first record goes after the second,
+ *              0 if double fields are equals, a negative value otherwise
  */
-static int precedes_record_double_descending(void *r1_p, void *r2_p){
+static int compare_record_double(const void *r1_p, const void *r2_p, void *ctx){
   if(r1_p == NULL){
     ERROR_EXIT("first parameter is a null pointer");
   }
@@ -191,13 +120,11 @@ static int precedes_record_double_descending(void *r1_p, void *r2_p){
     ERROR_EXIT("second parameter is a null pointer");
   }
 
-  Record *rec1_p = *(Record **)r1_p;
-  Record *rec2_p = *(Record **)r2_p;
-  if (rec1_p->float_field == rec2_p->float_field){
-    return (2);
-  }else if (rec1_p->float_field < rec2_p->float_field)
-    return (1);
-  return (0);
+  const Record *rec1_p = *(Record * const *)r1_p;
+  const Record *rec2_p = *(Record * const *)r2_p;
+  int direction = *(int *)ctx;
+
+  return direction * ((rec1_p->float_field > rec2_p->float_field) - (rec1_p->float_field < rec2_p->float_field));
 }
 
 /**
@@ -326,6 +253,155 @@ static Record **init_array_pointers(const RecordArray *record_array){
   return record_array_p;
 }
 
+/**
+ * @brief Add to sorted view pointers to all records of a new batch, then merge them in sorted order.
+ *        Capacity of view is at least doubled when it's full, so appending is amortized linear.
+ * 
+ * @param sorted_records  sorted view of records
+ * @param batch           records of new batch
+ * @param direction       sort direction, 1 for ascending and -1 for descending order
+ */
+static void append_batch(SortedRecords *sorted_records, const RecordArray *batch, int *direction){
+  unsigned long needed = sorted_records->el_num + batch->el_num;
+
+  if(needed > sorted_records->array_capacity){
+    unsigned long new_capacity = 2 * sorted_records->array_capacity;
+    if(new_capacity < needed){
+      new_capacity = needed;
+    }
+    sorted_records->array = (Record **)realloc(sorted_records->array, new_capacity * sizeof(Record *));
+    if(sorted_records->array == NULL){
+      ERROR_EXIT("unable to reallocate memory for host the new batch");
+    }
+    sorted_records->array_capacity = new_capacity;
+  }
+
+  for(unsigned long i = 0; i < batch->el_num; i++){
+    sorted_records->array[sorted_records->el_num + i] = &(batch->array)[i];
+  }
+
+  sort_append_r(sorted_records->array, sizeof(Record *), sorted_records->el_num, needed, compare_record_int, direction);
+  sorted_records->el_num = needed;
+}
+
+/**
+ * @brief It drive the program in query mode: records are sorted by integer field (ascending),
+ *        then records with integer field in [min_value, max_value] are searched by binary search.
+ * 
+ * @param file_name   file of data
+ * @param min_value   minimum value of integer field
+ * @param max_value   maximum value of integer field
+ */
+static void start_with_query(const char *file_name, int min_value, int max_value){
+  RecordArray record_array;
+  Record **record_array_p;
+  Record min_record, max_record;
+  Record *min_record_p = &min_record, *max_record_p = &max_record;
+  unsigned long first, last;
+  int direction = 1;
+
+  clock_t start_time;
+  double elapsed_sort_time, elapsed_query_time;
+
+  init_record_array(&record_array);
+  load_array(file_name, &record_array);
+  if(record_array.el_num == 0){
+    ERROR_EXIT("no records in file");
+  }
+
+  record_array_p = init_array_pointers(&record_array);
+  start_time = clock();
+  sort_r(record_array_p, sizeof(Record *), 0, record_array.el_num-1, compare_record_int, &direction);
+  elapsed_sort_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
+
+  min_record.integer_field = min_value;
+  max_record.integer_field = max_value;
+  start_time = clock();
+  key_range_r(&min_record_p, &max_record_p, record_array_p, sizeof(Record *), record_array.el_num, compare_record_int, &direction, &first, &last);
+  elapsed_query_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
+
+  printf("Found %lu records with integer field in [%d, %d]\n", last - first, min_value, max_value);
+  printf("Want print result? [y/n] >> ");
+  if(getchar() == 'y'){
+    printf("\n");
+    print_records(&record_array_p[first], last - first);
+  }
+
+  printf("\nTime (sec):\nSort\t-> %f\nQuery\t-> %f\n", elapsed_sort_time, elapsed_query_time);
+
+  free(record_array_p);
+  free_record_array(&record_array);
+}
+
+/**
+ * @brief It drive the program when new batches of records are appended to the first file.
+ *        Records are kept sorted by integer field (ascending), every batch is merged in
+ *        and the time is compared with a full sort of all records.
+ * 
+ * @param file_name     file of data
+ * @param batch_files   files with batches of records to append
+ * @param batch_num     number of batch files
+ */
+static void start_with_batches(const char *file_name, char **batch_files, int batch_num){
+  RecordArray *record_arrays;
+  SortedRecords sorted_records;
+  Record **resorted_array_p;
+  int direction = 1;
+
+  clock_t start_time;
+  double elapsed_append_time, elapsed_sort_time;
+
+  record_arrays = (RecordArray *)malloc((unsigned long)(batch_num + 1) * sizeof(RecordArray));
+  if(record_arrays == NULL){
+    ERROR_EXIT("unable to allocate memory for batches");
+  }
+
+  init_record_array(&record_arrays[0]);
+  load_array(file_name, &record_arrays[0]);
+  if(record_arrays[0].el_num == 0){
+    ERROR_EXIT("no records in file");
+  }
+
+  sorted_records.array = init_array_pointers(&record_arrays[0]);
+  sorted_records.el_num = record_arrays[0].el_num;
+  sorted_records.array_capacity = record_arrays[0].el_num;
+  sort_r(sorted_records.array, sizeof(Record *), 0, sorted_records.el_num-1, compare_record_int, &direction);
+
+  for(int b = 1; b <= batch_num; b++){
+    init_record_array(&record_arrays[b]);
+    load_array(batch_files[b-1], &record_arrays[b]);
+
+    start_time = clock();
+    append_batch(&sorted_records, &record_arrays[b], &direction);
+    elapsed_append_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
+
+    resorted_array_p = (Record **)malloc(sorted_records.el_num * sizeof(Record *));
+    if(resorted_array_p == NULL){
+      ERROR_EXIT("unable to allocate memory for records pointers");
+    }
+    memcpy(resorted_array_p, sorted_records.array, sorted_records.el_num * sizeof(Record *));
+    start_time = clock();
+    sort_r(resorted_array_p, sizeof(Record *), 0, sorted_records.el_num-1, compare_record_int, &direction);
+    elapsed_sort_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
+    free(resorted_array_p);
+
+    printf("Batch %s: %lu records, %lu total\nAppend\t-> %f\nResort\t-> %f\n", batch_files[b-1],
+            record_arrays[b].el_num, sorted_records.el_num, elapsed_append_time, elapsed_sort_time);
+  }
+
+  printf("End\nWant print result? [y/n] >> ");
+  if(getchar() == 'y'){
+    printf("\n");
+    print_records(sorted_records.array, sorted_records.el_num);
+  }
+
+  free(sorted_records.array);
+  for(int b = 0; b <= batch_num; b++){
+    free_record_array(&record_arrays[b]);
+  }
+  free(record_arrays);
+}
+
 /**
  * @brief It drive the program
  * 
@@ -343,44 +419,27 @@ static void start_with_comparison_function(const char *file_name, int sorting_mo
 
   printf("\nStart sorting\n");
 
-  if(sorting_mode == ASCENDING_SORT){
-    record_array_p = init_array_pointers(&record_array);
-    start_time = clock();
-    sort(record_array_p, sizeof(Record *), 0, record_array.el_num-1, precedes_record_int_ascending);
-    elapsed_integer_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
-    printf(".\n"); 
-  
-    record_array_p = init_array_pointers(&record_array);
-    start_time = clock();
-    sort(record_array_p, sizeof(Record *), 0, record_array.el_num-1, precedes_record_string_ascending);
-    elapsed_string_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
-    printf(".\n"); 
+  int direction = (sorting_mode == ASCENDING_SORT) ? 1 : -1;
 
-    record_array_p = init_array_pointers(&record_array);
-    start_time = clock();
-    sort(record_array_p, sizeof(Record *), 0, record_array.el_num-1, precedes_record_double_ascending);
-    elapsed_double_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
-    printf(".\n"); 
-
-  }else{
-    record_array_p = init_array_pointers(&record_array);
-    start_time = clock();  
-    sort(record_array_p, sizeof(Record *), 0, record_array.el_num-1, precedes_record_int_descending);
-    elapsed_integer_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
-    printf(".\n");
-    
-    record_array_p = init_array_pointers(&record_array);
-    start_time = clock();
-    sort(record_array_p, sizeof(Record *), 0, record_array.el_num-1, precedes_record_string_descending);
-    elapsed_string_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
-    printf(".\n"); 
-    
-    record_array_p = init_array_pointers(&record_array);
-    start_time = clock();
-    sort(record_array_p, sizeof(Record *), 0, record_array.el_num-1, precedes_record_double_descending);
-    elapsed_double_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
-    printf(".\n");  
-  }
+  record_array_p = init_array_pointers(&record_array);
+  start_time = clock();
+  sort_r(record_array_p, sizeof(Record *), 0, record_array.el_num-1, compare_record_int, &direction);
+  elapsed_integer_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
+  printf(".\n"); 
+  free(record_array_p);
+
+  record_array_p = init_array_pointers(&record_array);
+  start_time = clock();
+  sort_r(record_array_p, sizeof(Record *), 0, record_array.el_num-1, compare_record_string, &direction);
+  elapsed_string_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
+  printf(".\n"); 
+  free(record_array_p);
+
+  record_array_p = init_array_pointers(&record_array);
+  start_time = clock();
+  sort_r(record_array_p, sizeof(Record *), 0, record_array.el_num-1, compare_record_double, &direction);
+  elapsed_double_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
+  printf(".\n"); 
 
     getchar();
     printf("End\nWant print result? [y/n] >> ");
@@ -400,11 +459,21 @@ static void start_with_comparison_function(const char *file_name, int sorting_mo
 int main(int argc, char **argv){
 
   setvbuf(stdout, NULL, _IONBF, 0);
-  if(argc < 2){
-    printf("Usage: ordered_array_main <file_name>\n");
+  if(argc < 2 || (argc > 2 && !(strcmp(argv[2], "--append") == 0 && argc >= 4) && !(strcmp(argv[2], "--query") == 0 && argc == 5))){
+    printf("Usage: ordered_array_main <file_name> [--append <batch_file> ... | --query <min_integer> <max_integer>]\n");
     exit(EXIT_FAILURE);
   }
 
+  if(argc > 2){
+    if(strcmp(argv[2], "--append") == 0){
+      start_with_batches(argv[1], &argv[3], argc - 3);
+    }else{
+      start_with_query(argv[1], atoi(argv[3]), atoi(argv[4]));
+    }
+    printf("Exiting..\n");
+    exit(EXIT_SUCCESS);
+  }
+
   printf("Select sort order:\n(1)   Ascending order\n(2)   Descending order\n(any) Exit\n>> ");
   int user_choise = getchar();
   if(user_choise == '1'){
@@ -0,0 +1,232 @@
+/**
+ * @file edit_distance_approx.c
+ * @author Daniele Di Palma
+ * @brief Streaming approximate substring search within k insertions and deletions
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "edit_distance_approx.h"
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+#define ALPHABET_SIZE (UCHAR_MAX + 1)
+#define WORD_BITS (64)
+#define CHUNK_SIZE (1 << 20)    // bytes read at a time from files that can't be mapped
+
+/**
+ * @brief Set states of matcher as before any character: pattern[0..d - 1] is matched
+ *        by deleting its d characters
+ *
+ * @param matcher matcher
+ */
+static void reset_states(ApproxMatcher *matcher){
+  unsigned long words = matcher->words, bits;
+
+  for(unsigned d = 0; d <= matcher->max_distance; d++){
+    bits = d < matcher->pattern_len ? d : matcher->pattern_len;
+    for(unsigned long w = 0; w < words; w++){
+      if(bits >= (w + 1) * WORD_BITS){
+        matcher->states[d * words + w] = ~(uint64_t)0;
+      }else if(bits > w * WORD_BITS){
+        matcher->states[d * words + w] = ((uint64_t)1 << (bits - w * WORD_BITS)) - 1;
+      }else{
+        matcher->states[d * words + w] = 0;
+      }
+    }
+  }
+}
+
+ApproxMatcher *approx_matcher_create(const char *pattern, unsigned max_distance){
+  ApproxMatcher *matcher = NULL;
+  unsigned long words;
+
+  if(pattern == NULL || pattern[0] == '\0'){
+    ERROR_EXIT("Pattern can't be NULL or empty");
+  }
+  if(max_distance == UINT_MAX){
+    ERROR_EXIT("Max distance too big");
+  }
+  matcher = (ApproxMatcher *)malloc(sizeof(ApproxMatcher));
+  if(matcher == NULL){
+    ERROR_EXIT("Unable to allocate matcher");
+  }
+  matcher->pattern_len = strlen(pattern);
+  matcher->words = words = (matcher->pattern_len + WORD_BITS - 1) / WORD_BITS;
+  matcher->max_distance = max_distance;
+  matcher->position = 0;
+  matcher->masks = (uint64_t *)calloc(ALPHABET_SIZE * words, sizeof(uint64_t));
+  matcher->states = (uint64_t *)malloc(((unsigned long)max_distance + 1) * words * sizeof(uint64_t));
+  matcher->previous = (uint64_t *)malloc(words * sizeof(uint64_t));
+  if(matcher->masks == NULL || matcher->states == NULL || matcher->previous == NULL){
+    ERROR_EXIT("Unable to allocate matcher vectors");
+  }
+
+  for(unsigned long i = 0; i < matcher->pattern_len; i++){
+    matcher->masks[(unsigned char)pattern[i] * words + i / WORD_BITS] |= (uint64_t)1 << (i % WORD_BITS);
+  }
+  reset_states(matcher);
+  return matcher;
+}
+
+/**
+ * @brief Report end position of last character read if pattern is matched
+ *
+ * @param matcher   matcher
+ * @param last      word of last pattern character
+ * @param last_bit  bit of last pattern character in its word
+ * @param report    function called for end position
+ * @param context   context passed to report
+ */
+static void report_match(const ApproxMatcher *matcher, unsigned long last, uint64_t last_bit, ApproxReport report, void *context){
+  unsigned d = 0;
+
+  // states grow with distance, the first one with last bit set gives distance
+  while(!(matcher->states[d * matcher->words + last] & last_bit)){
+    d++;
+  }
+  report(matcher->position, d, context);
+}
+
+/**
+ * @brief Read characters with a pattern of at most 64 characters, with states of a single word
+ *
+ * @param matcher   matcher
+ * @param text      characters
+ * @param len       number of characters
+ * @param report    function called for every end position
+ * @param context   context passed to report
+ */
+static void feed_single_word(ApproxMatcher *matcher, const unsigned char *text, unsigned long len, ApproxReport report, void *context){
+  uint64_t *states = matcher->states, *masks = matcher->masks, last_bit = (uint64_t)1 << (matcher->pattern_len - 1);
+  uint64_t mask, previous, current;
+  unsigned max_distance = matcher->max_distance;
+
+  for(unsigned long j = 0; j < len; j++){
+    mask = masks[text[j]];
+    previous = states[0];
+    states[0] = ((states[0] << 1) | 1) & mask;
+    for(unsigned d = 1; d <= max_distance; d++){
+      current = states[d];
+      // match, character of text inserted, character of pattern deleted
+      states[d] = (((current << 1) | 1) & mask) | previous | (states[d - 1] << 1) | 1;
+      previous = current;
+    }
+    matcher->position++;
+    if(states[max_distance] & last_bit){
+      report_match(matcher, 0, last_bit, report, context);
+    }
+  }
+}
+
+/**
+ * @brief Read characters with a pattern of any length, shifting states across words
+ *
+ * @param matcher   matcher
+ * @param text      characters
+ * @param len       number of characters
+ * @param report    function called for every end position
+ * @param context   context passed to report
+ */
+static void feed_multi_word(ApproxMatcher *matcher, const unsigned char *text, unsigned long len, ApproxReport report, void *context){
+  unsigned long words = matcher->words, last = (matcher->pattern_len - 1) / WORD_BITS;
+  uint64_t last_bit = (uint64_t)1 << ((matcher->pattern_len - 1) % WORD_BITS);
+  uint64_t *mask, *state, *lower, *previous = matcher->previous, current, carry, lower_carry;
+
+  for(unsigned long j = 0; j < len; j++){
+    mask = &matcher->masks[text[j] * words];
+    for(unsigned d = 0; d <= matcher->max_distance; d++){
+      state = &matcher->states[d * words];
+      lower = (d > 0) ? state - words : NULL;
+      // shifted vectors get the bit of start of pattern, always matched
+      carry = 1;
+      lower_carry = 1;
+      for(unsigned long w = 0; w < words; w++){
+        current = state[w];
+        state[w] = ((current << 1) | carry) & mask[w];
+        if(d > 0){
+          state[w] |= previous[w] | (lower[w] << 1) | lower_carry;
+          lower_carry = lower[w] >> (WORD_BITS - 1);
+        }
+        carry = current >> (WORD_BITS - 1);
+        previous[w] = current;
+      }
+    }
+    matcher->position++;
+    if(matcher->states[matcher->max_distance * words + last] & last_bit){
+      report_match(matcher, last, last_bit, report, context);
+    }
+  }
+}
+
+void approx_matcher_feed(ApproxMatcher *matcher, const char *text, unsigned long len, ApproxReport report, void *context){
+  if(matcher == NULL || (text == NULL && len > 0) || report == NULL){
+    ERROR_EXIT("Matcher, text and report can't be NULL");
+  }
+  if(matcher->words == 1){
+    feed_single_word(matcher, (const unsigned char *)text, len, report, context);
+  }else{
+    feed_multi_word(matcher, (const unsigned char *)text, len, report, context);
+  }
+}
+
+void approx_matcher_free(ApproxMatcher *matcher){
+  if(matcher != NULL){
+    free(matcher->masks);
+    free(matcher->states);
+    free(matcher->previous);
+    free(matcher);
+  }
+}
+
+unsigned long approx_search_file(const char *path, const char *pattern, unsigned max_distance, ApproxReport report, void *context){
+  ApproxMatcher *matcher = NULL;
+  struct stat file_stat;
+  unsigned long searched;
+  char *data = NULL;
+  ssize_t read_size;
+  int fd;
+
+  if(path == NULL){
+    ERROR_EXIT("Path can't be NULL");
+  }
+  matcher = approx_matcher_create(pattern, max_distance);
+  fd = open(path, O_RDONLY);
+  if(fd < 0 || fstat(fd, &file_stat) != 0){
+    ERROR_EXIT("Unable to open the file");
+  }
+
+  if(S_ISREG(file_stat.st_mode) && file_stat.st_size > 0 &&
+     (data = (char *)mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) != MAP_FAILED){
+    madvise(data, (size_t)file_stat.st_size, MADV_SEQUENTIAL);
+    approx_matcher_feed(matcher, data, (unsigned long)file_stat.st_size, report, context);
+    munmap(data, (size_t)file_stat.st_size);
+  }else{
+    data = (char *)malloc(CHUNK_SIZE);
+    if(data == NULL){
+      ERROR_EXIT("Unable to allocate buffer");
+    }
+    while((read_size = read(fd, data, CHUNK_SIZE)) > 0){
+      approx_matcher_feed(matcher, data, (unsigned long)read_size, report, context);
+    }
+    if(read_size < 0){
+      ERROR_EXIT("Unable to read the file");
+    }
+    free(data);
+  }
+
+  close(fd);
+  searched = matcher->position;
+  approx_matcher_free(matcher);
+  return searched;
+}
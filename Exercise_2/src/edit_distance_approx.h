@@ -0,0 +1,74 @@
+#ifndef _EDIT_DISTANCE_APPROX_H_
+#define _EDIT_DISTANCE_APPROX_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Function called for every end position of an approximate occurrence
+ *
+ * @param end       position after last character of occurrence, counted from first character read
+ * @param distance  minimum distance of pattern from a substring ending at end
+ * @param context   user context
+ */
+typedef void (*ApproxReport)(unsigned long end, unsigned distance, void *context);
+
+/**
+ * @brief It rappresents a streaming matcher of a pattern within max_distance insertions and deletions
+ *        (semi-global matching: occurrences can start anywhere in the text).
+ *        It is a bit-parallel automaton: bit i of state d is set if pattern[0..i] matches a suffix
+ *        of text read so far with at most d operations, so every text character updates
+ *        (max_distance + 1) bit vectors long as the pattern.
+ */
+typedef struct _ApproxMatcher{
+  uint64_t *masks;            // bit i of masks[c * words] set if pattern[i] == c, 256 vectors
+  uint64_t *states;           // state vector of every distance from 0 to max_distance
+  uint64_t *previous;         // scratch vector, state of distance d - 1 before last character
+  unsigned long pattern_len;  // length of pattern
+  unsigned long words;        // 64 bit words of a vector
+  unsigned max_distance;      // maximum number of operations
+  unsigned long position;     // number of characters read
+} ApproxMatcher;
+
+/**
+ * @brief Create matcher of a pattern, with no text read
+ *
+ * @param pattern       pattern, can't be NULL or empty
+ * @param max_distance  maximum number of insertions and deletions
+ * @return ApproxMatcher* allocated matcher, to free with approx_matcher_free
+ */
+ApproxMatcher *approx_matcher_create(const char *pattern, unsigned max_distance);
+
+/**
+ * @brief Read next characters of text: report is called for every position of them where an
+ *        occurrence ends, in order. Text can be split in chunks anywhere, occurrences across
+ *        chunks are found. O(len * (max_distance + 1) * ceil(len(pattern) / 64)) time.
+ *
+ * @param matcher   matcher, can't be NULL
+ * @param text      next characters, can contain '\0', can't be NULL if len > 0
+ * @param len       number of characters
+ * @param report    function called for every end position, can't be NULL
+ * @param context   context passed to report
+ */
+void approx_matcher_feed(ApproxMatcher *matcher, const char *text, unsigned long len, ApproxReport report, void *context);
+
+/**
+ * @brief Free matcher
+ *
+ * @param matcher matcher to free
+ */
+void approx_matcher_free(ApproxMatcher *matcher);
+
+/**
+ * @brief Search a pattern within max_distance insertions and deletions in a file.
+ *        Regular files are mapped in memory, other files (e.g. pipes) are read in chunks.
+ *
+ * @param path          path of file, can't be NULL
+ * @param pattern       pattern, can't be NULL or empty
+ * @param max_distance  maximum number of insertions and deletions
+ * @param report        function called for every end position, in order, can't be NULL
+ * @param context       context passed to report
+ * @return unsigned long number of bytes searched
+ */
+unsigned long approx_search_file(const char *path, const char *pattern, unsigned max_distance, ApproxReport report, void *context);
+
+#endif
@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "unity/unity.h"
+#include "edit_distance_approx.h"
+
+#define MAX_MATCHES (4096)
+
+/**
+ * @brief Matches reported by a search
+ */
+typedef struct _Matches{
+  unsigned long end[MAX_MATCHES];
+  unsigned distance[MAX_MATCHES];
+  unsigned long num;
+} Matches;
+
+static void collect(unsigned long end, unsigned distance, void *context){
+  Matches *matches = (Matches *)context;
+  TEST_ASSERT_TRUE(matches->num < MAX_MATCHES);
+  matches->end[matches->num] = end;
+  matches->distance[matches->num] = distance;
+  matches->num++;
+}
+
+/**
+ * @brief Reference semi-global matching on the full table: row 0 is 0 everywhere,
+ *        so occurrences can start at any position
+ */
+static void reference_matches(const char *pattern, const char *text, unsigned long len, unsigned max_distance, Matches *matches){
+  unsigned long m = strlen(pattern);
+  unsigned *table = (unsigned *)malloc((m + 1) * (len + 1) * sizeof(unsigned));
+
+  for(unsigned long j = 0; j <= len; j++){
+    table[j] = 0;
+  }
+  for(unsigned long i = 1; i <= m; i++){
+    table[i * (len + 1)] = (unsigned)i;
+    for(unsigned long j = 1; j <= len; j++){
+      unsigned best = 1 + (table[(i - 1) * (len + 1) + j] < table[i * (len + 1) + j - 1] ?
+                           table[(i - 1) * (len + 1) + j] : table[i * (len + 1) + j - 1]);
+      if(pattern[i - 1] == text[j - 1] && table[(i - 1) * (len + 1) + j - 1] < best){
+        best = table[(i - 1) * (len + 1) + j - 1];
+      }
+      table[i * (len + 1) + j] = best;
+    }
+  }
+  matches->num = 0;
+  for(unsigned long j = 1; j <= len; j++){
+    if(table[m * (len + 1) + j] <= max_distance){
+      collect(j, table[m * (len + 1) + j], matches);
+    }
+  }
+  free(table);
+}
+
+static void search(const char *pattern, const char *text, unsigned long len, unsigned max_distance, Matches *matches){
+  ApproxMatcher *matcher = approx_matcher_create(pattern, max_distance);
+  matches->num = 0;
+  approx_matcher_feed(matcher, text, len, collect, matches);
+  approx_matcher_free(matcher);
+}
+
+static void assert_same_matches(const Matches *expected, const Matches *actual){
+  TEST_ASSERT_EQUAL_UINT64(expected->num, actual->num);
+  for(unsigned long i = 0; i < expected->num; i++){
+    TEST_ASSERT_EQUAL_UINT64(expected->end[i], actual->end[i]);
+    TEST_ASSERT_EQUAL_INT(expected->distance[i], actual->distance[i]);
+  }
+}
+
+static void test_exact_matches(void){
+  static Matches matches;
+  char *text = "xxabcxabc";
+
+  search("abc", text, strlen(text), 0, &matches);
+  TEST_ASSERT_EQUAL_UINT64(2, matches.num);
+  TEST_ASSERT_EQUAL_UINT64(5, matches.end[0]);
+  TEST_ASSERT_EQUAL_UINT64(9, matches.end[1]);
+  TEST_ASSERT_EQUAL_INT(0, matches.distance[0]);
+}
+
+static void test_insertion_and_deletion(void){
+  static Matches matches;
+  char *text = "la cassa e la cosa";
+
+  // "cas" misses a character, "cassa" has one more, "cosa" needs two operations
+  search("casa", text, strlen(text), 1, &matches);
+  TEST_ASSERT_EQUAL_UINT64(2, matches.num);
+  TEST_ASSERT_EQUAL_UINT64(6, matches.end[0]);
+  TEST_ASSERT_EQUAL_INT(1, matches.distance[0]);
+  TEST_ASSERT_EQUAL_UINT64(8, matches.end[1]);
+  TEST_ASSERT_EQUAL_INT(1, matches.distance[1]);
+}
+
+static void test_same_as_reference(void){
+  static Matches expected, actual;
+  char pattern[151], text[301];
+
+  srand(61);
+  for(int t = 0; t < 500; t++){
+    // patterns of one and more words
+    unsigned long m = 1 + (unsigned long)rand() % ((t % 2) ? 64 : 150), len = (unsigned long)rand() % 300;
+    unsigned max_distance = (unsigned)rand() % 5;
+    int alphabet = 2 + rand() % 3;
+    for(unsigned long i = 0; i < m; i++) pattern[i] = (char)('a' + rand() % alphabet);
+    pattern[m] = '\0';
+    for(unsigned long j = 0; j < len; j++) text[j] = (char)('a' + rand() % alphabet);
+    text[len] = '\0';
+
+    reference_matches(pattern, text, len, max_distance, &expected);
+    search(pattern, text, len, max_distance, &actual);
+    assert_same_matches(&expected, &actual);
+  }
+}
+
+static void test_chunks(void){
+  static Matches expected, actual;
+  char text[2001], *pattern[] = {"abcab", "abcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcab"};
+
+  srand(67);
+  for(int i = 0; i < 2000; i++) text[i] = (char)('a' + rand() % 3);
+  text[2000] = '\0';
+
+  for(int p = 0; p < 2; p++){
+    // occurrence across many chunks
+    memcpy(text + 1000, pattern[p], strlen(pattern[p]));
+    ApproxMatcher *matcher = approx_matcher_create(pattern[p], 2 + (unsigned)p * 20);
+    search(pattern[p], text, 2000, 2 + (unsigned)p * 20, &expected);
+    actual.num = 0;
+    // chunks of random length, some empty
+    for(unsigned long start = 0, chunk; start < 2000; start += chunk){
+      chunk = (unsigned long)rand() % 50;
+      if(start + chunk > 2000) chunk = 2000 - start;
+      approx_matcher_feed(matcher, text + start, chunk, collect, &actual);
+    }
+    TEST_ASSERT_TRUE(expected.num > 0);
+    assert_same_matches(&expected, &actual);
+    approx_matcher_free(matcher);
+  }
+}
+
+static void test_file(void){
+  static Matches expected, actual;
+  char path[] = "/tmp/approx_test_XXXXXX", text[] = "error: connection timeot\nerror: conection timeout\n";
+  int fd = mkstemp(path);
+
+  TEST_ASSERT_TRUE(fd >= 0);
+  TEST_ASSERT_EQUAL_INT64((long)strlen(text), (long)write(fd, text, strlen(text)));
+  close(fd);
+
+  search("connection timeout", text, strlen(text), 1, &expected);
+  actual.num = 0;
+  TEST_ASSERT_EQUAL_UINT64(strlen(text), approx_search_file(path, "connection timeout", 1, collect, &actual));
+  TEST_ASSERT_EQUAL_UINT64(2, actual.num);
+  assert_same_matches(&expected, &actual);
+  unlink(path);
+}
+
+int main(void){
+
+  // test session
+  UNITY_BEGIN();
+  RUN_TEST(test_exact_matches);
+  RUN_TEST(test_insertion_and_deletion);
+  RUN_TEST(test_same_as_reference);
+  RUN_TEST(test_chunks);
+  RUN_TEST(test_file);
+
+  return UNITY_END();
+}
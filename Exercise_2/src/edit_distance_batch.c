@@ -0,0 +1,241 @@
+/**
+ * @file edit_distance_batch.c
+ * @author Daniele Di Palma
+ * @brief Edit distance (insertions and deletions only) of a word against batches
+ *        of candidates, one candidate for every SIMD lane
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include "edit_distance_query.h"
+#include "edit_distance_simd.h"
+#include "edit_distance_batch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86
+#endif
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+/**
+ * @brief It rappresents a word prepared to score batches of candidates:
+ *        buffers are allocated once for all batches
+ */
+typedef struct _BatchScorer{
+  EdQuery *query;             // word, for candidates scored one at a time
+  int kernel;                 // SIMD kernel
+  unsigned char *chars;       // characters of batch, chars[j * BATCH_LANES + lane] is character j of candidate lane
+  unsigned long chars_len;    // longest candidate of chars
+  uint8_t *column;            // DP column of every lane, (len + 1) * BATCH_LANES
+} BatchScorer;
+
+/**
+ * @brief Prepare word for scoring
+ *
+ * @param scorer        scorer to initialize
+ * @param word          word
+ * @param max_cand_len  length of longest candidate
+ */
+static void scorer_init(BatchScorer *scorer, const char *word, unsigned long max_cand_len){
+  scorer->query = ed_query_build(word);
+  scorer->kernel = edit_distance_simd_kernel();
+  scorer->chars_len = max_cand_len;
+  scorer->chars = (unsigned char *)malloc((max_cand_len > 0 ? max_cand_len : 1) * BATCH_LANES);
+  scorer->column = (uint8_t *)malloc((scorer->query->len + 1) * BATCH_LANES * sizeof(uint8_t));
+  if(scorer->chars == NULL || scorer->column == NULL){
+    ERROR_EXIT("Unable to allocate batch buffers");
+  }
+}
+
+static void scorer_free(BatchScorer *scorer){
+  ed_query_free(scorer->query);
+  free(scorer->chars);
+  free(scorer->column);
+}
+
+#ifdef SIMD_X86
+
+/**
+ * @brief Compute DP table of word against 32 candidates by columns with AVX2, in 8 bit lanes:
+ *        column j of every lane is computed from column j - 1, cell i of a lane is
+ *        cell i - 1 of previous column if word[i - 1] matches character j - 1 of its candidate,
+ *        otherwise minimum of cell i of previous column and cell i - 1 of column, plus 1.
+ *        Cells are not greater than len + cand_len, at most UINT8_MAX.
+ *
+ * @param word      word
+ * @param len       length of word
+ * @param chars     characters of candidates by column, cand_len * BATCH_LANES
+ * @param cand_len  length of candidates
+ * @param column    DP column of every lane, (len + 1) * BATCH_LANES
+ * @param results   distance of every lane
+ */
+__attribute__((target("avx2")))
+static void batch_avx2(const unsigned char *word, unsigned long len, const unsigned char *chars, unsigned long cand_len,
+                        uint8_t *column, unsigned *results){
+  const __m256i one = _mm256_set1_epi8(1);
+  __m256i c, diag, above, left, eq;
+
+  for(unsigned long i = 0; i <= len; i++){
+    _mm256_storeu_si256((__m256i *)&column[i * BATCH_LANES], _mm256_set1_epi8((char)i));
+  }
+  for(unsigned long j = 1; j <= cand_len; j++){
+    c = _mm256_loadu_si256((const __m256i *)&chars[(j - 1) * BATCH_LANES]);
+    diag = _mm256_loadu_si256((const __m256i *)&column[0]);
+    above = _mm256_set1_epi8((char)j);
+    _mm256_storeu_si256((__m256i *)&column[0], above);
+    for(unsigned long i = 1; i <= len; i++){
+      left = _mm256_loadu_si256((const __m256i *)&column[i * BATCH_LANES]);
+      eq = _mm256_cmpeq_epi8(_mm256_set1_epi8((char)word[i - 1]), c);
+      above = _mm256_blendv_epi8(_mm256_add_epi8(_mm256_min_epu8(left, above), one), diag, eq);
+      _mm256_storeu_si256((__m256i *)&column[i * BATCH_LANES], above);
+      diag = left;
+    }
+  }
+  for(int lane = 0; lane < 32; lane++){
+    results[lane] = column[len * BATCH_LANES + (unsigned)lane];
+  }
+}
+
+/**
+ * @brief Compute DP table of word against 16 candidates by columns with SSE4.1,
+ *        as batch_avx2. Characters and column are strided by BATCH_LANES.
+ */
+__attribute__((target("sse4.1")))
+static void batch_sse41(const unsigned char *word, unsigned long len, const unsigned char *chars, unsigned long cand_len,
+                        uint8_t *column, unsigned *results){
+  const __m128i one = _mm_set1_epi8(1);
+  __m128i c, diag, above, left, eq;
+
+  for(unsigned long i = 0; i <= len; i++){
+    _mm_storeu_si128((__m128i *)&column[i * BATCH_LANES], _mm_set1_epi8((char)i));
+  }
+  for(unsigned long j = 1; j <= cand_len; j++){
+    c = _mm_loadu_si128((const __m128i *)&chars[(j - 1) * BATCH_LANES]);
+    diag = _mm_loadu_si128((const __m128i *)&column[0]);
+    above = _mm_set1_epi8((char)j);
+    _mm_storeu_si128((__m128i *)&column[0], above);
+    for(unsigned long i = 1; i <= len; i++){
+      left = _mm_loadu_si128((const __m128i *)&column[i * BATCH_LANES]);
+      eq = _mm_cmpeq_epi8(_mm_set1_epi8((char)word[i - 1]), c);
+      above = _mm_blendv_epi8(_mm_add_epi8(_mm_min_epu8(left, above), one), diag, eq);
+      _mm_storeu_si128((__m128i *)&column[i * BATCH_LANES], above);
+      diag = left;
+    }
+  }
+  for(int lane = 0; lane < 16; lane++){
+    results[lane] = column[len * BATCH_LANES + (unsigned)lane];
+  }
+}
+
+#endif
+
+/**
+ * @brief Score up to BATCH_LANES candidates of the same length
+ *
+ * @param scorer      prepared word
+ * @param candidates  candidates
+ * @param cand_len    length of every candidate, not greater than scorer->chars_len
+ * @param cand_num    number of candidates, at most BATCH_LANES
+ * @param results     distance of every candidate
+ */
+static void score_batch(BatchScorer *scorer, char **candidates, unsigned long cand_len, unsigned long cand_num, unsigned *results){
+  unsigned lane_results[BATCH_LANES];
+  const unsigned char *word = (const unsigned char *)scorer->query->word;
+  unsigned long len = scorer->query->len;
+
+  if(cand_num == 0){
+    return;
+  }
+  // 8 bit lanes: longer strings are compared one at a time
+  if(scorer->kernel == SIMD_KERNEL_SCALAR || len + cand_len > UINT8_MAX){
+    for(unsigned long k = 0; k < cand_num; k++){
+      results[k] = ed_query_distance_len(scorer->query, candidates[k], cand_len, UINT_MAX);
+    }
+    return;
+  }
+
+  // unused lanes repeat first candidate
+  for(unsigned long j = 0; j < cand_len; j++){
+    for(unsigned long lane = 0; lane < BATCH_LANES; lane++){
+      scorer->chars[j * BATCH_LANES + lane] = (unsigned char)candidates[lane < cand_num ? lane : 0][j];
+    }
+  }
+
+#ifdef SIMD_X86
+  if(scorer->kernel == SIMD_KERNEL_AVX2){
+    batch_avx2(word, len, scorer->chars, cand_len, scorer->column, lane_results);
+  }else{
+    batch_sse41(word, len, scorer->chars, cand_len, scorer->column, lane_results);
+    if(cand_num > 16){
+      batch_sse41(word, len, &scorer->chars[16], cand_len, &scorer->column[16], &lane_results[16]);
+    }
+  }
+#endif
+  for(unsigned long k = 0; k < cand_num; k++){
+    results[k] = lane_results[k];
+  }
+}
+
+void ed_batch_distance_with(const char *word, char **candidates, unsigned long cand_len, unsigned long cand_num, int kernel, unsigned *results){
+  BatchScorer scorer;
+
+  if(word == NULL){
+    ERROR_EXIT("Word is NULL");
+  }
+  if((candidates == NULL && cand_num > 0) || results == NULL){
+    ERROR_EXIT("Candidates and results references can't be NULL");
+  }
+  if(kernel < SIMD_KERNEL_SCALAR || kernel > edit_distance_simd_kernel()){
+    ERROR_EXIT("Kernel not supported by cpu");
+  }
+
+  scorer_init(&scorer, word, cand_len);
+  scorer.kernel = kernel;
+  for(unsigned long k = 0; k < cand_num; k += BATCH_LANES){
+    score_batch(&scorer, &candidates[k], cand_len, (cand_num - k < BATCH_LANES) ? cand_num - k : BATCH_LANES, &results[k]);
+  }
+  scorer_free(&scorer);
+}
+
+void ed_batch_distance(const char *word, char **candidates, unsigned long cand_len, unsigned long cand_num, unsigned *results){
+  ed_batch_distance_with(word, candidates, cand_len, cand_num, edit_distance_simd_kernel(), results);
+}
+
+/**
+ * @brief Score a batch of packed dictionary candidates, as PackedScorer
+ *
+ * @param context     prepared word (BatchScorer *)
+ * @param candidates  candidates
+ * @param cand_len    length of every candidate
+ * @param cand_num    number of candidates, at most BATCH_LANES
+ * @param radius      unused, lanes compute whole DP tables
+ * @param results     distance of every candidate
+ */
+static void batch_scorer(void *context, char **candidates, unsigned long cand_len, unsigned long cand_num, unsigned radius, unsigned *results){
+  (void)radius;
+  score_batch((BatchScorer *)context, candidates, cand_len, cand_num, results);
+}
+
+unsigned batch_search_min(const PackedDictionary *dictionary, const char *word, unsigned max_distance, unsigned long **results, unsigned long *result_num){
+  BatchScorer scorer;
+  unsigned best;
+
+  if(dictionary == NULL){
+    ERROR_EXIT("Packed dictionary reference can't be NULL");
+  }
+  if(word == NULL){
+    ERROR_EXIT("Word to search is NULL");
+  }
+
+  scorer_init(&scorer, word, dictionary->max_len);
+  best = packed_search_min_with(dictionary, word, max_distance, batch_scorer, &scorer, BATCH_LANES, results, result_num);
+  scorer_free(&scorer);
+  return best;
+}
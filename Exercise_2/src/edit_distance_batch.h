@@ -0,0 +1,54 @@
+#ifndef _EDIT_DISTANCE_BATCH_H_
+#define _EDIT_DISTANCE_BATCH_H_
+
+#include "edit_distance_packed.h"
+
+// candidates scored together, one for every 8 bit lane of an AVX2 register
+#define BATCH_LANES (32)
+
+/**
+ * @brief Calculate edit distance (insertions and deletions only) between a word and
+ *        many candidates of the same length. Candidates are scored BATCH_LANES at a time,
+ *        one for every SIMD lane: the DP table of all of them is computed by column,
+ *        with the same operations on every lane, so no lane is wasted on short words.
+ *        Distances fit 8 bit lanes if len(word) + cand_len <= 255, otherwise candidates
+ *        are compared one at a time.
+ *        Kernel is the best one supported by running cpu (see edit_distance_simd_kernel),
+ *        without SIMD candidates are compared one at a time with bit-parallel LCS.
+ *
+ * @param word          word, can't be NULL
+ * @param candidates    array of candidates, can't be NULL if cand_num > 0
+ * @param cand_len      length of every candidate
+ * @param cand_num      number of candidates
+ * @param results       array of cand_num results, results[i] is distance of candidates[i]
+ */
+void ed_batch_distance(const char *word, char **candidates, unsigned long cand_len, unsigned long cand_num, unsigned *results);
+
+/**
+ * @brief Calculate ed_batch_distance with a given kernel
+ *
+ * @param word          word, can't be NULL
+ * @param candidates    array of candidates, can't be NULL if cand_num > 0
+ * @param cand_len      length of every candidate
+ * @param cand_num      number of candidates
+ * @param kernel        SIMD_KERNEL_SCALAR, SIMD_KERNEL_SSE41 or SIMD_KERNEL_AVX2, supported by cpu
+ * @param results       array of cand_num results, results[i] is distance of candidates[i]
+ */
+void ed_batch_distance_with(const char *word, char **candidates, unsigned long cand_len, unsigned long cand_num, int kernel, unsigned *results);
+
+/**
+ * @brief Search all dictionary words at minimum distance from word, as packed_search_min.
+ *        Candidates of a bucket passing the signature filter are scored in batches
+ *        of BATCH_LANES with ed_batch_distance.
+ *
+ * @param dictionary    packed dictionary, can't be NULL
+ * @param word          word to search, can't be NULL
+ * @param max_distance  max distance of interest, UINT_MAX for no limit
+ * @param results       address where an allocated array of indexes of found words is stored,
+ *                      in dictionary order, to free by caller (NULL if no word is found)
+ * @param result_num    address where number of found words is stored
+ * @return unsigned     minimum distance, max_distance + 1 if no word is found (UINT_MAX if max_distance is UINT_MAX)
+ */
+unsigned batch_search_min(const PackedDictionary *dictionary, const char *word, unsigned max_distance, unsigned long **results, unsigned long *result_num);
+
+#endif
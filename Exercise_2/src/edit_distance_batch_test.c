@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "unity/unity.h"
+#include "edit_distance_batch.h"
+#include "edit_distance_packed.h"
+#include "edit_distance_index_test.h"
+#include "edit_distance_simd.h"
+
+static void test_batch_small_words(void){
+  char *candidates[] = {"casa", "cosa", "cara", "tass", "caso"};
+  unsigned results[5];
+
+  ed_batch_distance("cassa", candidates, 4, 5, results);
+  TEST_ASSERT_EQUAL_INT(1, results[0]);
+  TEST_ASSERT_EQUAL_INT(3, results[1]);
+  TEST_ASSERT_EQUAL_INT(3, results[2]);
+  TEST_ASSERT_EQUAL_INT(3, results[3]);
+  TEST_ASSERT_EQUAL_INT(3, results[4]);
+}
+
+static void test_batch_empty_strings(void){
+  char *candidates[] = {"", ""};
+  char *words[] = {"abc", "xyz"};
+  unsigned results[2];
+
+  ed_batch_distance("pioppo", candidates, 0, 2, results);
+  TEST_ASSERT_EQUAL_INT(6, results[0]);
+  TEST_ASSERT_EQUAL_INT(6, results[1]);
+  ed_batch_distance("", words, 3, 2, results);
+  TEST_ASSERT_EQUAL_INT(3, results[0]);
+  TEST_ASSERT_EQUAL_INT(3, results[1]);
+}
+
+static void test_batch_same_as_dyn(void){
+  char *candidates[40], word[30];
+  unsigned results[40];
+
+  srand(31);
+  for(int t = 0; t < 200; t++){
+    // partial and multiple batches
+    unsigned long cand_num = 1 + (unsigned long)rand() % 40, cand_len = (unsigned long)rand() % 20;
+    int len = rand() % 29;
+    for(int k = 0; k < len; k++) word[k] = (char)('a' + rand() % 3);
+    word[len] = '\0';
+    for(unsigned long i = 0; i < cand_num; i++){
+      candidates[i] = (char *)malloc(cand_len + 1);
+      for(unsigned long k = 0; k < cand_len; k++) candidates[i][k] = (char)('a' + rand() % 3);
+      candidates[i][cand_len] = '\0';
+    }
+
+    for(int kernel = SIMD_KERNEL_SCALAR; kernel <= edit_distance_simd_kernel(); kernel++){
+      ed_batch_distance_with(word, candidates, cand_len, cand_num, kernel, results);
+      for(unsigned long i = 0; i < cand_num; i++){
+        TEST_ASSERT_EQUAL_INT(edit_distance_dyn(word, candidates[i]), results[i]);
+      }
+    }
+    for(unsigned long i = 0; i < cand_num; i++){
+      free(candidates[i]);
+    }
+  }
+}
+
+static void test_batch_lane_boundaries(void){
+  unsigned long cand_nums[] = {15, 16, 17, 31, 32, 33, 64, 65};
+  char *candidates[65];
+  unsigned results[65];
+
+  // every lane gets a different candidate, so results of swapped or unused lanes are noticed
+  for(unsigned long i = 0; i < 65; i++){
+    candidates[i] = (char *)malloc(7);
+    for(unsigned long k = 0; k < 6; k++) candidates[i][k] = ((i >> k) & 1) ? 'x' : (char)('a' + k);
+    candidates[i][6] = '\0';
+  }
+
+  for(int n = 0; n < 8; n++){
+    for(int kernel = SIMD_KERNEL_SCALAR; kernel <= edit_distance_simd_kernel(); kernel++){
+      memset(results, 0xff, sizeof(results));
+      ed_batch_distance_with("abcdef", candidates, 6, cand_nums[n], kernel, results);
+      for(unsigned long i = 0; i < cand_nums[n]; i++){
+        TEST_ASSERT_EQUAL_INT(edit_distance_dyn("abcdef", candidates[i]), results[i]);
+      }
+      if(cand_nums[n] < 65){
+        TEST_ASSERT_EQUAL_UINT(UINT_MAX, results[cand_nums[n]]);
+      }
+    }
+  }
+  for(unsigned long i = 0; i < 65; i++){
+    free(candidates[i]);
+  }
+}
+
+static void test_search_full_batches(void){
+  unsigned long bucket_sizes[] = {16, 32, 33}, *found, found_num;
+  char *words[33];
+  PackedDictionary *packed;
+
+  // one bucket of bucket_size words, only the target is at distance 0
+  for(int b = 0; b < 3; b++){
+    unsigned long targets[] = {0, 15, bucket_sizes[b] - 1};
+    for(int t = 0; t < 3; t++){
+      for(unsigned long i = 0; i < bucket_sizes[b]; i++){
+        words[i] = (i == targets[t]) ? "casa" : "zzzz";
+      }
+      packed = packed_dictionary_build(words, bucket_sizes[b]);
+      TEST_ASSERT_EQUAL_INT(0, batch_search_min(packed, "casa", UINT_MAX, &found, &found_num));
+      TEST_ASSERT_EQUAL_UINT64(1, found_num);
+      TEST_ASSERT_EQUAL_UINT64(targets[t], found[0]);
+      free(found);
+
+      // every other lane of the batches
+      TEST_ASSERT_EQUAL_INT(1, batch_search_min(packed, "zzz", 1, &found, &found_num));
+      TEST_ASSERT_EQUAL_UINT64(bucket_sizes[b] - 1, found_num);
+      TEST_ASSERT_EQUAL_UINT64(targets[t] == 0 ? 1 : 0, found[0]);
+      TEST_ASSERT_EQUAL_UINT64(targets[t] == bucket_sizes[b] - 1 ? bucket_sizes[b] - 2 : bucket_sizes[b] - 1, found[found_num - 1]);
+      free(found);
+      packed_dictionary_free(packed);
+    }
+  }
+}
+
+static unsigned search_min(const void *packed, const char *word, unsigned max_distance, unsigned long **results, unsigned long *result_num){
+  return batch_search_min((const PackedDictionary *)packed, word, max_distance, results, result_num);
+}
+
+static void test_search_same_as_linear_scan(void){
+  char **words;
+  PackedDictionary *packed;
+
+  srand(37);
+  words = random_words(2000, 10, 4);
+  packed = packed_dictionary_build(words, 2000);
+  assert_same_as_linear_scan(packed, search_min, words, 2000, UINT_MAX, 200, 12, 4);
+  assert_same_as_linear_scan(packed, search_min, words, 2000, 1, 200, 12, 4);
+  packed_dictionary_free(packed);
+  free_random_words(words, 2000);
+}
+
+int main(void){
+
+  // test session
+  UNITY_BEGIN();
+  RUN_TEST(test_batch_small_words);
+  RUN_TEST(test_batch_empty_strings);
+  RUN_TEST(test_batch_same_as_dyn);
+  RUN_TEST(test_batch_lane_boundaries);
+  RUN_TEST(test_search_full_batches);
+  RUN_TEST(test_search_same_as_linear_scan);
+
+  return UNITY_END();
+}
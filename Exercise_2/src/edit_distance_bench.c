@@ -0,0 +1,555 @@
+/**
+ * @file edit_distance_bench.c
+ * @author Daniele Di Palma
+ * @brief Benchmark of edit distance implementations on random strings
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "edit_distance_dyn.h"
+#include "edit_distance_bp.h"
+#include "edit_distance_simd.h"
+#include "edit_distance_script.h"
+#include "edit_distance_myers.h"
+#include "edit_distance_seq.h"
+#include "edit_distance_approx.h"
+#include "edit_distance_tokens.h"
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+#define ALPHABET_SIZE (26)
+#define WORD_PAIRS (200000)
+#define MAX_MEMO_LEN (2000)
+#define MAX_DYN_LEN (20000)
+#define MAX_MYERS_LEN (10000)
+#define SIMILAR_EDIT_PERIOD (1000)
+#define LINE_EDIT_PERIOD (100)
+#define MAX_LINE_LEN (60)
+#define APPROX_BLOCK_SIZE (1 << 20)
+#define APPROX_PATTERN "connection timeout"
+#define APPROX_MAX_DISTANCE (2)
+#define MAX_WORD_LEN (12)
+#define USAGE "Usage: edit_distance_bench [--script <length> | --approx <megabytes> | --load <megabytes>]"
+
+/**
+ * @brief It rappresents an implementation of edit distance under benchmark
+ *
+ */
+typedef struct _BenchFunction{
+  const char *name;
+  unsigned (*edit_distance)(char *, char *);
+  unsigned long max_len;  // longest strings the implementation can handle
+} BenchFunction;
+
+static const BenchFunction bench_functions[] = {
+  { "edit_distance_dyn_memo", edit_distance_dyn_memo, MAX_MEMO_LEN },
+  { "edit_distance_dyn", edit_distance_dyn, MAX_DYN_LEN },
+  { "edit_distance_simd", edit_distance_simd, ULONG_MAX },
+  { "edit_distance_bp", edit_distance_bp, ULONG_MAX },
+  { "edit_distance_myers", edit_distance_myers, MAX_MYERS_LEN },
+  { "edit_distance_auto", edit_distance_auto, ULONG_MAX },
+};
+
+// implementations fast enough on long strings with few differences
+static const BenchFunction similar_functions[] = {
+  { "edit_distance_bp", edit_distance_bp, ULONG_MAX },
+  { "edit_distance_myers", edit_distance_myers, ULONG_MAX },
+  { "edit_distance_auto", edit_distance_auto, ULONG_MAX },
+};
+
+/**
+ * @brief Allocate a random string of lowercase letters
+ *
+ * @param len     length of string
+ * @return char*  allocated string
+ */
+static char *random_string(unsigned long len){
+  char *str = (char *)malloc(len + 1);
+  if(str == NULL){
+    ERROR_EXIT("Unable to allocate string");
+  }
+  for(unsigned long i = 0; i < len; i++){
+    str[i] = (char)('a' + rand() % ALPHABET_SIZE);
+  }
+  str[len] = '\0';
+  return str;
+}
+
+/**
+ * @brief Allocate a copy of string with about one edit every edit_period characters
+ *
+ * @param str           original string
+ * @param len           length of string
+ * @param edit_period   average distance between edits
+ * @return char*        allocated string
+ */
+static char *mutated_string(const char *str, unsigned long len, int edit_period){
+  char *mutated = (char *)malloc(2 * len + 1);
+  unsigned long k = 0;
+  if(mutated == NULL){
+    ERROR_EXIT("Unable to allocate string");
+  }
+  for(unsigned long i = 0; i < len; i++){
+    int r = rand() % (2 * edit_period);
+    if(r == 0){
+      continue;                                           // deletion
+    }else if(r == 1){
+      mutated[k++] = (char)('a' + rand() % ALPHABET_SIZE); // insertion
+    }
+    mutated[k++] = str[i];
+  }
+  mutated[k] = '\0';
+  return mutated;
+}
+
+/**
+ * @brief Time implementations on pairs of strings
+ *
+ * @param functions       implementations
+ * @param function_num    number of implementations
+ * @param s1              first strings of pairs
+ * @param s2              second strings of pairs
+ * @param len             length of first strings
+ * @param pairs           number of pairs
+ */
+static void time_functions(const BenchFunction *functions, unsigned long function_num, char **s1, char **s2,
+                           unsigned long len, unsigned long pairs){
+  unsigned long checksum;
+  clock_t start_time;
+  double elapsed_time;
+
+  for(unsigned long f = 0; f < function_num; f++){
+    if(len > functions[f].max_len){
+      printf("%-28s skipped\n", functions[f].name);
+      continue;
+    }
+    checksum = 0;
+    start_time = clock();
+    for(unsigned long p = 0; p < pairs; p++){
+      checksum += functions[f].edit_distance(s1[p], s2[p]);
+    }
+    elapsed_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
+    printf("%-28s %10.4f sec  %12.2f us/pair  checksum %lu\n", functions[f].name,
+            elapsed_time, elapsed_time * 1e6 / (double)pairs, checksum);
+  }
+}
+
+/**
+ * @brief Time all implementations on pairs of strings of given length
+ *
+ * @param len       length of strings
+ * @param pairs     number of pairs
+ */
+static void run_bench(unsigned long len, unsigned long pairs){
+  char **s1 = (char **)malloc(pairs * sizeof(char *));
+  char **s2 = (char **)malloc(pairs * sizeof(char *));
+
+  if(s1 == NULL || s2 == NULL){
+    ERROR_EXIT("Unable to allocate strings");
+  }
+
+  srand(1);
+  for(unsigned long p = 0; p < pairs; p++){
+    s1[p] = random_string(len);
+    s2[p] = (p % 2) ? mutated_string(s1[p], len, 10) : random_string(len);
+  }
+
+  printf("\nLength %lu, %lu pairs\n", len, pairs);
+  time_functions(bench_functions, sizeof(bench_functions)/sizeof(bench_functions[0]), s1, s2, len, pairs);
+
+  for(unsigned long p = 0; p < pairs; p++){
+    free(s1[p]);
+    free(s2[p]);
+  }
+  free(s1);
+  free(s2);
+}
+
+/**
+ * @brief Time implementations for long strings on pairs of strings of given length
+ *        with about one edit every SIMILAR_EDIT_PERIOD characters
+ *
+ * @param len       length of strings
+ * @param pairs     number of pairs
+ */
+static void run_similar_bench(unsigned long len, unsigned long pairs){
+  char **s1 = (char **)malloc(pairs * sizeof(char *));
+  char **s2 = (char **)malloc(pairs * sizeof(char *));
+
+  if(s1 == NULL || s2 == NULL){
+    ERROR_EXIT("Unable to allocate strings");
+  }
+
+  srand(1);
+  for(unsigned long p = 0; p < pairs; p++){
+    s1[p] = random_string(len);
+    s2[p] = mutated_string(s1[p], len, SIMILAR_EDIT_PERIOD);
+  }
+
+  printf("\nLength %lu, %lu pairs, one edit every %d characters\n", len, pairs, SIMILAR_EDIT_PERIOD);
+  time_functions(similar_functions, sizeof(similar_functions)/sizeof(similar_functions[0]), s1, s2, len, pairs);
+
+  for(unsigned long p = 0; p < pairs; p++){
+    free(s1[p]);
+    free(s2[p]);
+  }
+  free(s1);
+  free(s2);
+}
+
+// lines repeated many times in text files
+static char *common_lines[] = { "", "}", "{", "  return 0;", "#", "end", "  break;", "else" };
+
+/**
+ * @brief Allocate a copy of string
+ *
+ * @param str     string
+ * @return char*  allocated copy
+ */
+static char *copy_string(const char *str){
+  char *copy = (char *)malloc(strlen(str) + 1);
+  if(copy == NULL){
+    ERROR_EXIT("Unable to allocate string");
+  }
+  strcpy(copy, str);
+  return copy;
+}
+
+/**
+ * @brief Allocate a random line: one of common_lines (1 every 10 lines) or
+ *        random characters of random length
+ *
+ * @return char*  allocated line
+ */
+static char *random_line(void){
+  if(rand() % 10 == 0){
+    return copy_string(common_lines[rand() % (int)(sizeof(common_lines)/sizeof(common_lines[0]))]);
+  }
+  return random_string(1 + (unsigned long)rand() % MAX_LINE_LEN);
+}
+
+/**
+ * @brief Compare two lines as in sort()
+ *
+ * @param l1  address of first line
+ * @param l2  address of second line
+ * @return int 2 if lines are equal, 1 if first precedes second, 0 otherwise
+ */
+static int precedes_line(void *l1, void *l2){
+  int cmp = strcmp(*(char **)l1, *(char **)l2);
+  if(cmp == 0){
+    return 2;
+  }
+  return cmp < 0;
+}
+
+/**
+ * @brief Hash lines to 32 bit ids with FNV-1a
+ *
+ * @param lines     lines
+ * @param line_num  number of lines
+ * @param ids       array of line_num ids
+ */
+static void hash_lines(char **lines, unsigned long line_num, uint32_t *ids){
+  for(unsigned long l = 0; l < line_num; l++){
+    uint32_t hash = 2166136261u;
+    for(const unsigned char *c = (const unsigned char *)lines[l]; *c != '\0'; c++){
+      hash = (hash ^ *c) * 16777619u;
+    }
+    ids[l] = hash;
+  }
+}
+
+/**
+ * @brief Time line-level diff of a file of random lines with a copy with about one line
+ *        inserted, deleted or changed every LINE_EDIT_PERIOD lines, and with another file
+ *        of random lines
+ *
+ * @param line_num  number of lines of first file
+ */
+static void run_lines_bench(unsigned long line_num){
+  char **lines1 = (char **)malloc(line_num * sizeof(char *));
+  char **lines2 = (char **)malloc(2 * line_num * sizeof(char *));
+  uint32_t *ids1 = (uint32_t *)malloc(line_num * sizeof(uint32_t));
+  uint32_t *ids2 = (uint32_t *)malloc(2 * line_num * sizeof(uint32_t));
+  unsigned long line_num2, distance;
+  clock_t start_time;
+  double elapsed_time;
+
+  if(lines1 == NULL || lines2 == NULL || ids1 == NULL || ids2 == NULL){
+    ERROR_EXIT("Unable to allocate lines");
+  }
+
+  srand(1);
+  for(unsigned long l = 0; l < line_num; l++){
+    lines1[l] = random_line();
+  }
+  for(int similar = 1; similar >= 0; similar--){
+    line_num2 = 0;
+    for(unsigned long l = 0; l < line_num; l++){
+      int r = similar ? rand() % (3 * LINE_EDIT_PERIOD) : 0;
+      if(!similar || r == 1 || r == 2){
+        lines2[line_num2++] = random_line();        // other file, insertion or change
+      }
+      if(similar && r != 0 && r != 2){
+        lines2[line_num2++] = copy_string(lines1[l]);    // line not deleted or changed
+      }
+    }
+
+    if(similar){
+      printf("\nLines %lu and %lu, one line changed every %d lines\n", line_num, line_num2, LINE_EDIT_PERIOD);
+    }else{
+      printf("\nLines %lu and %lu, different files\n", line_num, line_num2);
+    }
+
+    start_time = clock();
+    distance = edit_distance_seq(lines1, line_num, lines2, line_num2, sizeof(char *), precedes_line);
+    elapsed_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
+    printf("%-28s %10.4f sec  distance %lu\n", "edit_distance_seq", elapsed_time, distance);
+
+    start_time = clock();
+    hash_lines(lines1, line_num, ids1);
+    hash_lines(lines2, line_num2, ids2);
+    distance = edit_distance_seq_u32(ids1, line_num, ids2, line_num2);
+    elapsed_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
+    printf("%-28s %10.4f sec  distance %lu (with hashing)\n", "edit_distance_seq_u32", elapsed_time, distance);
+
+    for(unsigned long l = 0; l < line_num2; l++){
+      free(lines2[l]);
+    }
+  }
+
+  for(unsigned long l = 0; l < line_num; l++){
+    free(lines1[l]);
+  }
+  free(lines1);
+  free(lines2);
+  free(ids1);
+  free(ids2);
+}
+
+/**
+ * @brief Peak resident memory of process
+ *
+ * @return long  peak resident memory in KB
+ */
+static long peak_memory_kb(void){
+  struct rusage usage;
+  if(getrusage(RUSAGE_SELF, &usage) != 0){
+    ERROR_EXIT("Unable to get resource usage");
+  }
+  return usage.ru_maxrss;
+}
+
+/**
+ * @brief Time edit_script on a string and a mutated copy of given length, reporting
+ *        peak memory of process (strings included), so it runs alone in its own process
+ *
+ * @param len   length of first string
+ */
+static void run_script_bench(unsigned long len){
+  char *s1, *s2, *applied;
+  EditScript *script;
+  clock_t start_time;
+  double elapsed_time;
+
+  srand(1);
+  s1 = random_string(len);
+  s2 = mutated_string(s1, len, 10);
+
+  printf("\nEdit script, length %lu and %lu\n", len, (unsigned long)strlen(s2));
+  start_time = clock();
+  script = edit_script(s1, s2);
+  elapsed_time = (double)(clock() - start_time)/CLOCKS_PER_SEC;
+  printf("%-28s %10.4f sec  %8ld KB peak memory  distance %u  %lu runs\n", "edit_script",
+          elapsed_time, peak_memory_kb(), script->distance, script->run_num);
+
+  applied = edit_script_apply(script, s1, s2);
+  if(strcmp(applied, s2) != 0){
+    ERROR_EXIT("Edit script doesn't transform first string into second string");
+  }
+
+  free(applied);
+  edit_script_free(script);
+  free(s1);
+  free(s2);
+}
+
+// messages of log lines, the searched one is written with typos
+static char *log_messages[] = { "request served", "cache miss", "connection timeout", "user logged in", "retrying" };
+
+/**
+ * @brief Fill block with log lines, a message of them every 50 has a character removed
+ *        or added
+ *
+ * @param block block to fill
+ * @param size  size of block
+ */
+static void fill_log_block(char *block, unsigned long size){
+  unsigned long len = 0, line = 0;
+  char entry[128], message[64];
+  int message_len;
+
+  while(len < size){
+    strcpy(message, log_messages[rand() % (int)(sizeof(log_messages)/sizeof(log_messages[0]))]);
+    message_len = (int)strlen(message);
+    if(line++ % 50 == 0){
+      int at = rand() % message_len;
+      if(rand() % 2){
+        memmove(message + at, message + at + 1, (size_t)(message_len - at));
+      }else{
+        memmove(message + at + 1, message + at, (size_t)(message_len - at + 1));
+        message[at] = (char)('a' + rand() % ALPHABET_SIZE);
+      }
+    }
+    snprintf(entry, sizeof(entry), "2024-05-%02d %02d:%02d:%02d worker-%d %s after %d ms\n", 1 + rand() % 28,
+             rand() % 24, rand() % 60, rand() % 60, rand() % 16, message, rand() % 5000);
+    for(int i = 0; entry[i] != '\0' && len < size; i++){
+      block[len++] = entry[i];
+    }
+  }
+}
+
+static void count_match(unsigned long end, unsigned distance, void *context){
+  (void)end;
+  (void)distance;
+  (*(unsigned long *)context)++;
+}
+
+/**
+ * @brief Write a log file of megabytes and search it for APPROX_PATTERN within
+ *        APPROX_MAX_DISTANCE operations, printing throughput of the search
+ *
+ * @param megabytes size of file in megabytes
+ */
+static void run_approx_bench(unsigned long megabytes){
+  char path[] = "/tmp/edit_distance_bench_XXXXXX", *block = (char *)malloc(APPROX_BLOCK_SIZE);
+  struct timespec start_time, end_time;
+  unsigned long matches = 0, searched;
+  double elapsed_time;
+  int fd;
+
+  if(block == NULL){
+    ERROR_EXIT("Unable to allocate block");
+  }
+  fd = mkstemp(path);
+  if(fd < 0){
+    ERROR_EXIT("Unable to create temporary file");
+  }
+  // same block written again, the file is read from page cache anyway
+  srand(1);
+  fill_log_block(block, APPROX_BLOCK_SIZE);
+  for(unsigned long i = 0; i < megabytes; i++){
+    if(write(fd, block, APPROX_BLOCK_SIZE) != APPROX_BLOCK_SIZE){
+      ERROR_EXIT("Unable to write temporary file");
+    }
+  }
+  close(fd);
+  free(block);
+
+  printf("\nApproximate search of \"%s\" within %d operations, %lu MB\n", APPROX_PATTERN, APPROX_MAX_DISTANCE, megabytes);
+  clock_gettime(CLOCK_MONOTONIC, &start_time);
+  searched = approx_search_file(path, APPROX_PATTERN, APPROX_MAX_DISTANCE, count_match, &matches);
+  clock_gettime(CLOCK_MONOTONIC, &end_time);
+  elapsed_time = (double)(end_time.tv_sec - start_time.tv_sec) + (double)(end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+  printf("%-28s %10.4f sec  %8.3f GB/s  %lu matches\n", "approx_search_file",
+          elapsed_time, (double)searched / elapsed_time / 1e9, matches);
+
+  unlink(path);
+}
+
+/**
+ * @brief Write a file of megabytes of random words, a line every 10 words, and load it
+ *        in a single arena, printing throughput of loading
+ *
+ * @param megabytes size of file in megabytes
+ */
+static void run_load_bench(unsigned long megabytes){
+  char path[] = "/tmp/edit_distance_bench_XXXXXX", *block = (char *)malloc(APPROX_BLOCK_SIZE);
+  struct timespec start_time, end_time;
+  unsigned long len = 0, word_len, words = 0;
+  double elapsed_time;
+  TokenFile *tokens;
+  int fd;
+
+  if(block == NULL){
+    ERROR_EXIT("Unable to allocate block");
+  }
+  fd = mkstemp(path);
+  if(fd < 0){
+    ERROR_EXIT("Unable to create temporary file");
+  }
+  srand(1);
+  while(len < APPROX_BLOCK_SIZE){
+    word_len = 1 + (unsigned long)rand() % MAX_WORD_LEN;
+    for(unsigned long i = 0; i < word_len && len < APPROX_BLOCK_SIZE; i++){
+      block[len++] = (char)('a' + rand() % ALPHABET_SIZE);
+    }
+    if(len < APPROX_BLOCK_SIZE){
+      block[len++] = (++words % 10 == 0) ? '\n' : ' ';
+    }
+  }
+  for(unsigned long i = 0; i < megabytes; i++){
+    if(write(fd, block, APPROX_BLOCK_SIZE) != APPROX_BLOCK_SIZE){
+      ERROR_EXIT("Unable to write temporary file");
+    }
+  }
+  close(fd);
+  free(block);
+
+  printf("\nLoading of words, %lu MB\n", megabytes);
+  clock_gettime(CLOCK_MONOTONIC, &start_time);
+  tokens = token_file_load(path, " \n");
+  clock_gettime(CLOCK_MONOTONIC, &end_time);
+  elapsed_time = (double)(end_time.tv_sec - start_time.tv_sec) + (double)(end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+  printf("%-28s %10.4f sec  %8.3f GB/s  %lu words\n", "token_file_load",
+          elapsed_time, (double)megabytes * (1 << 20) / elapsed_time / 1e9, tokens->word_num);
+
+  token_file_free(tokens);
+  unlink(path);
+}
+
+int main(int argc, char const *argv[]){
+
+  if(argc == 3 && strcmp(argv[1], "--script") == 0){
+    setvbuf(stdout, NULL, _IONBF, 0);
+    run_script_bench(strtoul(argv[2], NULL, 10));
+    exit(EXIT_SUCCESS);
+  }else if(argc == 3 && strcmp(argv[1], "--approx") == 0){
+    setvbuf(stdout, NULL, _IONBF, 0);
+    run_approx_bench(strtoul(argv[2], NULL, 10));
+    exit(EXIT_SUCCESS);
+  }else if(argc == 3 && strcmp(argv[1], "--load") == 0){
+    setvbuf(stdout, NULL, _IONBF, 0);
+    run_load_bench(strtoul(argv[2], NULL, 10));
+    exit(EXIT_SUCCESS);
+  }else if(argc != 1){
+    printf(USAGE "\n");
+    exit(EXIT_FAILURE);
+  }
+
+  setvbuf(stdout, NULL, _IONBF, 0);
+  printf("SIMD kernel: %s\n", edit_distance_simd_kernel_name(edit_distance_simd_kernel()));
+
+  run_bench(8, WORD_PAIRS);
+  run_bench(16, WORD_PAIRS);
+  run_bench(100, WORD_PAIRS/100);
+  run_bench(1000, WORD_PAIRS/10000);
+  run_bench(10000, 2);
+  run_bench(100000, 1);
+  run_similar_bench(10000, 10);
+  run_similar_bench(100000, 1);
+  run_lines_bench(100000);
+
+  exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,248 @@
+/**
+ * @file edit_distance_bktree.c
+ * @author Daniele Di Palma
+ * @brief BK-tree over a dictionary for nearest words search with edit distance
+ *        (insertions and deletions only)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "edit_distance_query.h"
+#include "edit_distance_bktree.h"
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+#define INITIAL_CAPACITY (16)
+
+/**
+ * @brief It rappresents a node to visit with distance of query from its parent word
+ *
+ */
+typedef struct _BkVisit{
+  unsigned long node;
+  unsigned parent_distance;
+} BkVisit;
+
+static int compare_index(const void *idx_1, const void *idx_2){
+  unsigned long idx_1_v = *(const unsigned long *)idx_1;
+  unsigned long idx_2_v = *(const unsigned long *)idx_2;
+  return (idx_1_v > idx_2_v) - (idx_1_v < idx_2_v);
+}
+
+/**
+ * @brief Calculate difference between edge of node to visit and distance of query from its parent
+ *
+ * @param tree    BK-tree
+ * @param visit   node to visit
+ * @return unsigned  absolute difference
+ */
+static unsigned edge_gap(const BkTree *tree, const BkVisit *visit){
+  unsigned edge = tree->nodes[visit->node].edge;
+  return (edge > visit->parent_distance) ? edge - visit->parent_distance : visit->parent_distance - edge;
+}
+
+BkTree *bktree_build(char **words, unsigned long word_num){
+  BkTree *tree = NULL;
+  EdQuery *query = NULL;
+  unsigned long node, child;
+  unsigned distance;
+
+  if(words == NULL && word_num > 0){
+    ERROR_EXIT("Dictionary words reference can't be NULL");
+  }
+
+  tree = (BkTree *)malloc(sizeof(BkTree));
+  if(tree == NULL){
+    ERROR_EXIT("Unable to allocate BK-tree");
+  }
+  tree->nodes = (BkNode *)malloc((word_num > 0 ? word_num : 1) * sizeof(BkNode));
+  if(tree->nodes == NULL){
+    ERROR_EXIT("Unable to allocate BK-tree nodes");
+  }
+  tree->words = words;
+  tree->node_num = 0;
+
+  for(unsigned long i = 0; i < word_num; i++){
+    BkNode *new_node = &tree->nodes[tree->node_num];
+    new_node->word = i;
+    new_node->edge = 0;
+    new_node->max_edge = 0;
+    new_node->first_child = BK_NONE;
+    new_node->next_sibling = BK_NONE;
+
+    if(tree->node_num > 0){
+      // go down from root following the edge equal to distance, until a free edge is found
+      query = ed_query_build(words[i]);
+      node = 0;
+      while(1){
+        distance = ed_query_distance(query, words[tree->nodes[node].word], UINT_MAX);
+        child = tree->nodes[node].first_child;
+        while(child != BK_NONE && tree->nodes[child].edge != distance){
+          child = tree->nodes[child].next_sibling;
+        }
+        if(child == BK_NONE){
+          break;
+        }
+        node = child;
+      }
+      ed_query_free(query);
+
+      new_node->edge = distance;
+      new_node->next_sibling = tree->nodes[node].first_child;
+      tree->nodes[node].first_child = tree->node_num;
+      if(distance > tree->nodes[node].max_edge){
+        tree->nodes[node].max_edge = distance;
+      }
+    }
+    tree->node_num++;
+  }
+
+  return tree;
+}
+
+/**
+ * @brief Search all dictionary words at minimum distance from query, if it is not greater than radius.
+ *        Radius shrinks to best distance found.
+ *
+ * @param tree        BK-tree with at least one node
+ * @param query       preprocessed word to search
+ * @param radius      max distance of interest
+ * @param stack       array of tree->node_num nodes to visit
+ * @param found       address of allocated array where indexes of found words are stored (reallocated if full)
+ * @param found_capacity  address of capacity of found array
+ * @param found_num   address where number of found words is stored
+ * @return unsigned   minimum distance, radius + 1 if no word is found
+ */
+static unsigned bktree_search_radius(const BkTree *tree, const EdQuery *query, unsigned radius, BkVisit *stack, unsigned long **found, unsigned long *found_capacity, unsigned long *found_num){
+  unsigned long stack_num = 0, child, first_pushed;
+  unsigned best = (radius == UINT_MAX) ? UINT_MAX : radius + 1, bound, distance;
+  BkVisit visit;
+  const BkNode *node;
+
+  *found_num = 0;
+  stack[stack_num].node = 0;
+  stack[stack_num].parent_distance = 0;
+  stack_num++;
+
+  while(stack_num > 0){
+    visit = stack[--stack_num];
+    node = &tree->nodes[visit.node];
+
+    // radius could be shrunk after node was pushed
+    if(visit.node != 0 && (unsigned long)node->edge + radius < visit.parent_distance){
+      continue;
+    }
+    if(visit.node != 0 && node->edge > (unsigned long)visit.parent_distance + radius){
+      continue;
+    }
+
+    // exact distance is needed only up to radius + max_edge: above that node and its children are out
+    bound = (radius > UINT_MAX - node->max_edge) ? UINT_MAX : radius + node->max_edge;
+    distance = ed_query_distance(query, tree->words[node->word], bound);
+
+    if(distance <= radius){
+      if(distance < best){
+        best = distance;
+        radius = distance;
+        *found_num = 0;
+      }
+      if(*found_num >= *found_capacity){
+        *found_capacity *= 2;
+        *found = (unsigned long *)realloc(*found, *found_capacity * sizeof(unsigned long));
+        if(*found == NULL){
+          ERROR_EXIT("Unable to re-allocate found words");
+        }
+      }
+      (*found)[(*found_num)++] = node->word;
+    }
+
+    first_pushed = stack_num;
+    for(child = node->first_child; child != BK_NONE; child = tree->nodes[child].next_sibling){
+      if((unsigned long)tree->nodes[child].edge + radius >= distance && tree->nodes[child].edge <= (unsigned long)distance + radius){
+        stack[stack_num].node = child;
+        stack[stack_num].parent_distance = distance;
+        stack_num++;
+      }
+    }
+
+    // children with edge nearest to distance are visited first, so radius shrinks sooner
+    for(unsigned long k = first_pushed + 1; k < stack_num; k++){
+      visit = stack[k];
+      unsigned long l = k;
+      while(l > first_pushed && edge_gap(tree, &stack[l - 1]) < edge_gap(tree, &visit)){
+        stack[l] = stack[l - 1];
+        l--;
+      }
+      stack[l] = visit;
+    }
+  }
+
+  return best;
+}
+
+unsigned bktree_search_min(const BkTree *tree, const char *word, unsigned max_distance, unsigned long **results, unsigned long *result_num){
+  EdQuery *query = NULL;
+  BkVisit *stack = NULL;
+  unsigned long *found = NULL;
+  unsigned long found_num = 0, found_capacity = INITIAL_CAPACITY;
+  unsigned radius, best;
+
+  if(tree == NULL){
+    ERROR_EXIT("BK-tree reference can't be NULL");
+  }
+  if(word == NULL){
+    ERROR_EXIT("Word to search is NULL");
+  }
+  if(results == NULL || result_num == NULL){
+    ERROR_EXIT("Results references can't be NULL");
+  }
+
+  *results = NULL;
+  *result_num = 0;
+  if(tree->node_num == 0){
+    return (max_distance == UINT_MAX) ? UINT_MAX : max_distance + 1;
+  }
+
+  // every node is pushed at most once
+  stack = (BkVisit *)malloc(tree->node_num * sizeof(BkVisit));
+  found = (unsigned long *)malloc(found_capacity * sizeof(unsigned long));
+  if(stack == NULL || found == NULL){
+    ERROR_EXIT("Unable to allocate memory for search");
+  }
+  query = ed_query_build(word);
+
+  // visited nodes grow fast with radius and nearest words are usually near:
+  // search with small radius first and double it until a word is found
+  radius = (max_distance < 1) ? max_distance : 1;
+  while(1){
+    best = bktree_search_radius(tree, query, radius, stack, &found, &found_capacity, &found_num);
+    if(found_num > 0 || radius == max_distance){
+      break;
+    }
+    radius = (radius > max_distance / 2) ? max_distance : 2 * radius;
+  }
+
+  ed_query_free(query);
+  free(stack);
+
+  if(found_num == 0){
+    free(found);
+    return (max_distance == UINT_MAX) ? UINT_MAX : best;
+  }
+  qsort(found, found_num, sizeof(unsigned long), compare_index);
+  *results = found;
+  *result_num = found_num;
+  return best;
+}
+
+void bktree_free(BkTree *tree){
+  if(tree != NULL){
+    free(tree->nodes);
+    free(tree);
+  }
+}
@@ -0,0 +1,62 @@
+#ifndef _EDIT_DISTANCE_BKTREE_H_
+#define _EDIT_DISTANCE_BKTREE_H_
+
+/**
+ * @brief It rappresents a node of BK-tree: a dictionary word and the list of its children.
+ *        Every child has a different distance from the node word (edge), words in subtree
+ *        of a child are at distance edge from the node word.
+ */
+typedef struct _BkNode{
+  unsigned long word;         // index of word in dictionary
+  unsigned edge;              // distance from parent word
+  unsigned max_edge;          // max edge of children
+  unsigned long first_child;  // index of first child node, BK_NONE if leaf
+  unsigned long next_sibling; // index of next sibling node, BK_NONE if last
+} BkNode;
+
+/**
+ * @brief It rappresents a BK-tree over a dictionary with edit distance (insertions and deletions only).
+ *        Distance is a metric, so by triangle inequality the words at distance <= r from a query
+ *        at distance d from a node are only in children with edge in [d - r, d + r].
+ */
+typedef struct _BkTree{
+  char **words;             // dictionary words, not copied
+  BkNode *nodes;            // nodes in insertion order, nodes[0] is root
+  unsigned long node_num;   // number of nodes (number of words)
+} BkTree;
+
+#define BK_NONE ((unsigned long)-1)
+
+/**
+ * @brief Build BK-tree inserting dictionary words in order. Words are not copied,
+ *        they must live as long as the tree. Duplicated words are kept (edge 0).
+ *
+ * @param words     array of dictionary words, can't be NULL if word_num > 0
+ * @param word_num  number of words
+ * @return BkTree*  allocated tree, to free with bktree_free
+ */
+BkTree *bktree_build(char **words, unsigned long word_num);
+
+/**
+ * @brief Search all dictionary words at minimum distance from word.
+ *        Radius of search starts from 1 (0 if max_distance is 0) and doubles, up to max_distance,
+ *        until a word is found; in every search it shrinks to best distance found.
+ *
+ * @param tree          BK-tree, can't be NULL
+ * @param word          word to search, can't be NULL
+ * @param max_distance  max distance of interest, UINT_MAX for no limit
+ * @param results       address where an allocated array of indexes of found words is stored,
+ *                      in dictionary order, to free by caller (NULL if no word is found)
+ * @param result_num    address where number of found words is stored
+ * @return unsigned     minimum distance, max_distance + 1 if no word is found
+ */
+unsigned bktree_search_min(const BkTree *tree, const char *word, unsigned max_distance, unsigned long **results, unsigned long *result_num);
+
+/**
+ * @brief Free BK-tree (not dictionary words)
+ *
+ * @param tree  tree to free
+ */
+void bktree_free(BkTree *tree);
+
+#endif
@@ -0,0 +1,84 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "unity/unity.h"
+#include "edit_distance_bktree.h"
+#include "edit_distance_index_test.h"
+
+static char *dictionary[] = {"casa", "cassa", "cosa", "tassa", "passato", "casa", "pioppo", "cara", "a", ""};
+static const unsigned long dictionary_num = 10;
+
+static unsigned search_min(const void *tree, const char *word, unsigned max_distance, unsigned long **results, unsigned long *result_num){
+  return bktree_search_min((const BkTree *)tree, word, max_distance, results, result_num);
+}
+
+static void test_empty_tree(void){
+  BkTree *tree = bktree_build(NULL, 0);
+  unsigned long *found, found_num;
+
+  TEST_ASSERT_EQUAL_INT(UINT_MAX, bktree_search_min(tree, "casa", UINT_MAX, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(0, found_num);
+  TEST_ASSERT_NULL(found);
+  bktree_free(tree);
+}
+
+static void test_exact_word_with_duplicates(void){
+  BkTree *tree = bktree_build(dictionary, dictionary_num);
+  unsigned long *found, found_num;
+
+  TEST_ASSERT_EQUAL_INT(0, bktree_search_min(tree, "casa", UINT_MAX, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(2, found_num);
+  TEST_ASSERT_EQUAL_UINT64(0, found[0]);
+  TEST_ASSERT_EQUAL_UINT64(5, found[1]);
+  free(found);
+  bktree_free(tree);
+}
+
+static void test_all_words_at_min_distance(void){
+  BkTree *tree = bktree_build(dictionary, dictionary_num);
+  unsigned long *found, found_num;
+
+  // both copies of "casa" are at distance 1, "cassa" and "a" at distance 2
+  TEST_ASSERT_EQUAL_INT(1, bktree_search_min(tree, "cas", UINT_MAX, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(2, found_num);
+  TEST_ASSERT_EQUAL_UINT64(0, found[0]);
+  TEST_ASSERT_EQUAL_UINT64(5, found[1]);
+  free(found);
+  bktree_free(tree);
+}
+
+static void test_max_distance(void){
+  BkTree *tree = bktree_build(dictionary, dictionary_num);
+  unsigned long *found, found_num;
+
+  TEST_ASSERT_EQUAL_INT(3, bktree_search_min(tree, "zzzzzzzz", 2, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(0, found_num);
+  TEST_ASSERT_NULL(found);
+  bktree_free(tree);
+}
+
+static void test_same_as_linear_scan(void){
+  char **words;
+  BkTree *tree;
+
+  srand(29);
+  words = random_words(2000, 10, 4);
+  tree = bktree_build(words, 2000);
+  assert_same_as_linear_scan(tree, search_min, words, 2000, UINT_MAX, 200, 12, 4);
+  bktree_free(tree);
+  free_random_words(words, 2000);
+}
+
+int main(void){
+
+  // test session
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_tree);
+  RUN_TEST(test_exact_word_with_duplicates);
+  RUN_TEST(test_all_words_at_min_distance);
+  RUN_TEST(test_max_distance);
+  RUN_TEST(test_same_as_linear_scan);
+
+  return UNITY_END();
+}
@@ -0,0 +1,139 @@
+/**
+ * @file edit_distance_bp.c
+ * @author Daniele Di Palma
+ * @brief Bit-parallel version of edit distance (insertions and deletions only)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include "edit_distance_bp.h"
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+#define WORD_BITS (64)
+#define ALPHABET_SIZE (UCHAR_MAX + 1)
+
+/**
+ * @brief Calculate LCS length of a pattern up to 64 characters and a text.
+ *        Bit i of peq[c] is set if pattern[i] == c, bit i of V is 0 when column i of LCS row
+ *        increases: for every text character V = (V + U) | (V - U) with U = V & peq[c].
+ *        Since U is a subset of V, V - U is V & ~U.
+ *
+ * @param pattern       pattern string
+ * @param pattern_len   length of pattern, 1 <= pattern_len <= 64
+ * @param text          text string
+ * @param text_len      length of text
+ * @return unsigned long length of LCS
+ */
+static unsigned long lcs_single_word(const unsigned char *pattern, unsigned long pattern_len, const unsigned char *text, unsigned long text_len){
+  uint64_t peq[ALPHABET_SIZE];
+  uint64_t mask = (pattern_len == WORD_BITS) ? ~(uint64_t)0 : (((uint64_t)1 << pattern_len) - 1);
+  uint64_t v = ~(uint64_t)0, u;
+
+  // only entries of characters in strings are read, so only those are initialized
+  for(unsigned long j = 0; j < text_len; j++){
+    peq[text[j]] = 0;
+  }
+  for(unsigned long i = 0; i < pattern_len; i++){
+    peq[pattern[i]] = 0;
+  }
+  for(unsigned long i = 0; i < pattern_len; i++){
+    peq[pattern[i]] |= (uint64_t)1 << i;
+  }
+
+  for(unsigned long j = 0; j < text_len; j++){
+    u = v & peq[text[j]];
+    v = (v + u) | (v & ~u);
+  }
+
+  return (unsigned long)__builtin_popcountll(~v & mask);
+}
+
+/**
+ * @brief Calculate LCS length of a pattern of any length and a text.
+ *        Same recurrence as lcs_single_word on a vector of ceil(pattern_len/64) words,
+ *        the carry of the addition is propagated from lower to higher words.
+ *
+ * @param pattern       pattern string
+ * @param pattern_len   length of pattern, pattern_len > 64
+ * @param text          text string
+ * @param text_len      length of text
+ * @return unsigned long length of LCS
+ */
+static unsigned long lcs_multi_word(const unsigned char *pattern, unsigned long pattern_len, const unsigned char *text, unsigned long text_len){
+  unsigned long words = (pattern_len + WORD_BITS - 1) / WORD_BITS;
+  uint64_t *peq = NULL, *v = NULL, *peq_c;
+  uint64_t last_mask;
+  unsigned long lcs = 0;
+
+  peq = (uint64_t *)calloc(ALPHABET_SIZE * words, sizeof(uint64_t));
+  v = (uint64_t *)malloc(words * sizeof(uint64_t));
+  if(peq == NULL || v == NULL){
+    ERROR_EXIT("Unable to allocate bit vectors");
+  }
+
+  for(unsigned long i = 0; i < pattern_len; i++){
+    peq[pattern[i] * words + i / WORD_BITS] |= (uint64_t)1 << (i % WORD_BITS);
+  }
+  for(unsigned long w = 0; w < words; w++){
+    v[w] = ~(uint64_t)0;
+  }
+
+  for(unsigned long j = 0; j < text_len; j++){
+    peq_c = &peq[text[j] * words];
+    bp_lcs_step(v, peq_c, words);
+  }
+
+  last_mask = (pattern_len % WORD_BITS == 0) ? ~(uint64_t)0 : (((uint64_t)1 << (pattern_len % WORD_BITS)) - 1);
+  for(unsigned long w = 0; w < words; w++){
+    lcs += (unsigned long)__builtin_popcountll(~v[w] & (w == words - 1 ? last_mask : ~(uint64_t)0));
+  }
+
+  free(peq);
+  free(v);
+  return lcs;
+}
+
+unsigned edit_distance_bp(char *s1, char *s2){
+  unsigned long s1_len, s2_len, lcs;
+
+  if(s1 == NULL){
+    ERROR_EXIT("First string is NULL");
+  }
+  if(s2 == NULL){
+    ERROR_EXIT("Second string is NULL");
+  }
+
+  s1_len = strlen(s1);
+  s2_len = strlen(s2);
+
+  if(s1_len + s2_len >= UINT_MAX){
+    ERROR_EXIT("Strings too long");
+  }
+
+  // pattern is the shortest string, so bit vectors are as short as possible
+  if(s1_len < s2_len){
+    char *s_tmp = s1;
+    unsigned long len_tmp = s1_len;
+    s1 = s2;
+    s1_len = s2_len;
+    s2 = s_tmp;
+    s2_len = len_tmp;
+  }
+
+  if(s2_len == 0){
+    return (unsigned)s1_len;
+  }else if(s2_len <= WORD_BITS){
+    lcs = lcs_single_word((const unsigned char *)s2, s2_len, (const unsigned char *)s1, s1_len);
+  }else{
+    lcs = lcs_multi_word((const unsigned char *)s2, s2_len, (const unsigned char *)s1, s1_len);
+  }
+
+  return (unsigned)(s1_len + s2_len - 2 * lcs);
+}
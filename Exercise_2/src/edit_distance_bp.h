@@ -0,0 +1,42 @@
+#ifndef _EDIT_DISTANCE_BP_H_
+#define _EDIT_DISTANCE_BP_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Calculate edit distance between two strings with bit-parallel LCS.
+ *        Only insertions and deletions are allowed, so distance is
+ *        len(s1) + len(s2) - 2 * LCS(s1, s2).
+ *        LCS is computed on bit vectors long as the shortest string (Allison-Dix / Hyyro):
+ *        O(ceil(min(len)/64) * max(len)) word operations. Strings up to 64 characters
+ *        use a single machine word and no allocation.
+ *
+ * @param s1  first string, can't be NULL
+ * @param s2  second string, can't be NULL
+ * @return unsigned number of operation
+ */
+unsigned edit_distance_bp(char *s1, char *s2);
+
+/**
+ * @brief Advance bit-parallel LCS by one character of the text: zero bits of v mark
+ *        the pattern positions matched so far, and with u = v & peq the new vector is
+ *        (v + u) | (v & ~u), the carry of the addition going from lower to higher words.
+ *        Shared by every multi word LCS (strings, queries, edit scripts, id sequences).
+ *
+ * @param v       bit vector of words words, all ones before the first character
+ * @param peq     bit vector of pattern positions equal to the character
+ * @param words   number of words of v and peq
+ */
+static inline void bp_lcs_step(uint64_t *v, const uint64_t *peq, unsigned long words){
+  uint64_t u, partial, sum, carry = 0;
+
+  for(unsigned long w = 0; w < words; w++){
+    u = v[w] & peq[w];
+    partial = v[w] + u;
+    sum = partial + carry;
+    carry = (partial < u) | (sum < partial);
+    v[w] = sum | (v[w] & ~u);
+  }
+}
+
+#endif
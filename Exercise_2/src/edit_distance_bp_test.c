@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity/unity.h"
+#include "edit_distance_bp.h"
+#include "edit_distance_dyn.h"
+
+static void test_empty_strings(void){
+  char *s1 = "";
+  char *s2 = "";
+  TEST_ASSERT_EQUAL_INT(0, edit_distance_bp(s1, s2));
+}
+
+static void test_first_empty_string(void){
+  char *s1 = "";
+  char *s2 = "welcome";
+  TEST_ASSERT_EQUAL_INT(7, edit_distance_bp(s1, s2));
+}
+
+static void test_second_empty_string(void){
+  char *s1 = "hello";
+  char *s2 = "";
+  TEST_ASSERT_EQUAL_INT(5, edit_distance_bp(s1, s2));
+}
+
+static void test_equal_strings(void){
+  char *s1 = "pioppo";
+  char *s2 = "pioppo";
+  TEST_ASSERT_EQUAL_INT(0, edit_distance_bp(s1, s2));
+}
+
+static void test_two_string_different_len(void){
+  char *s1 = "tassa";
+  char *s2 = "passato";
+  TEST_ASSERT_EQUAL_INT(4, edit_distance_bp(s1, s2));
+}
+
+static void test_two_string_same_len(void){
+  char *s1 = "casa";
+  char *s2 = "cara";
+  TEST_ASSERT_EQUAL_INT(2, edit_distance_bp(s1, s2));
+}
+
+static void test_non_ascii_strings(void){
+  char *s1 = "perch\xc3\xa9";
+  char *s2 = "perche";
+  TEST_ASSERT_EQUAL_INT(3, edit_distance_bp(s1, s2));
+}
+
+static void test_same_as_dyn_random_strings(void){
+  char s1[300], s2[300];
+  
+  srand(19);
+  for(int t = 0; t < 2000; t++){
+    // lengths around the single word limit and multiple words
+    int len1 = rand() % 299, len2 = (t % 2) ? rand() % 70 : rand() % 299;
+    for(int i = 0; i < len1; i++) s1[i] = (char)('a' + rand() % 3);
+    for(int i = 0; i < len2; i++) s2[i] = (char)('a' + rand() % 3);
+    s1[len1] = '\0';
+    s2[len2] = '\0';
+    TEST_ASSERT_EQUAL_INT(edit_distance_dyn(s1, s2), edit_distance_bp(s1, s2));
+  }
+}
+
+static void test_long_strings(void){
+  unsigned long len = 20000;
+  char *s1 = (char *)malloc(len + 1);
+  char *s2 = (char *)malloc(len + 1);
+  
+  memset(s1, 'a', len);
+  memset(s2, 'a', len);
+  s1[len] = s2[len] = '\0';
+  s2[len/2] = 'b';
+  TEST_ASSERT_EQUAL_INT(2, edit_distance_bp(s1, s2));
+  free(s1);
+  free(s2);
+}
+
+int main(void){
+
+  // test session
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_strings);
+  RUN_TEST(test_first_empty_string);
+  RUN_TEST(test_second_empty_string);
+  RUN_TEST(test_equal_strings);
+  RUN_TEST(test_two_string_different_len);
+  RUN_TEST(test_two_string_same_len);
+  RUN_TEST(test_non_ascii_strings);
+  RUN_TEST(test_same_as_dyn_random_strings);
+  RUN_TEST(test_long_strings);
+
+  return UNITY_END();
+}
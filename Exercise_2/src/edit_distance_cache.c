@@ -0,0 +1,335 @@
+/**
+ * @file edit_distance_cache.c
+ * @author Daniele Di Palma
+ * @brief Cache of corrections of repeated words and set of dictionary words
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "edit_distance_cache.h"
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+#define INITIAL_CAPACITY (64)
+#define FNV_OFFSET (2166136261u)
+#define FNV_PRIME (16777619u)
+
+/**
+ * @brief Calculate FNV-1a hash of a string
+ *
+ * @param str       string
+ * @return uint32_t hash
+ */
+static uint32_t word_hash(const char *str){
+  uint32_t hash = FNV_OFFSET;
+  for(const unsigned char *c = (const unsigned char *)str; *c != '\0'; c++){
+    hash = (hash ^ *c) * FNV_PRIME;
+  }
+  return hash;
+}
+
+/**
+ * @brief Remove an entry from list of recently used entries
+ *
+ * @param cache   cache
+ * @param entry   index of entry
+ */
+static void lru_unlink(CorrectionCache *cache, uint32_t entry){
+  CacheEntry *e = &cache->entries[entry];
+
+  if(e->lru_prev != CACHE_NONE){
+    cache->entries[e->lru_prev].lru_next = e->lru_next;
+  }else{
+    cache->lru_head = e->lru_next;
+  }
+  if(e->lru_next != CACHE_NONE){
+    cache->entries[e->lru_next].lru_prev = e->lru_prev;
+  }else{
+    cache->lru_tail = e->lru_prev;
+  }
+}
+
+/**
+ * @brief Insert an entry as most recently used
+ *
+ * @param cache   cache
+ * @param entry   index of entry
+ */
+static void lru_push_front(CorrectionCache *cache, uint32_t entry){
+  CacheEntry *e = &cache->entries[entry];
+
+  e->lru_prev = CACHE_NONE;
+  e->lru_next = cache->lru_head;
+  if(cache->lru_head != CACHE_NONE){
+    cache->entries[cache->lru_head].lru_prev = entry;
+  }else{
+    cache->lru_tail = entry;
+  }
+  cache->lru_head = entry;
+}
+
+/**
+ * @brief Search entry of a word
+ *
+ * @param cache     cache
+ * @param word      word
+ * @param hash      hash of word
+ * @return uint32_t index of entry, CACHE_NONE if word is not cached
+ */
+static uint32_t find_entry(const CorrectionCache *cache, const char *word, uint32_t hash){
+  uint32_t entry = cache->buckets[hash & (cache->bucket_num - 1)];
+
+  while(entry != CACHE_NONE && (cache->entries[entry].hash != hash || strcmp(cache->entries[entry].word, word) != 0)){
+    entry = cache->entries[entry].hash_next;
+  }
+  return entry;
+}
+
+/**
+ * @brief Double number of buckets and redistribute entries
+ *
+ * @param cache   cache
+ */
+static void grow_buckets(CorrectionCache *cache){
+  uint32_t *bucket;
+
+  cache->bucket_num *= 2;
+  cache->buckets = (uint32_t *)realloc(cache->buckets, cache->bucket_num * sizeof(uint32_t));
+  if(cache->buckets == NULL){
+    ERROR_EXIT("Unable to re-allocate cache buckets");
+  }
+  for(unsigned long b = 0; b < cache->bucket_num; b++){
+    cache->buckets[b] = CACHE_NONE;
+  }
+  for(unsigned long i = 0; i < cache->entry_num; i++){
+    bucket = &cache->buckets[cache->entries[i].hash & (cache->bucket_num - 1)];
+    cache->entries[i].hash_next = *bucket;
+    *bucket = (uint32_t)i;
+  }
+}
+
+/**
+ * @brief Remove least recently used entry from its bucket and free its data,
+ *        entry is left in list of recently used entries
+ *
+ * @param cache     cache, not empty
+ * @return uint32_t index of free entry
+ */
+static uint32_t evict_entry(CorrectionCache *cache){
+  uint32_t entry = cache->lru_tail;
+  CacheEntry *e = &cache->entries[entry];
+  uint32_t *link = &cache->buckets[e->hash & (cache->bucket_num - 1)];
+
+  while(*link != entry){
+    link = &cache->entries[*link].hash_next;
+  }
+  *link = e->hash_next;
+  free(e->word);
+  free(e->corrections);
+  cache->evictions++;
+  return entry;
+}
+
+CorrectionCache *cache_build(unsigned long max_entries){
+  CorrectionCache *cache = NULL;
+
+  if(max_entries >= CACHE_NONE){
+    ERROR_EXIT("Too many cache entries");
+  }
+
+  cache = (CorrectionCache *)malloc(sizeof(CorrectionCache));
+  if(cache == NULL){
+    ERROR_EXIT("Unable to allocate cache");
+  }
+  cache->max_entries = max_entries;
+  cache->entry_num = 0;
+  cache->entry_capacity = (max_entries > 0 && max_entries < INITIAL_CAPACITY) ? max_entries : INITIAL_CAPACITY;
+  cache->bucket_num = INITIAL_CAPACITY;
+  cache->lru_head = CACHE_NONE;
+  cache->lru_tail = CACHE_NONE;
+  cache->hits = 0;
+  cache->misses = 0;
+  cache->evictions = 0;
+
+  cache->entries = (CacheEntry *)malloc(cache->entry_capacity * sizeof(CacheEntry));
+  cache->buckets = (uint32_t *)malloc(cache->bucket_num * sizeof(uint32_t));
+  if(cache->entries == NULL || cache->buckets == NULL){
+    ERROR_EXIT("Unable to allocate cache entries");
+  }
+  for(unsigned long b = 0; b < cache->bucket_num; b++){
+    cache->buckets[b] = CACHE_NONE;
+  }
+  return cache;
+}
+
+int cache_lookup(CorrectionCache *cache, const char *word, unsigned *distance, char ***corrections, unsigned long *correction_num){
+  uint32_t entry;
+
+  if(cache == NULL || word == NULL){
+    ERROR_EXIT("Cache and word references can't be NULL");
+  }
+  if(distance == NULL || corrections == NULL || correction_num == NULL){
+    ERROR_EXIT("Results references can't be NULL");
+  }
+
+  entry = find_entry(cache, word, word_hash(word));
+  if(entry == CACHE_NONE){
+    cache->misses++;
+    return 0;
+  }
+  cache->hits++;
+  if(entry != cache->lru_head){
+    lru_unlink(cache, entry);
+    lru_push_front(cache, entry);
+  }
+  *distance = cache->entries[entry].distance;
+  *corrections = cache->entries[entry].corrections;
+  *correction_num = cache->entries[entry].correction_num;
+  return 1;
+}
+
+void cache_insert(CorrectionCache *cache, const char *word, unsigned distance, char **corrections, unsigned long correction_num){
+  uint32_t hash, entry, *bucket;
+  CacheEntry *e;
+
+  if(cache == NULL || word == NULL){
+    ERROR_EXIT("Cache and word references can't be NULL");
+  }
+  if(corrections == NULL && correction_num > 0){
+    ERROR_EXIT("Corrections reference can't be NULL");
+  }
+
+  hash = word_hash(word);
+  if(find_entry(cache, word, hash) != CACHE_NONE){
+    return;
+  }
+
+  if(cache->max_entries > 0 && cache->entry_num >= cache->max_entries){
+    entry = evict_entry(cache);
+    lru_unlink(cache, entry);
+  }else{
+    if(cache->entry_num >= cache->entry_capacity){
+      cache->entry_capacity *= 2;
+      if(cache->max_entries > 0 && cache->entry_capacity > cache->max_entries){
+        cache->entry_capacity = cache->max_entries;
+      }
+      cache->entries = (CacheEntry *)realloc(cache->entries, cache->entry_capacity * sizeof(CacheEntry));
+      if(cache->entries == NULL){
+        ERROR_EXIT("Unable to re-allocate cache entries");
+      }
+    }
+    if(cache->entry_num >= CACHE_NONE - 1){
+      ERROR_EXIT("Too many cache entries");
+    }
+    // at most one entry for every bucket on average
+    if(cache->entry_num >= cache->bucket_num){
+      grow_buckets(cache);
+    }
+    entry = (uint32_t)cache->entry_num++;
+  }
+
+  e = &cache->entries[entry];
+  e->word = (char *)malloc(strlen(word) + 1);
+  e->corrections = (char **)malloc((correction_num > 0 ? correction_num : 1) * sizeof(char *));
+  if(e->word == NULL || e->corrections == NULL){
+    ERROR_EXIT("Unable to allocate cache entry");
+  }
+  strcpy(e->word, word);
+  if(correction_num > 0){
+    memcpy(e->corrections, corrections, correction_num * sizeof(char *));
+  }
+  e->correction_num = correction_num;
+  e->distance = distance;
+  e->hash = hash;
+
+  bucket = &cache->buckets[hash & (cache->bucket_num - 1)];
+  e->hash_next = *bucket;
+  *bucket = entry;
+  lru_push_front(cache, entry);
+}
+
+void cache_free(CorrectionCache *cache){
+  if(cache != NULL){
+    for(unsigned long i = 0; i < cache->entry_num; i++){
+      free(cache->entries[i].word);
+      free(cache->entries[i].corrections);
+    }
+    free(cache->entries);
+    free(cache->buckets);
+    free(cache);
+  }
+}
+
+WordSet *word_set_build(char **words, unsigned long word_num){
+  WordSet *set = NULL;
+  unsigned long slot;
+
+  if(words == NULL && word_num > 0){
+    ERROR_EXIT("Dictionary words reference can't be NULL");
+  }
+  if(word_num >= UINT32_MAX){
+    ERROR_EXIT("Too many dictionary words");
+  }
+
+  set = (WordSet *)malloc(sizeof(WordSet));
+  if(set == NULL){
+    ERROR_EXIT("Unable to allocate word set");
+  }
+  // load factor at most 3/4
+  set->capacity = INITIAL_CAPACITY;
+  while(set->capacity * 3 < word_num * 4){
+    set->capacity *= 2;
+  }
+  set->word_num = 0;
+  set->slots = (char **)calloc(set->capacity, sizeof(char *));
+  set->counts = (uint32_t *)calloc(set->capacity, sizeof(uint32_t));
+  if(set->slots == NULL || set->counts == NULL){
+    ERROR_EXIT("Unable to allocate word set slots");
+  }
+
+  for(unsigned long i = 0; i < word_num; i++){
+    slot = word_hash(words[i]) & (set->capacity - 1);
+    while(set->slots[slot] != NULL && strcmp(set->slots[slot], words[i]) != 0){
+      slot = (slot + 1) & (set->capacity - 1);
+    }
+    if(set->slots[slot] == NULL){
+      set->slots[slot] = words[i];
+      set->word_num++;
+    }
+    set->counts[slot]++;
+  }
+  return set;
+}
+
+unsigned long word_set_count(const WordSet *set, const char *word, char **match){
+  unsigned long slot;
+
+  if(set == NULL || word == NULL){
+    ERROR_EXIT("Set and word references can't be NULL");
+  }
+
+  slot = word_hash(word) & (set->capacity - 1);
+  while(set->slots[slot] != NULL){
+    if(strcmp(set->slots[slot], word) == 0){
+      if(match != NULL){
+        *match = set->slots[slot];
+      }
+      return set->counts[slot];
+    }
+    slot = (slot + 1) & (set->capacity - 1);
+  }
+  return 0;
+}
+
+void word_set_free(WordSet *set){
+  if(set != NULL){
+    free(set->slots);
+    free(set->counts);
+    free(set);
+  }
+}
@@ -0,0 +1,119 @@
+#ifndef _EDIT_DISTANCE_CACHE_H_
+#define _EDIT_DISTANCE_CACHE_H_
+
+#include <stdint.h>
+
+#define CACHE_NONE (UINT32_MAX)
+
+/**
+ * @brief It rappresents corrections computed for a word. Corrections are pointers
+ *        to dictionary words, they are copied but words are not.
+ */
+typedef struct _CacheEntry{
+  char *word;                   // corrected word, copied
+  char **corrections;           // words at minimum distance
+  unsigned long correction_num; // number of corrections
+  unsigned distance;            // minimum distance
+  uint32_t hash;                // hash of word
+  uint32_t hash_next;           // next entry in the same bucket
+  uint32_t lru_prev;            // more recently used entry
+  uint32_t lru_next;            // less recently used entry
+} CacheEntry;
+
+/**
+ * @brief It rappresents a cache from word to its corrections, a hash table with chaining
+ *        on an array of entries. Entries are kept in a list from most to least recently used:
+ *        if max_entries is not 0 least recently used entry is replaced when cache is full.
+ */
+typedef struct _CorrectionCache{
+  CacheEntry *entries;          // entries, entry_num are used
+  unsigned long entry_num;      // number of entries
+  unsigned long entry_capacity; // capacity of entries
+  uint32_t *buckets;            // first entry of every bucket
+  unsigned long bucket_num;     // number of buckets, a power of 2
+  unsigned long max_entries;    // max number of entries, 0 for no limit
+  uint32_t lru_head;            // most recently used entry
+  uint32_t lru_tail;            // least recently used entry
+  unsigned long hits;           // lookups of cached words
+  unsigned long misses;         // lookups of words not cached
+  unsigned long evictions;      // replaced entries
+} CorrectionCache;
+
+/**
+ * @brief It rappresents the set of distinct dictionary words with their number of copies,
+ *        a hash table with open addressing. Words are not copied.
+ */
+typedef struct _WordSet{
+  char **slots;                 // first copy of every word, NULL for empty slots
+  uint32_t *counts;             // copies of word in every slot
+  unsigned long capacity;       // number of slots, a power of 2
+  unsigned long word_num;       // number of distinct words
+} WordSet;
+
+/**
+ * @brief Build an empty cache
+ *
+ * @param max_entries       max number of cached words, 0 for no limit
+ * @return CorrectionCache* allocated cache, to free with cache_free
+ */
+CorrectionCache *cache_build(unsigned long max_entries);
+
+/**
+ * @brief Search corrections of a word and mark it as most recently used.
+ *        Returned corrections are valid until next cache_insert.
+ *
+ * @param cache           cache, can't be NULL
+ * @param word            word, can't be NULL
+ * @param distance        address where minimum distance is stored
+ * @param corrections     address where corrections array is stored
+ * @param correction_num  address where number of corrections is stored
+ * @return int            1 if word is cached, 0 otherwise
+ */
+int cache_lookup(CorrectionCache *cache, const char *word, unsigned *distance, char ***corrections, unsigned long *correction_num);
+
+/**
+ * @brief Insert corrections of a word, nothing is done if word is already cached.
+ *        If cache is full least recently used word is removed.
+ *
+ * @param cache           cache, can't be NULL
+ * @param word            word, can't be NULL, it is copied
+ * @param distance        minimum distance
+ * @param corrections     array of corrections, can be NULL if correction_num is 0
+ * @param correction_num  number of corrections
+ */
+void cache_insert(CorrectionCache *cache, const char *word, unsigned distance, char **corrections, unsigned long correction_num);
+
+/**
+ * @brief Free cache
+ *
+ * @param cache   cache to free
+ */
+void cache_free(CorrectionCache *cache);
+
+/**
+ * @brief Build set of dictionary words
+ *
+ * @param words     array of dictionary words, can't be NULL if word_num > 0
+ * @param word_num  number of words, less than 2^32
+ * @return WordSet* allocated set, to free with word_set_free
+ */
+WordSet *word_set_build(char **words, unsigned long word_num);
+
+/**
+ * @brief Count copies of a word in set
+ *
+ * @param set             set, can't be NULL
+ * @param word            word, can't be NULL
+ * @param match           address where first copy of word in set is stored, can be NULL
+ * @return unsigned long  number of copies, 0 if word is not in set
+ */
+unsigned long word_set_count(const WordSet *set, const char *word, char **match);
+
+/**
+ * @brief Free set
+ *
+ * @param set   set to free
+ */
+void word_set_free(WordSet *set);
+
+#endif
@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "unity/unity.h"
+#include "edit_distance_cache.h"
+
+static char *dictionary[] = {"casa", "cassa", "cosa", "tassa", "casa", "a", ""};
+static const unsigned long dictionary_num = 7;
+
+static void test_cache_miss_then_hit(void){
+  CorrectionCache *cache = cache_build(0);
+  char **corrections;
+  unsigned long correction_num;
+  unsigned distance;
+
+  TEST_ASSERT_EQUAL_INT(0, cache_lookup(cache, "cas", &distance, &corrections, &correction_num));
+  cache_insert(cache, "cas", 1, dictionary, 2);
+  TEST_ASSERT_EQUAL_INT(1, cache_lookup(cache, "cas", &distance, &corrections, &correction_num));
+  TEST_ASSERT_EQUAL_INT(1, distance);
+  TEST_ASSERT_EQUAL_UINT64(2, correction_num);
+  TEST_ASSERT_EQUAL_PTR(dictionary[0], corrections[0]);
+  TEST_ASSERT_EQUAL_PTR(dictionary[1], corrections[1]);
+  TEST_ASSERT_EQUAL_UINT64(1, cache->hits);
+  TEST_ASSERT_EQUAL_UINT64(1, cache->misses);
+  cache_free(cache);
+}
+
+static void test_cache_insert_twice(void){
+  CorrectionCache *cache = cache_build(0);
+  char **corrections;
+  unsigned long correction_num;
+  unsigned distance;
+
+  cache_insert(cache, "cas", 1, dictionary, 1);
+  cache_insert(cache, "cas", 2, NULL, 0);
+  TEST_ASSERT_EQUAL_UINT64(1, cache->entry_num);
+  TEST_ASSERT_EQUAL_INT(1, cache_lookup(cache, "cas", &distance, &corrections, &correction_num));
+  TEST_ASSERT_EQUAL_INT(1, distance);
+  TEST_ASSERT_EQUAL_UINT64(1, correction_num);
+  cache_free(cache);
+}
+
+static void test_cache_grows_unbounded(void){
+  CorrectionCache *cache = cache_build(0);
+  char **corrections, word[16];
+  unsigned long correction_num;
+  unsigned distance;
+
+  for(unsigned i = 0; i < 5000; i++){
+    sprintf(word, "w%u", i);
+    cache_insert(cache, word, i, &dictionary[i % dictionary_num], 1);
+  }
+  TEST_ASSERT_EQUAL_UINT64(5000, cache->entry_num);
+  TEST_ASSERT_EQUAL_UINT64(0, cache->evictions);
+  for(unsigned i = 0; i < 5000; i++){
+    sprintf(word, "w%u", i);
+    TEST_ASSERT_EQUAL_INT(1, cache_lookup(cache, word, &distance, &corrections, &correction_num));
+    TEST_ASSERT_EQUAL_INT(i, distance);
+    TEST_ASSERT_EQUAL_PTR(dictionary[i % dictionary_num], corrections[0]);
+  }
+  cache_free(cache);
+}
+
+static void test_cache_evicts_least_recently_used(void){
+  CorrectionCache *cache = cache_build(2);
+  char **corrections;
+  unsigned long correction_num;
+  unsigned distance;
+
+  cache_insert(cache, "uno", 1, NULL, 0);
+  cache_insert(cache, "due", 2, NULL, 0);
+  // "uno" becomes most recently used, so "due" is replaced
+  TEST_ASSERT_EQUAL_INT(1, cache_lookup(cache, "uno", &distance, &corrections, &correction_num));
+  cache_insert(cache, "tre", 3, NULL, 0);
+  TEST_ASSERT_EQUAL_UINT64(2, cache->entry_num);
+  TEST_ASSERT_EQUAL_UINT64(1, cache->evictions);
+  TEST_ASSERT_EQUAL_INT(0, cache_lookup(cache, "due", &distance, &corrections, &correction_num));
+  TEST_ASSERT_EQUAL_INT(1, cache_lookup(cache, "uno", &distance, &corrections, &correction_num));
+  TEST_ASSERT_EQUAL_INT(1, distance);
+  TEST_ASSERT_EQUAL_INT(1, cache_lookup(cache, "tre", &distance, &corrections, &correction_num));
+  TEST_ASSERT_EQUAL_INT(3, distance);
+  cache_free(cache);
+}
+
+static void test_word_set(void){
+  WordSet *set = word_set_build(dictionary, dictionary_num);
+  char *match = NULL;
+
+  TEST_ASSERT_EQUAL_UINT64(6, set->word_num);
+  TEST_ASSERT_EQUAL_UINT64(2, word_set_count(set, "casa", &match));
+  TEST_ASSERT_EQUAL_PTR(dictionary[0], match);
+  TEST_ASSERT_EQUAL_UINT64(1, word_set_count(set, "", &match));
+  TEST_ASSERT_EQUAL_PTR(dictionary[6], match);
+  TEST_ASSERT_EQUAL_UINT64(0, word_set_count(set, "cas", NULL));
+  TEST_ASSERT_EQUAL_UINT64(0, word_set_count(set, "casaa", NULL));
+  word_set_free(set);
+
+  set = word_set_build(NULL, 0);
+  TEST_ASSERT_EQUAL_UINT64(0, word_set_count(set, "casa", NULL));
+  word_set_free(set);
+}
+
+int main(void){
+
+  // test session
+  UNITY_BEGIN();
+  RUN_TEST(test_cache_miss_then_hit);
+  RUN_TEST(test_cache_insert_twice);
+  RUN_TEST(test_cache_grows_unbounded);
+  RUN_TEST(test_cache_evicts_least_recently_used);
+  RUN_TEST(test_word_set);
+
+  return UNITY_END();
+}
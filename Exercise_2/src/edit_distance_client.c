@@ -0,0 +1,195 @@
+/**
+ * @file edit_distance_client.c
+ * @author Daniele Di Palma
+ * @brief Load generator for the correction server: concurrent connections send requests
+ *        of words taken from a text file, latency of every request is measured
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "edit_distance_tokens.h"
+#include "edit_distance_server.h"
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+#define TEXT_DELIM (" .,:\n")
+#define MAX_CONNECTIONS (1024)
+#define USAGE ("Usage: edit_distance_client <socket> <text file> [--connections <n>] [--requests <n>] [--words <n>]\n")
+
+/**
+ * @brief It rappresents a connection of load generator
+ */
+typedef struct _LoadClient{
+  const char *socket_path;
+  const TokenFile *text;      // words of requests
+  unsigned long requests;     // number of requests to send
+  unsigned long words;        // words of every request
+  unsigned seed;              // seed of random words
+  double *latencies;          // latency of every request in seconds
+  unsigned long errors;       // requests without a valid response
+} LoadClient;
+
+static double elapsed(const struct timespec *start_time, const struct timespec *end_time){
+  return (double)(end_time->tv_sec - start_time->tv_sec) + (double)(end_time->tv_nsec - start_time->tv_nsec) / 1e9;
+}
+
+static int compare_latency(const void *l1, const void *l2){
+  double l1_v = *(const double *)l1, l2_v = *(const double *)l2;
+  return (l1_v > l2_v) - (l1_v < l2_v);
+}
+
+/**
+ * @brief Connection thread: it sends a request at a time and waits for its response,
+ *        a response has a line for every word of request
+ *
+ * @param arg     pointer to LoadClient struct
+ * @return void*  NULL
+ */
+static void *run_client(void *arg){
+  LoadClient *client = (LoadClient *)arg;
+  struct timespec start_time, end_time;
+  unsigned long len, lines;
+  char *request = NULL, *response = NULL;
+  const char *word;
+  uint32_t response_len;
+  int fd = server_connect(client->socket_path);
+
+  if(fd < 0){
+    client->errors = client->requests;
+    return NULL;
+  }
+  request = (char *)malloc(SERVER_MAX_FRAME);
+  if(request == NULL){
+    ERROR_EXIT("Unable to allocate request");
+  }
+  for(unsigned long r = 0; r < client->requests; r++){
+    len = 0;
+    for(unsigned long w = 0; w < client->words; w++){
+      word = client->text->word[(unsigned long)rand_r(&client->seed) % client->text->word_num];
+      if(len + strlen(word) + 1 >= SERVER_MAX_FRAME){
+        break;
+      }
+      strcpy(&request[len], word);
+      len += strlen(word);
+      request[len++] = ' ';
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    if(server_send_frame(fd, request, (uint32_t)len) != 0 || (response = server_recv_frame(fd, &response_len)) == NULL){
+      client->errors += client->requests - r;
+      break;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    client->latencies[r] = elapsed(&start_time, &end_time);
+
+    lines = 0;
+    for(uint32_t i = 0; i < response_len; i++){
+      lines += response[i] == '\n';
+    }
+    if(lines != client->words){
+      client->errors++;
+    }
+    free(response);
+  }
+  free(request);
+  close(fd);
+  return NULL;
+}
+
+int main(int argc, char **argv){
+  unsigned long connections = 16, requests = 1000, words = 1, total, measured = 0;
+  struct timespec start_time, end_time;
+  LoadClient *clients = NULL;
+  pthread_t *threads = NULL;
+  double *latencies = NULL, wall_time;
+  unsigned long errors = 0;
+  TokenFile *text = NULL;
+  char *end_p = NULL;
+
+  if(argc < 3){
+    printf(USAGE);
+    exit(EXIT_FAILURE);
+  }
+  for(int i = 3; i < argc; i++){
+    if(i + 1 < argc && (strcmp(argv[i], "--connections") == 0 || strcmp(argv[i], "--requests") == 0 || strcmp(argv[i], "--words") == 0)){
+      unsigned long value = strtoul(argv[i + 1], &end_p, 10);
+      if(*end_p != '\0' || argv[i + 1][0] == '-' || value < 1){
+        printf(USAGE);
+        exit(EXIT_FAILURE);
+      }
+      if(strcmp(argv[i], "--connections") == 0){
+        connections = value < MAX_CONNECTIONS ? value : MAX_CONNECTIONS;
+      }else if(strcmp(argv[i], "--requests") == 0){
+        requests = value;
+      }else{
+        words = value;
+      }
+      i++;
+    }else{
+      printf(USAGE);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  text = token_file_load(argv[2], TEXT_DELIM);
+  if(text->word_num == 0){
+    ERROR_EXIT("No words in text file");
+  }
+  total = connections * requests;
+  clients = (LoadClient *)malloc(connections * sizeof(LoadClient));
+  threads = (pthread_t *)malloc(connections * sizeof(pthread_t));
+  latencies = (double *)calloc(total, sizeof(double));
+  if(clients == NULL || threads == NULL || latencies == NULL){
+    ERROR_EXIT("Unable to allocate clients");
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start_time);
+  for(unsigned long c = 0; c < connections; c++){
+    clients[c].socket_path = argv[1];
+    clients[c].text = text;
+    clients[c].requests = requests;
+    clients[c].words = words;
+    clients[c].seed = (unsigned)c + 1;
+    clients[c].latencies = &latencies[c * requests];
+    clients[c].errors = 0;
+    if(pthread_create(&threads[c], NULL, run_client, &clients[c]) != 0){
+      ERROR_EXIT("Unable to create client");
+    }
+  }
+  for(unsigned long c = 0; c < connections; c++){
+    pthread_join(threads[c], NULL);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end_time);
+  wall_time = elapsed(&start_time, &end_time);
+
+  // latencies of requests with a response (not 0), packed at start
+  for(unsigned long i = 0; i < total; i++){
+    if(latencies[i] > 0.0){
+      latencies[measured++] = latencies[i];
+    }
+  }
+  for(unsigned long c = 0; c < connections; c++){
+    errors += clients[c].errors;
+  }
+  qsort(latencies, measured, sizeof(double), compare_latency);
+
+  printf("%lu connections, %lu requests of %lu words, %lu errors\n", connections, total, words, errors);
+  printf("Throughput: %.0f requests/s, %.0f words/s\n", (double)measured / wall_time, (double)(measured * words) / wall_time);
+  if(measured > 0){
+    printf("Latency: p50 %.3f ms, p99 %.3f ms, max %.3f ms\n", latencies[measured / 2] * 1e3,
+            latencies[(measured * 99) / 100] * 1e3, latencies[measured - 1] * 1e3);
+  }
+
+  free(latencies);
+  free(threads);
+  free(clients);
+  token_file_free(text);
+  exit(errors > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
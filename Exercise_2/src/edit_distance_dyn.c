@@ -1,7 +1,8 @@
 /**
  * @file edit_distance_dyn.c
  * @author Daniele Di Palma
- * @brief Recursive version of edit distance with dynamic programming
+ * @brief Edit distance with dynamic programming: iterative version on a single row
+ *        and recursive version with memoization (reference)
  */
 
 #include <stdio.h>
@@ -15,6 +16,8 @@
                         __LINE__);                                  \
                       exit(EXIT_FAILURE);}
 
+#define STACK_ROW_SIZE (128)
+
 /**
  * @brief Calculate edit distance between two strings. 
  *				Determines minimum number of operation 
@@ -162,10 +165,51 @@ static void free_memoization(unsigned **memoization, unsigned n_row){
   free(memoization);
 }
 
+/**
+ * @brief Calculate edit distance between two strings with iterative dynamic programming
+ *        on a single row of the table, long as the shortest string.
+ *        Cell (i, j) holds distance between first i chars of longest string and first j chars of shortest one:
+ *        if chars are equal it takes value of diagonal cell (i-1, j-1), stored in a register before
+ *        being overwritten, otherwise 1 + minimum between upper cell (deletion) and left cell (insertion).
+ * 
+ * @param longest       longest string
+ * @param shortest      shortest string
+ * @param long_len      length of longest string
+ * @param short_len     length of shortest string
+ * @param row           memory area for short_len + 1 cells
+ * @return unsigned number of operation
+ */
+static unsigned edit_distance_row(const char *longest, const char *shortest, unsigned long long_len, unsigned long short_len, unsigned *row){
+  unsigned diagonal, upper;
+
+  for(unsigned long j = 0; j <= short_len; j++){
+    row[j] = (unsigned)j;
+  }
+
+  for(unsigned long i = 1; i <= long_len; i++){
+    diagonal = row[0];
+    row[0] = (unsigned)i;
+    for(unsigned long j = 1; j <= short_len; j++){
+      upper = row[j];
+      if(longest[i-1] == shortest[j-1]){
+        row[j] = diagonal;
+      }else{
+        row[j] = 1 + (upper < row[j-1] ? upper : row[j-1]);
+      }
+      diagonal = upper;
+    }
+  }
+
+  return row[short_len];
+}
+
 /**
  * @brief Calculate edit distance between two strings. 
  *				Determines minimum number of operation 
  *				to transform @param s2 into @param s1.
+ *        Only insertions and deletions are allowed.
+ *        Iterative version: O(len(s1) * len(s2)) time and O(min(len(s1), len(s2))) memory,
+ *        no allocation for strings shorter than STACK_ROW_SIZE.
  *        If passed string are (or just one is) NULL, program will terminate.
  *        If string lengths are greater than UINT_MAX-1, program will terminate.
  * 
@@ -174,6 +218,178 @@ static void free_memoization(unsigned **memoization, unsigned n_row){
  * @return unsigned number of operation
  */
 unsigned edit_distance_dyn(char *s1, char *s2){
+  unsigned stack_row[STACK_ROW_SIZE];
+  unsigned *row = stack_row;
+  unsigned long s1_len, s2_len;
+  unsigned result;
+
+  if(s1 == NULL){
+    ERROR_EXIT("First string is NULL");
+  }
+  if(s2 == NULL){
+    ERROR_EXIT("Second string is NULL");
+  }
+
+  s1_len = strlen(s1);
+  s2_len = strlen(s2);
+
+  if(s1_len >= UINT_MAX){
+    ERROR_EXIT("First string too long");
+  }
+  if(s2_len >= UINT_MAX){
+    ERROR_EXIT("Second string too long");
+  }
+
+  if(s1_len < s2_len){
+    char *s_tmp = s1;
+    unsigned long len_tmp = s1_len;
+    s1 = s2;
+    s1_len = s2_len;
+    s2 = s_tmp;
+    s2_len = len_tmp;
+  }
+
+  if(s2_len >= STACK_ROW_SIZE){
+    row = (unsigned *)malloc((s2_len + 1) * sizeof(unsigned));
+    if(row == NULL){
+      ERROR_EXIT("Unable to allocate memory for row");
+    }
+  }
+
+  result = edit_distance_row(s1, s2, s1_len, s2_len, row);
+
+  if(row != stack_row){
+    free(row);
+  }
+  return result;
+}
+
+/**
+ * @brief Calculate edit distance between two strings if it is not greater than bound.
+ *        Only cells of the diagonal band |i - j| <= bound are computed (Ukkonen), others are
+ *        considered greater than bound. Computation stops as soon as every cell of a row,
+ *        plus the length difference of the remaining suffixes, is greater than bound.
+ *        If length difference is greater than bound it returns immediately.
+ *        If passed string are (or just one is) NULL, program will terminate.
+ * 
+ * @param s1      first string, can't be NULL
+ * @param s2      second string, can't be NULL
+ * @param bound   maximum distance of interest
+ * @return unsigned number of operation if it is <= bound, bound + 1 otherwise
+ */
+unsigned edit_distance_bounded(char *s1, char *s2, unsigned bound){
+  unsigned stack_row[STACK_ROW_SIZE];
+  unsigned *row = stack_row;
+  unsigned long s1_len, s2_len, lo, hi, rest;
+  unsigned over, diagonal, upper, left, row_min, cell_min;
+
+  if(s1 == NULL){
+    ERROR_EXIT("First string is NULL");
+  }
+  if(s2 == NULL){
+    ERROR_EXIT("Second string is NULL");
+  }
+
+  s1_len = strlen(s1);
+  s2_len = strlen(s2);
+
+  if(s1_len < s2_len){
+    char *s_tmp = s1;
+    unsigned long len_tmp = s1_len;
+    s1 = s2;
+    s1_len = s2_len;
+    s2 = s_tmp;
+    s2_len = len_tmp;
+  }
+
+  // distance is at least the length difference
+  if(s1_len - s2_len > bound){
+    return bound + 1;
+  }
+  // distance is at most the sum of lengths, band covers the whole table
+  if(s1_len + s2_len <= bound){
+    return edit_distance_dyn(s1, s2);
+  }
+  over = bound + 1;
+
+  if(s2_len >= STACK_ROW_SIZE){
+    row = (unsigned *)malloc((s2_len + 1) * sizeof(unsigned));
+    if(row == NULL){
+      ERROR_EXIT("Unable to allocate memory for row");
+    }
+  }
+
+  for(unsigned long j = 0; j <= s2_len; j++){
+    row[j] = (j <= bound) ? (unsigned)j : over;
+  }
+
+  for(unsigned long i = 1; i <= s1_len; i++){
+    lo = (i > bound) ? i - bound : 1;
+    hi = (i + bound < s2_len) ? i + bound : s2_len;
+
+    // cell (i, lo-1) is left of the band, unless it is the first column
+    diagonal = row[lo-1];
+    left = (lo == 1 && i <= bound) ? (unsigned)i : over;
+    if(lo == 1){
+      row[0] = left;
+    }
+    // cell (i-1, hi) was right of the previous band
+    if(hi == i + bound){
+      row[hi] = over;
+    }
+
+    rest = s1_len - i;
+    row_min = over;
+    if(lo == 1){
+      row_min = left + (unsigned)(rest > s2_len ? rest - s2_len : s2_len - rest);
+    }
+    for(unsigned long j = lo; j <= hi; j++){
+      upper = row[j];
+      if(s1[i-1] == s2[j-1]){
+        left = diagonal;
+      }else{
+        left = 1 + (upper < left ? upper : left);
+        if(left > over){
+          left = over;
+        }
+      }
+      row[j] = left;
+      diagonal = upper;
+
+      // lower bound of final distance passing through this cell
+      cell_min = left + (unsigned)(rest > s2_len - j ? rest - (s2_len - j) : (s2_len - j) - rest);
+      if(cell_min < row_min){
+        row_min = cell_min;
+      }
+    }
+
+    if(row_min > bound){
+      if(row != stack_row){
+        free(row);
+      }
+      return over;
+    }
+  }
+
+  left = row[s2_len];
+  if(row != stack_row){
+    free(row);
+  }
+  return left > bound ? over : left;
+}
+
+/**
+ * @brief Calculate edit distance between two strings with recursive memoization. 
+ *				Determines minimum number of operation 
+ *				to transform @param s2 into @param s1.
+ *        If passed string are (or just one is) NULL, program will terminate.
+ *        If string lengths are greater than UINT_MAX-1, program will terminate.
+ * 
+ * @param s1  first string, can't be NULL
+ * @param s2  second string, can't be NULL
+ * @return unsigned number of operation
+ */
+unsigned edit_distance_dyn_memo(char *s1, char *s2){
   unsigned **memoization = NULL;
   unsigned s1_len, s2_len;
 
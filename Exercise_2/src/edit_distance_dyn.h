@@ -5,6 +5,8 @@
  * @brief Calculate edit distance between two strings. 
  *		    Determines minimum number of operation 
  *				to transform @param s2 into @param s1.
+ *        Only insertions and deletions are allowed.
+ *        Iterative on a single row: O(len(s1) * len(s2)) time, O(min(len(s1), len(s2))) memory.
  * 
  * @param s1  first string, can't be NULL
  * @param s2  second string, can't be NULL
@@ -12,4 +14,28 @@
  */
 unsigned edit_distance_dyn(char *s1, char *s2);
 
+/**
+ * @brief Calculate edit distance between two strings if it is not greater than bound.
+ *        Rejects immediately strings whose length difference is greater than bound,
+ *        otherwise computes only a diagonal band of width 2 * bound + 1 of the table
+ *        and stops as soon as a whole row exceeds bound: O(bound * len) time.
+ * 
+ * @param s1      first string, can't be NULL
+ * @param s2      second string, can't be NULL
+ * @param bound   maximum distance of interest
+ * @return unsigned number of operation if it is <= bound, bound + 1 otherwise
+ */
+unsigned edit_distance_bounded(char *s1, char *s2, unsigned bound);
+
+/**
+ * @brief Calculate edit distance between two strings with recursive memoization
+ *        on a full table. Reference implementation of edit_distance_dyn, 
+ *        it needs O(len(s1) * len(s2)) memory and recursion depth up to len(s1) + len(s2).
+ * 
+ * @param s1  first string, can't be NULL
+ * @param s2  second string, can't be NULL
+ * @return unsigned number of operation
+ */
+unsigned edit_distance_dyn_memo(char *s1, char *s2);
+
 #endif
\ No newline at end of file
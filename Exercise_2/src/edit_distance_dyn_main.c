@@ -11,17 +11,55 @@
 #include <string.h>
 #include <limits.h>
 #include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <signal.h>
 #include "edit_distance_dyn.h"
+#include "edit_distance_query.h"
+#include "edit_distance_bktree.h"
+#include "edit_distance_symspell.h"
+#include "edit_distance_trie.h"
+#include "edit_distance_packed.h"
+#include "edit_distance_cache.h"
+#include "edit_distance_batch.h"
+#include "edit_distance_simd.h"
+#include "edit_distance_tokens.h"
+#include "edit_distance_server.h"
+#include "edit_distance_stream.h"
 
 #define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
                         __FILE__,                                   \
                         __LINE__);                                  \
                       exit(EXIT_FAILURE);}
 
-#define BUFFER_SIZE (1024)
 #define INITIAL_CAPACITY (2)
 #define USER_FILE_DELIM (" .,:\n")
 #define DICTIONARY_DELIM (" \n")
+#define BKTREE_MAX_DISTANCE (3)
+#define SYMSPELL_MAX_DEPTH (2)
+#define SYMSPELL_PREFIX_LEN (7)
+#define MAX_THREADS (256)
+#define PROGRESS_INTERVAL_NS (10 * 1000 * 1000)  // progress of workers is checked every 10 ms
+#define SERVER_MAX_BATCH (64)         // max requests corrected by a server worker at a time
+#define SERVER_CACHE_SIZE (100000)    // default max words in cache of server
+#define STREAM_CACHE_SIZE (100000)    // default max words in cache of stream mode
+#define USAGE ("Usage: dyn_edit_distance_main <file to be correct> <dictionary> [--linear | --bktree | --symspell | --trie | --packed | --batch]\n" \
+               "       [--threads <n>] [--cache-size <max words> | --no-cache]\n" \
+               "       search mode is --packed if not given\n" \
+               "       dyn_edit_distance_main --serve <socket> <dictionary> [options as above]\n" \
+               "       dyn_edit_distance_main --stream <file to be correct | -> <dictionary> [options as above]\n" \
+               "       dyn_edit_distance_main --compile-dict <dictionary> <dictionary image>\n")
+
+// search modes of corrections
+#define MODE_LINEAR (0)
+#define MODE_BKTREE (1)
+#define MODE_SYMSPELL (2)
+#define MODE_TRIE (3)
+#define MODE_PACKED (4)
+#define MODE_BATCH (5)
 
 
 /**
@@ -62,74 +100,78 @@ typedef struct _ArrayCorrections{
  */
 typedef struct _ArrayWords{
   char **word;
-  unsigned array_capacity;
   unsigned el_num;
+  TokenFile *tokens;  // loaded file, words are stored in its arena, NULL if words are in a dictionary image
 }ArrayWords;
 
 /**
- * @brief This function read passed file, parse it with given delimiters 
- *        and load it in ArrayWords structure.
+ * @brief This function loads a file in an ArrayWords structure: file is parsed with given
+ *        delimiters and all its words are stored in a single arena, lines of any length
+ *        are supported.
  * 
  * @param file_path     file where operate
- * @param array_words   pointer to structure where parsed data will be insert
  * @param delimiters    delimiters to use for correcting parse the file
+ * @return ArrayWords*  address to loaded ArrayWords struct
  */
-static void load_file(const char *file_path, ArrayWords *array_words, char *delimiters){
-  FILE *fp = NULL;
-  char buffer[BUFFER_SIZE];
-  char *read_line_p = NULL;
+static ArrayWords* load_file(const char *file_path, char *delimiters){
+  ArrayWords *arraywords = NULL;
+  struct timespec start_time, end_time;
 
-  fp = fopen(file_path,"r");
-  if(fp == NULL){
-    ERROR_EXIT("unable to open the file");
+  arraywords = (ArrayWords *)malloc(sizeof(ArrayWords));
+  if(arraywords == NULL){
+    ERROR_EXIT("Unable to allocate ArrayWords structure");
   }
 
-  while(fgets(buffer, BUFFER_SIZE, fp) != NULL){
-    read_line_p = (char *)malloc(strlen(buffer)+1 * sizeof(char));
-    if(read_line_p == NULL){
-      ERROR_EXIT("unable to allocate memory for the read line");
-    }
-    strcpy(read_line_p, buffer);
-    char *parsed_string = strtok(read_line_p, delimiters);
-    
-    while(parsed_string != NULL){
-      if(array_words->array_capacity <= array_words->el_num){
-        array_words->word = realloc(array_words->word, ((array_words->array_capacity*2)*sizeof(char *)));
-        array_words->array_capacity = array_words->array_capacity * 2;
-      }
-
-      array_words->word[array_words->el_num] = (char *)malloc(strlen(parsed_string)+1 * sizeof(char));
-      strcpy(array_words->word[array_words->el_num], parsed_string);
-
-      array_words->el_num++;
-      parsed_string = strtok(NULL, delimiters);
-    }
-    free(read_line_p);
+  clock_gettime(CLOCK_MONOTONIC, &start_time);
+  arraywords->tokens = token_file_load(file_path, delimiters);
+  clock_gettime(CLOCK_MONOTONIC, &end_time);
+  if(arraywords->tokens->word_num > UINT_MAX){
+    ERROR_EXIT("Too many words in the file");
   }
+  arraywords->word = arraywords->tokens->word;
+  arraywords->el_num = (unsigned)arraywords->tokens->word_num;
 
-  fclose(fp);
-  printf("Loaded\n");
+  printf("Loaded %u words in %f sec\n", arraywords->el_num,
+          (double)(end_time.tv_sec - start_time.tv_sec) + (double)(end_time.tv_nsec - start_time.tv_nsec) / 1e9);
+  return arraywords;
 }
 
 /**
- * @brief This function allocate and initialize a given pointer to ArrayWords struct
+ * @brief This function maps a dictionary image written by --compile-dict.
+ *        MODE_PACKED and MODE_BATCH use the image as it is, other modes build their index
+ *        from dictionary words, which point into the image.
  * 
- * @param arraywords    struct that will be allocated and inizialized
- * @return ArrayWords*  address to initialized ArrayWords struct
+ * @param image_path    dictionary image
+ * @param mode          search mode
+ * @param packed        address where mapped dictionary is stored
+ * @return ArrayWords*  address to ArrayWords struct of dictionary words, NULL in MODE_PACKED and MODE_BATCH
  */
-static ArrayWords* init_structure_arraywords(ArrayWords *arraywords){
+static ArrayWords* map_dictionary_image(const char *image_path, int mode, PackedDictionary **packed){
+  ArrayWords *arraywords = NULL;
+  struct timespec start_time, end_time;
+
+  clock_gettime(CLOCK_MONOTONIC, &start_time);
+  *packed = packed_dictionary_map(image_path);
+  clock_gettime(CLOCK_MONOTONIC, &end_time);
+  printf("Mapped %lu words in %f sec\n", (*packed)->word_num,
+          (double)(end_time.tv_sec - start_time.tv_sec) + (double)(end_time.tv_nsec - start_time.tv_nsec) / 1e9);
+  if(mode == MODE_PACKED || mode == MODE_BATCH){
+    return NULL;
+  }
+
   arraywords = (ArrayWords *)malloc(sizeof(ArrayWords));
   if(arraywords == NULL){
     ERROR_EXIT("Unable to allocate ArrayWords structure");
   }
-
-  arraywords->word = (char **)malloc(INITIAL_CAPACITY * sizeof(char *));
-  if(arraywords == NULL){
+  arraywords->word = (char **)malloc(((*packed)->word_num > 0 ? (*packed)->word_num : 1) * sizeof(char *));
+  if(arraywords->word == NULL){
     ERROR_EXIT("Unable to allocate word array of pointers");
   }
-  arraywords->el_num = 0;
-  arraywords->array_capacity = INITIAL_CAPACITY;
-
+  for(unsigned long i = 0; i < (*packed)->word_num; i++){
+    arraywords->word[i] = packed_dictionary_word(*packed, i);
+  }
+  arraywords->el_num = (unsigned)(*packed)->word_num;
+  arraywords->tokens = NULL;
   return arraywords;
 }
 
@@ -173,10 +215,11 @@ static ArrayCorrections* init_array_corrections(ArrayCorrections *array_correcti
  * @param arraywords  pointer to ArrayWords structure that will be de-allocate
  */
 static void free_structure_arraywords(ArrayWords *arraywords){
-  for(register unsigned i = 0; i < arraywords->el_num; i++){
-    free(arraywords->word[i]);
+  if(arraywords->tokens != NULL){
+    token_file_free(arraywords->tokens);
+  }else{
+    free(arraywords->word);
   }
-  free(arraywords->word);
   free(arraywords);
 }
 
@@ -195,72 +238,411 @@ static void free_array_corrections(ArrayCorrections *array_corrections){
 }
 
 /**
- * @brief This function compute corrections for user file, and save corrections in a struct.
- *        Used for compute correctionts of (correctme.txt).
+ * @brief This function reserves the corrections of all words of user file,
+ *        so array of corrections is never reallocated while words are corrected.
  * 
+ * @param array_corrections   pointer to ArrayCorrections struct
  * @param user_file           pointer to ArrayWords struct where user file words are stored
- * @param dictionary          pointer to ArrayWords struct where dictionary words are stored
- * @param array_corrections   pointer to ArrayCorrections struct where corrections of all words will be stored
- * @return double             total time spent for compute all corrections
  */
-static double compute_corrections(ArrayWords *user_file, ArrayWords *dictionary, ArrayCorrections *array_corrections){
-  clock_t start_time = 0;
-  double total_time = 0;
-  unsigned result_ed, act_dim, index;
-
-  for(register unsigned i = 0; i < user_file->el_num; i++){
+static void reserve_array_corrections(ArrayCorrections *array_corrections, ArrayWords *user_file){
+  unsigned new_capacity = array_corrections->array_capacity;
 
-    if(array_corrections->num_el >= array_corrections->array_capacity){
-      array_corrections->array = (struct WordCorrections *)realloc(array_corrections->array, (sizeof(struct WordCorrections) *array_corrections->array_capacity*2));
-      if(array_corrections->array == NULL){
-        ERROR_EXIT("Unable to re-allocate array");
-      }
-      for(register unsigned k = array_corrections->array_capacity; k < array_corrections->array_capacity*2; ++k){
-        
-        array_corrections->array[k].min_ed = UINT_MAX;
-        array_corrections->array[k].array_corrections_word = (struct Correction *)malloc(INITIAL_CAPACITY * sizeof(struct Correction));
-        if(array_corrections->array[k].array_corrections_word == NULL){
-          ERROR_EXIT("Unable to re-allocate array corrections word");
-        }
-        array_corrections->array[k].capacity_array_corrections = INITIAL_CAPACITY;
-        array_corrections->array[k].num_corrections = 0;
-        array_corrections->array[k].word = NULL;
+  while(new_capacity < user_file->el_num){
+    new_capacity *= 2;
+  }
+  if(new_capacity > array_corrections->array_capacity){
+    array_corrections->array = (struct WordCorrections *)realloc(array_corrections->array, (sizeof(struct WordCorrections) * new_capacity));
+    if(array_corrections->array == NULL){
+      ERROR_EXIT("Unable to re-allocate array");
+    }
+    for(register unsigned k = array_corrections->array_capacity; k < new_capacity; ++k){
+      
+      array_corrections->array[k].min_ed = UINT_MAX;
+      array_corrections->array[k].array_corrections_word = (struct Correction *)malloc(INITIAL_CAPACITY * sizeof(struct Correction));
+      if(array_corrections->array[k].array_corrections_word == NULL){
+        ERROR_EXIT("Unable to re-allocate array corrections word");
       }
-      array_corrections->array_capacity *= 2;
+      array_corrections->array[k].capacity_array_corrections = INITIAL_CAPACITY;
+      array_corrections->array[k].num_corrections = 0;
+      array_corrections->array[k].word = NULL;
     }
-    
+    array_corrections->array_capacity = new_capacity;
+  }
+
+  for(register unsigned i = 0; i < user_file->el_num; i++){
     array_corrections->array[i].word = user_file->word[i];
+  }
+  array_corrections->num_el = user_file->el_num;
+}
+
+/**
+ * @brief This function appends a correction to corrections of a word and updates min edit distance.
+ * 
+ * @param word_corrections    pointer to corrections of a word
+ * @param correction          dictionary word
+ * @param result_ed           edit distance of correction, not greater than min edit distance
+ */
+static void append_correction(struct WordCorrections *word_corrections, char *correction, unsigned result_ed){
+  unsigned act_dim, index;
+
+  if(word_corrections->num_corrections >= word_corrections->capacity_array_corrections){
+    act_dim = word_corrections->capacity_array_corrections;
+    word_corrections->array_corrections_word = realloc(word_corrections->array_corrections_word, ((act_dim*2)*sizeof(struct Correction)));
+    if(word_corrections->array_corrections_word == NULL){
+      ERROR_EXIT("Unable to re-allocate array corrections word");
+    }
+    word_corrections->capacity_array_corrections *= 2;
+  }
+  
+  word_corrections->min_ed = result_ed;
+  index = word_corrections->num_corrections;
+  word_corrections->array_corrections_word[index].correction = correction;
+  
+  word_corrections->array_corrections_word[index].edit_distance = result_ed;
+  word_corrections->num_corrections++;
+}
+
+/**
+ * @brief This function compares a word with all dictionary words and stores corrections
+ *        at distance not greater than min edit distance found so far.
+ * 
+ * @param word_corrections    pointer to corrections of word
+ * @param dictionary          pointer to ArrayWords struct where dictionary words are stored
+ */
+static void scan_dictionary(struct WordCorrections *word_corrections, ArrayWords *dictionary){
+  unsigned result_ed;
+  EdQuery *query = ed_query_build(word_corrections->word);
+
+  for(register unsigned j = 0; j < dictionary->el_num; j++){
+
+    result_ed = ed_query_distance(query, dictionary->word[j], word_corrections->min_ed);
+
+    if(result_ed <= word_corrections->min_ed){
+      append_correction(word_corrections, dictionary->word[j], result_ed);
+    }
+  }
+  ed_query_free(query);
+}
+
+/**
+ * @brief It rappresents the dictionary and the index used for corrections, they are only read
+ *        while words are corrected so they are shared by all threads.
+ * 
+ */
+typedef struct _Corrector{
+  int mode;                     // search mode
+  ArrayWords *dictionary;       // dictionary words, NULL in MODE_PACKED and MODE_BATCH
+  BkTree *tree;                 // index in MODE_BKTREE
+  SymSpellIndex *symspell;      // index in MODE_SYMSPELL
+  Trie *trie;                   // index in MODE_TRIE
+  PackedDictionary *packed;     // dictionary in MODE_PACKED and MODE_BATCH
+  WordSet *dictionary_set;      // distinct dictionary words, NULL if not used
+}Corrector;
+
+/**
+ * @brief It rappresents the correction of user file shared by worker threads:
+ *        every thread takes the index of next word to correct from an atomic counter,
+ *        so every WordCorrections is written by only one thread.
+ * 
+ */
+typedef struct _CorrectionTask{
+  const Corrector *corrector;
+  ArrayWords *user_file;
+  ArrayCorrections *array_corrections;
+  atomic_uint next_word;          // next word to correct
+  atomic_uint done_words;         // number of corrected words, progress is printed by main thread
+  CorrectionCache *cache;         // corrections of already corrected words, NULL if not used
+  pthread_mutex_t cache_lock;     // serializes cache access
+  atomic_ulong dictionary_hits;   // words found in dictionary
+}CorrectionTask;
+
+/**
+ * @brief This function builds the index of dictionary used by mode.
+ *        In MODE_PACKED and MODE_BATCH dictionary is packed and loaded words are freed,
+ *        unless a mapped dictionary image is given.
+ * 
+ * @param corrector     pointer to Corrector struct to initialize
+ * @param dictionary    pointer to ArrayWords struct where dictionary words are stored,
+ *                      NULL in MODE_PACKED and MODE_BATCH with a dictionary image
+ * @param packed        mapped dictionary image, owned by corrector, NULL if dictionary was loaded
+ * @param mode          search mode
+ */
+static void build_corrector(Corrector *corrector, ArrayWords *dictionary, PackedDictionary *packed, int mode){
+  clock_t start_time = clock();
+
+  corrector->mode = mode;
+  corrector->dictionary = dictionary;
+  corrector->tree = NULL;
+  corrector->symspell = NULL;
+  corrector->trie = NULL;
+  corrector->packed = packed;
+  corrector->dictionary_set = NULL;
+
+  if(mode == MODE_BKTREE){
+    corrector->tree = bktree_build(dictionary->word, dictionary->el_num);
+    printf("BK-tree built in %f sec\n", (double)(clock() - start_time)/CLOCKS_PER_SEC);
+  }else if(mode == MODE_SYMSPELL){
+    corrector->symspell = symspell_build(dictionary->word, dictionary->el_num, SYMSPELL_MAX_DEPTH, SYMSPELL_PREFIX_LEN);
+    printf("SymSpell index built in %f sec, %lu variants, %.1f MB\n", (double)(clock() - start_time)/CLOCKS_PER_SEC,
+            corrector->symspell->key_num, (double)symspell_size(corrector->symspell) / (1024 * 1024));
+  }else if(mode == MODE_TRIE){
+    corrector->trie = trie_build(dictionary->word, dictionary->el_num);
+    printf("Trie built in %f sec, %lu nodes\n", (double)(clock() - start_time)/CLOCKS_PER_SEC, corrector->trie->node_num);
+  }else if((mode == MODE_PACKED || mode == MODE_BATCH) && packed == NULL){
+    // packed dictionary replaces loaded words
+    corrector->packed = packed_dictionary_build(dictionary->word, dictionary->el_num);
+    printf("Packed in %f sec, %.1f MB\n", (double)(clock() - start_time)/CLOCKS_PER_SEC, (double)packed_dictionary_size(corrector->packed) / (1024 * 1024));
+    free_structure_arraywords(dictionary);
+    corrector->dictionary = NULL;
+  }
+  if(mode == MODE_BATCH){
+    printf("Batch kernel: %s, %d candidates at a time\n", edit_distance_simd_kernel_name(edit_distance_simd_kernel()), BATCH_LANES);
+  }
+}
 
-    for(register unsigned j = 0; j < dictionary->el_num; j++){
-
-      start_time = clock();
-      result_ed = edit_distance_dyn(dictionary->word[j], user_file->word[i]);
-      total_time += (double)(clock() - start_time)/CLOCKS_PER_SEC;
-
-      if(result_ed <= array_corrections->array[i].min_ed){
-        if(array_corrections->array[i].num_corrections >= array_corrections->array[i].capacity_array_corrections){
-          act_dim = array_corrections->array[i].capacity_array_corrections;
-          array_corrections->array[i].array_corrections_word = realloc(array_corrections->array[i].array_corrections_word, ((act_dim*2)*sizeof(struct Correction)));
-          if(array_corrections->array[i].array_corrections_word == NULL){
-            ERROR_EXIT("Unable to re-allocate array corrections word");
-          }
-          array_corrections->array[i].capacity_array_corrections *= 2;
-        }
-        
-        array_corrections->array[i].min_ed = result_ed;
-        index = array_corrections->array[i].num_corrections;
-        array_corrections->array[i].array_corrections_word[index].correction = dictionary->word[j];
-        
-        array_corrections->array[i].array_corrections_word[index].edit_distance = result_ed;
-        array_corrections->array[i].num_corrections++;
+/**
+ * @brief This function builds the set of dictionary words of a Corrector,
+ *        words of set are the ones used as corrections by mode.
+ *        Packed search finds dictionary words in their own length bucket, signature
+ *        filter skips almost every other word once distance 0 is found, so
+ *        MODE_PACKED and MODE_BATCH don't hash the whole dictionary at start.
+ * 
+ * @param corrector     pointer to Corrector struct
+ */
+static void build_dictionary_set(Corrector *corrector){
+  if(corrector->mode == MODE_PACKED || corrector->mode == MODE_BATCH){
+    return;
+  }
+  corrector->dictionary_set = word_set_build(corrector->dictionary->word, corrector->dictionary->el_num);
+}
+
+/**
+ * @brief This function de-allocate dictionary and index of a Corrector
+ * 
+ * @param corrector   pointer to Corrector struct
+ */
+static void free_corrector(Corrector *corrector){
+  if(corrector->dictionary != NULL){
+    free_structure_arraywords(corrector->dictionary);
+  }
+  bktree_free(corrector->tree);
+  symspell_free(corrector->symspell);
+  trie_free(corrector->trie);
+  packed_dictionary_free(corrector->packed);
+  word_set_free(corrector->dictionary_set);
+}
+
+/**
+ * @brief This function compute corrections of a word, only words at minimum edit distance are stored.
+ *        MODE_LINEAR compares word with all dictionary words. Search in BK-tree visits most
+ *        of the nodes for large distances and SymSpell index only covers SYMSPELL_MAX_DEPTH,
+ *        so in these modes words without closer corrections are compared with all dictionary words.
+ * 
+ * @param corrector           pointer to Corrector struct
+ * @param word_corrections    pointer to corrections of word
+ */
+static void correct_word(const Corrector *corrector, struct WordCorrections *word_corrections){
+  unsigned result_ed;
+  unsigned long *found = NULL, found_num = 0;
+
+  if(corrector->mode == MODE_LINEAR){
+    scan_dictionary(word_corrections, corrector->dictionary);
+    return;
+  }
+
+  if(corrector->mode == MODE_BKTREE){
+    result_ed = bktree_search_min(corrector->tree, word_corrections->word, BKTREE_MAX_DISTANCE, &found, &found_num);
+  }else if(corrector->mode == MODE_SYMSPELL){
+    result_ed = symspell_search_min(corrector->symspell, word_corrections->word, &found, &found_num);
+  }else if(corrector->mode == MODE_TRIE){
+    result_ed = trie_search_min(corrector->trie, word_corrections->word, UINT_MAX, &found, &found_num);
+  }else if(corrector->mode == MODE_PACKED){
+    result_ed = packed_search_min(corrector->packed, word_corrections->word, UINT_MAX, &found, &found_num);
+  }else{
+    result_ed = batch_search_min(corrector->packed, word_corrections->word, UINT_MAX, &found, &found_num);
+  }
+
+  for(unsigned long j = 0; j < found_num; j++){
+    if(corrector->packed != NULL){
+      append_correction(word_corrections, packed_dictionary_word(corrector->packed, found[j]), result_ed);
+    }else{
+      append_correction(word_corrections, corrector->dictionary->word[found[j]], result_ed);
+    }
+  }
+  free(found);
+
+  if(found_num == 0 && (corrector->mode == MODE_BKTREE || corrector->mode == MODE_SYMSPELL)){
+    scan_dictionary(word_corrections, corrector->dictionary);
+  }
+}
+
+/**
+ * @brief This function compute corrections of a word reusing results of previous words:
+ *        a dictionary word is its only correction (with all its copies), otherwise
+ *        corrections are taken from cache or computed and inserted in cache.
+ * 
+ * @param task                pointer to CorrectionTask struct
+ * @param word_corrections    pointer to corrections of word
+ */
+static void correct_word_cached(CorrectionTask *task, struct WordCorrections *word_corrections){
+  char *match = NULL, **corrections = NULL;
+  unsigned long count, correction_num = 0;
+  unsigned distance;
+  int hit;
+
+  if(task->corrector->dictionary_set != NULL){
+    count = word_set_count(task->corrector->dictionary_set, word_corrections->word, &match);
+    if(count > 0){
+      for(unsigned long k = 0; k < count; k++){
+        append_correction(word_corrections, match, 0);
       }
+      atomic_fetch_add(&task->dictionary_hits, 1);
+      return;
+    }
+  }
+  if(task->cache == NULL){
+    correct_word(task->corrector, word_corrections);
+    return;
+  }
+
+  // cached corrections are copied before unlock, entry could be replaced by another thread
+  pthread_mutex_lock(&task->cache_lock);
+  hit = cache_lookup(task->cache, word_corrections->word, &distance, &corrections, &correction_num);
+  if(hit){
+    word_corrections->min_ed = distance;
+    for(unsigned long k = 0; k < correction_num; k++){
+      append_correction(word_corrections, corrections[k], distance);
+    }
+  }
+  pthread_mutex_unlock(&task->cache_lock);
+  if(hit){
+    return;
+  }
+
+  correct_word(task->corrector, word_corrections);
+
+  corrections = (char **)malloc((word_corrections->num_corrections > 0 ? word_corrections->num_corrections : 1) * sizeof(char *));
+  if(corrections == NULL){
+    ERROR_EXIT("Unable to allocate corrections");
+  }
+  correction_num = 0;
+  for(unsigned k = 0; k < word_corrections->num_corrections; k++){
+    if(word_corrections->array_corrections_word[k].edit_distance == word_corrections->min_ed){
+      corrections[correction_num++] = word_corrections->array_corrections_word[k].correction;
+    }
+  }
+  pthread_mutex_lock(&task->cache_lock);
+  cache_insert(task->cache, word_corrections->word, word_corrections->min_ed, corrections, correction_num);
+  pthread_mutex_unlock(&task->cache_lock);
+  free(corrections);
+}
+
+/**
+ * @brief Worker thread: it corrects words until all words are taken
+ * 
+ * @param arg     pointer to CorrectionTask struct
+ * @return void*  NULL
+ */
+static void *correction_worker(void *arg){
+  CorrectionTask *task = (CorrectionTask *)arg;
+  unsigned i;
+
+  while((i = atomic_fetch_add(&task->next_word, 1)) < task->user_file->el_num){
+    correct_word_cached(task, &task->array_corrections->array[i]);
+    atomic_fetch_add_explicit(&task->done_words, 1, memory_order_relaxed);
+  }
+  return NULL;
+}
+
+/**
+ * @brief This function prints progress of workers every time it grows by a whole percent,
+ *        until all words are corrected. Workers only count corrected words, so they never
+ *        wait for each other or for the terminal.
+ * 
+ * @param task    pointer to CorrectionTask struct being corrected
+ */
+static void print_progress(CorrectionTask *task){
+  const struct timespec interval = {0, PROGRESS_INTERVAL_NS};
+  unsigned long word_num = task->user_file->el_num, done, percent, printed = ULONG_MAX;
+
+  if(word_num == 0){
+    return;
+  }
+  while(1){
+    done = atomic_load_explicit(&task->done_words, memory_order_relaxed);
+    percent = done * 100 / word_num;
+    if(percent != printed){
+      printf("\r%lu%%", percent);
+      printed = percent;
+    }
+    if(done >= word_num){
+      return;
+    }
+    nanosleep(&interval, NULL);
+  }
+}
+
+/**
+ * @brief This function compute corrections for user file, and save corrections in a struct.
+ *        Used for compute correctionts of (correctme.txt).
+ *        Words are corrected in parallel by thread_num threads, corrections of every word
+ *        are stored in its own slot so results don't depend on scheduling.
+ * 
+ * @param user_file           pointer to ArrayWords struct where user file words are stored
+ * @param corrector           pointer to Corrector struct with dictionary and its index
+ * @param array_corrections   pointer to ArrayCorrections struct where corrections of all words will be stored
+ * @param cache               pointer to CorrectionCache struct where corrections of distinct words are stored,
+ *                            NULL for correct every word
+ * @param thread_num          number of worker threads
+ * @return double             elapsed (wall clock) time spent for compute all corrections
+ */
+static double compute_corrections(ArrayWords *user_file, const Corrector *corrector, ArrayCorrections *array_corrections, CorrectionCache *cache, unsigned thread_num){
+  struct timespec start_time, end_time;
+  pthread_t *threads = NULL;
+  CorrectionTask task;
+
+  reserve_array_corrections(array_corrections, user_file);
+
+  task.corrector = corrector;
+  task.user_file = user_file;
+  task.array_corrections = array_corrections;
+  atomic_init(&task.next_word, 0);
+  atomic_init(&task.done_words, 0);
+  task.cache = cache;
+  atomic_init(&task.dictionary_hits, 0);
+  if(pthread_mutex_init(&task.cache_lock, NULL) != 0){
+    ERROR_EXIT("Unable to initialize locks");
+  }
+
+  threads = (pthread_t *)malloc(thread_num * sizeof(pthread_t));
+  if(threads == NULL){
+    ERROR_EXIT("Unable to allocate threads");
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start_time);
+  for(unsigned t = 0; t < thread_num; t++){
+    if(pthread_create(&threads[t], NULL, correction_worker, &task) != 0){
+      ERROR_EXIT("Unable to create thread");
     }
-    
-    array_corrections->num_el++;
-    printf("\r%.2f%%", ((float)i/(float)user_file->el_num*100));
   }
+  print_progress(&task);
+  for(unsigned t = 0; t < thread_num; t++){
+    pthread_join(threads[t], NULL);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end_time);
   printf("\rCompleted\n");
-  return total_time;
+
+  if(corrector->dictionary_set != NULL){
+    printf("Dictionary words: %lu of %u\n", atomic_load(&task.dictionary_hits), user_file->el_num);
+  }
+  if(cache != NULL){
+    printf("Cache: %lu hits, %lu misses (%.1f%% hit rate), %lu evictions\n", cache->hits, cache->misses,
+            (cache->hits + cache->misses > 0) ? 100.0 * (double)cache->hits / (double)(cache->hits + cache->misses) : 0.0, cache->evictions);
+  }
+
+  pthread_mutex_destroy(&task.cache_lock);
+  free(threads);
+  return (double)(end_time.tv_sec - start_time.tv_sec) + (double)(end_time.tv_nsec - start_time.tv_nsec) / 1e9;
 }
 
 /**
@@ -285,44 +667,481 @@ static void print_results(ArrayCorrections *array_corrections, double *execution
   printf("Execution time: %f\n", *execution_time);
 }
 
-static void correct_text_with_dictionary(const char *file_path, const char *dictionary_path){
+/**
+ * @brief This function loads dictionary, or maps it if it is a dictionary image, and builds its index
+ * 
+ * @param dictionary_path   dictionary file or image
+ * @param mode              search mode
+ * @param corrector         pointer to Corrector struct to initialize
+ */
+static void load_corrector(const char *dictionary_path, int mode, Corrector *corrector){
+  ArrayWords *dictionary = NULL;
+  PackedDictionary *packed = NULL;
 
-  ArrayWords *user_file = NULL, *dictionary = NULL;
+  if(packed_dictionary_is_image(dictionary_path)){
+    printf("Mapping dictionary image... ");
+    dictionary = map_dictionary_image(dictionary_path, mode, &packed);
+  }else{
+    printf("Loading dictionary... ");
+    dictionary = load_file(dictionary_path, DICTIONARY_DELIM);
+  }
+  build_corrector(corrector, dictionary, packed, mode);
+}
+
+/**
+ * @brief This function loads user file and dictionary, computes corrections and prints them
+ * 
+ * @param file_path         file to be corrected
+ * @param dictionary_path   dictionary file
+ * @param mode              search mode: MODE_LINEAR compares every word with all dictionary words,
+ *                          MODE_BKTREE, MODE_SYMSPELL and MODE_TRIE use an index of dictionary,
+ *                          MODE_PACKED scans a dictionary packed by word length,
+ *                          MODE_BATCH scans it scoring many words at a time with SIMD
+ * @param thread_num        number of worker threads
+ * @param use_cache         1 for correct once every distinct word, 0 for correct every word
+ * @param cache_size        max number of words in cache, 0 for no limit
+ */
+static void correct_text_with_dictionary(const char *file_path, const char *dictionary_path, int mode, unsigned thread_num, int use_cache, unsigned long cache_size){
+
+  ArrayWords *user_file = NULL;
   ArrayCorrections *array_corrections = NULL;
+  CorrectionCache *cache = NULL;
+  Corrector corrector;
   double execution_time = 0;
   
   setvbuf(stdout, NULL, _IONBF, 0); // For some terminal compatibility
 
-  user_file = init_structure_arraywords(user_file);
-  dictionary = init_structure_arraywords(dictionary);
-
   printf("Loading file... ");
-  load_file(file_path, user_file, USER_FILE_DELIM);
+  user_file = load_file(file_path, USER_FILE_DELIM);
 
-  printf("Loading dictionary... ");
-  load_file(dictionary_path, dictionary, DICTIONARY_DELIM);
+  load_corrector(dictionary_path, mode, &corrector);
+  if(use_cache){
+    build_dictionary_set(&corrector);
+    cache = cache_build(cache_size);
+  }
   
   array_corrections = init_array_corrections(array_corrections);
 
   printf("\nCorrecting  *\n          <-*\r");
-  execution_time = compute_corrections(user_file, dictionary, array_corrections);
+  execution_time = compute_corrections(user_file, &corrector, array_corrections, cache, thread_num);
 
   print_results(array_corrections, &execution_time);
 
   free_structure_arraywords(user_file);
-  free_structure_arraywords(dictionary);
+  free_corrector(&corrector);
+  cache_free(cache);
   free_array_corrections(array_corrections);
 }
 
+/**
+ * @brief This function prepares corrections of a word, with no correction found
+ * 
+ * @param word_corrections    pointer to corrections of word
+ * @param word                word to correct
+ */
+static void init_word_corrections(struct WordCorrections *word_corrections, char *word){
+  word_corrections->word = word;
+  word_corrections->array_corrections_word = (struct Correction *)malloc(INITIAL_CAPACITY * sizeof(struct Correction));
+  if(word_corrections->array_corrections_word == NULL){
+    ERROR_EXIT("Unable to allocate array corrections word");
+  }
+  word_corrections->capacity_array_corrections = INITIAL_CAPACITY;
+  word_corrections->min_ed = UINT_MAX;
+  word_corrections->num_corrections = 0;
+}
+
+static int compare_word_corrections(const void *wc_1, const void *wc_2){
+  return strcmp((*(struct WordCorrections * const *)wc_1)->word, (*(struct WordCorrections * const *)wc_2)->word);
+}
+
+/**
+ * @brief This function formats corrections of words, as server responses and stream output:
+ *        a line for every word with word, edit distance ("-" if dictionary is empty)
+ *        and corrections at that distance, separated by spaces
+ * 
+ * @param tokens      words
+ * @param answers     corrections of every word
+ * @param text_len    address where length of text is stored
+ * @return char*      allocated text, to free by caller
+ */
+static char *format_corrections(const TokenFile *tokens, struct WordCorrections **answers, unsigned long *text_len){
+  unsigned long len = 0;
+  char *text = NULL, *p = NULL;
+
+  for(unsigned long i = 0; i < tokens->word_num; i++){
+    len += strlen(tokens->word[i]) + 12;
+    for(unsigned j = 0; j < answers[i]->num_corrections; j++){
+      if(answers[i]->array_corrections_word[j].edit_distance == answers[i]->min_ed){
+        len += strlen(answers[i]->array_corrections_word[j].correction) + 1;
+      }
+    }
+  }
+  text = p = (char *)malloc(len + 1);
+  if(text == NULL){
+    ERROR_EXIT("Unable to allocate corrections text");
+  }
+  for(unsigned long i = 0; i < tokens->word_num; i++){
+    p += (answers[i]->min_ed == UINT_MAX) ? sprintf(p, "%s -", tokens->word[i]) : sprintf(p, "%s %u", tokens->word[i], answers[i]->min_ed);
+    for(unsigned j = 0; j < answers[i]->num_corrections; j++){
+      if(answers[i]->array_corrections_word[j].edit_distance == answers[i]->min_ed){
+        p += sprintf(p, " %s", answers[i]->array_corrections_word[j].correction);
+      }
+    }
+    *p++ = '\n';
+  }
+  *text_len = (unsigned long)(p - text);
+  return text;
+}
+
+/**
+ * @brief This function writes response of a request, see format_corrections
+ * 
+ * @param request     request to answer
+ * @param tokens      words of request
+ * @param answers     corrections of every word
+ */
+static void write_response(ServerRequest *request, TokenFile *tokens, struct WordCorrections **answers){
+  unsigned long len;
+
+  request->response = format_corrections(tokens, answers, &len);
+  if(len > UINT32_MAX){
+    ERROR_EXIT("Response too long");
+  }
+  request->response_len = (uint32_t)len;
+}
+
+/**
+ * @brief Server handler: it corrects words of a batch of requests, every request is a text
+ *        split with USER_FILE_DELIM. Words repeated in the batch are corrected once.
+ * 
+ * @param requests    requests of batch
+ * @param num         number of requests
+ * @param context     pointer to CorrectionTask struct shared by workers
+ */
+static void serve_requests(ServerRequest **requests, unsigned long num, void *context){
+  CorrectionTask *task = (CorrectionTask *)context;
+  TokenFile **tokens = (TokenFile **)malloc(num * sizeof(TokenFile *));
+  struct WordCorrections *words = NULL, **sorted = NULL, **answers = NULL;
+  unsigned long word_num = 0, w, run;
+
+  if(tokens == NULL){
+    ERROR_EXIT("Unable to allocate batch");
+  }
+  for(unsigned long r = 0; r < num; r++){
+    tokens[r] = token_file_parse(requests[r]->payload, requests[r]->len, USER_FILE_DELIM);
+    word_num += tokens[r]->word_num;
+  }
+  words = (struct WordCorrections *)malloc((word_num > 0 ? word_num : 1) * sizeof(struct WordCorrections));
+  sorted = (struct WordCorrections **)malloc((word_num > 0 ? word_num : 1) * sizeof(struct WordCorrections *));
+  answers = (struct WordCorrections **)malloc((word_num > 0 ? word_num : 1) * sizeof(struct WordCorrections *));
+  if(words == NULL || sorted == NULL || answers == NULL){
+    ERROR_EXIT("Unable to allocate batch words");
+  }
+  w = 0;
+  for(unsigned long r = 0; r < num; r++){
+    for(unsigned long i = 0; i < tokens[r]->word_num; i++, w++){
+      init_word_corrections(&words[w], tokens[r]->word[i]);
+      sorted[w] = &words[w];
+    }
+  }
+
+  // first copy of every word is corrected, the others take its corrections
+  qsort(sorted, word_num, sizeof(struct WordCorrections *), compare_word_corrections);
+  for(w = 0; w < word_num; w = run){
+    correct_word_cached(task, sorted[w]);
+    for(run = w; run < word_num && strcmp(sorted[run]->word, sorted[w]->word) == 0; run++){
+      answers[sorted[run] - words] = sorted[w];
+    }
+  }
+
+  w = 0;
+  for(unsigned long r = 0; r < num; r++){
+    write_response(requests[r], tokens[r], &answers[w]);
+    w += tokens[r]->word_num;
+    token_file_free(tokens[r]);
+  }
+  for(w = 0; w < word_num; w++){
+    free(words[w].array_corrections_word);
+  }
+  free(words);
+  free(sorted);
+  free(answers);
+  free(tokens);
+}
+
+/**
+ * @brief This function prepares a CorrectionTask shared by workers correcting words
+ *        as they come, without a user file
+ * 
+ * @param task          pointer to CorrectionTask struct to initialize
+ * @param corrector     pointer to Corrector struct, dictionary set is built if cache is used
+ * @param use_cache     1 for correct once every distinct word, 0 for correct every word
+ * @param cache_size    max number of words in cache, 0 for no limit
+ */
+static void init_shared_task(CorrectionTask *task, Corrector *corrector, int use_cache, unsigned long cache_size){
+  task->corrector = corrector;
+  task->user_file = NULL;
+  task->array_corrections = NULL;
+  atomic_init(&task->next_word, 0);
+  atomic_init(&task->done_words, 0);
+  task->cache = NULL;
+  atomic_init(&task->dictionary_hits, 0);
+  if(use_cache){
+    build_dictionary_set(corrector);
+    task->cache = cache_build(cache_size);
+  }
+  if(pthread_mutex_init(&task->cache_lock, NULL) != 0){
+    ERROR_EXIT("Unable to initialize locks");
+  }
+}
+
+static Server *running_server = NULL;
+
+static void stop_serving(int signal_number){
+  (void)signal_number;
+  if(running_server != NULL){
+    server_stop(running_server);
+  }
+}
+
+/**
+ * @brief This function loads dictionary once and serves corrections on a Unix domain socket
+ *        until SIGINT or SIGTERM. Requests are texts, responses have a line for every word
+ *        (see write_response).
+ * 
+ * @param socket_path       path of socket
+ * @param dictionary_path   dictionary file or image
+ * @param mode              search mode
+ * @param thread_num        number of worker threads
+ * @param use_cache         1 for correct once every distinct word, 0 for correct every word
+ * @param cache_size        max number of words in cache, 0 for no limit
+ */
+static void serve_corrections(const char *socket_path, const char *dictionary_path, int mode, unsigned thread_num, int use_cache, unsigned long cache_size){
+  Corrector corrector;
+  CorrectionTask task;
+  struct sigaction action;
+
+  setvbuf(stdout, NULL, _IONBF, 0);
+  load_corrector(dictionary_path, mode, &corrector);
+  init_shared_task(&task, &corrector, use_cache, cache_size);
+
+  running_server = server_create(socket_path, serve_requests, &task, thread_num, SERVER_MAX_BATCH);
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = stop_serving;
+  sigemptyset(&action.sa_mask);
+  if(sigaction(SIGINT, &action, NULL) != 0 || sigaction(SIGTERM, &action, NULL) != 0){
+    ERROR_EXIT("Unable to set signal handlers");
+  }
+
+  printf("Serving on %s with %u threads\n", socket_path, thread_num);
+  server_run(running_server);
+  printf("\nServed %lu requests in %lu batches\n", running_server->requests, running_server->batches);
+  if(task.cache != NULL){
+    printf("Cache: %lu hits, %lu misses, %lu evictions\n", task.cache->hits, task.cache->misses, task.cache->evictions);
+  }
+
+  server_free(running_server);
+  running_server = NULL;
+  pthread_mutex_destroy(&task.cache_lock);
+  free_corrector(&corrector);
+  cache_free(task.cache);
+}
+
+/**
+ * @brief Stream handler: it corrects words of a chunk, output has a line for every word
+ *        as server responses (see format_corrections)
+ * 
+ * @param chunk     chunk of input
+ * @param context   pointer to CorrectionTask struct shared by workers
+ */
+static void correct_chunk(StreamChunk *chunk, void *context){
+  CorrectionTask *task = (CorrectionTask *)context;
+  unsigned long word_num = chunk->tokens->word_num;
+  struct WordCorrections *words = (struct WordCorrections *)malloc(word_num * sizeof(struct WordCorrections));
+  struct WordCorrections **answers = (struct WordCorrections **)malloc(word_num * sizeof(struct WordCorrections *));
+
+  if(words == NULL || answers == NULL){
+    ERROR_EXIT("Unable to allocate chunk words");
+  }
+  for(unsigned long i = 0; i < word_num; i++){
+    init_word_corrections(&words[i], chunk->tokens->word[i]);
+    correct_word_cached(task, &words[i]);
+    answers[i] = &words[i];
+  }
+  chunk->output = format_corrections(chunk->tokens, answers, &chunk->output_len);
+  for(unsigned long i = 0; i < word_num; i++){
+    free(words[i].array_corrections_word);
+  }
+  free(words);
+  free(answers);
+}
+
+/**
+ * @brief This function corrects a text of any size as a pipeline: a reader splits it in chunks,
+ *        worker threads correct them and a writer prints corrections in text order
+ *        while text is still being read. Corrections are printed on standard output,
+ *        messages on standard error.
+ * 
+ * @param file_path         file to be corrected, "-" for standard input
+ * @param dictionary_path   dictionary file or image
+ * @param mode              search mode
+ * @param thread_num        number of worker threads
+ * @param use_cache         1 for correct once every distinct word, 0 for correct every word
+ * @param cache_size        max number of words in cache, 0 for no limit
+ */
+static void stream_corrections(const char *file_path, const char *dictionary_path, int mode, unsigned thread_num, int use_cache, unsigned long cache_size){
+  Corrector corrector;
+  CorrectionTask task;
+  Stream *stream = NULL;
+  struct timespec end_time;
+  FILE *output = NULL;
+  int fd, output_fd;
+
+  // corrections keep standard output, messages printed by the rest of program go to standard error
+  output_fd = dup(STDOUT_FILENO);
+  if(output_fd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0 || (output = fdopen(output_fd, "w")) == NULL){
+    ERROR_EXIT("Unable to redirect messages");
+  }
+  setvbuf(stdout, NULL, _IONBF, 0);
+
+  if(strcmp(file_path, "-") == 0){
+    fd = STDIN_FILENO;
+  }else if((fd = open(file_path, O_RDONLY)) < 0){
+    ERROR_EXIT("Unable to open file");
+  }
+
+  load_corrector(dictionary_path, mode, &corrector);
+  init_shared_task(&task, &corrector, use_cache, cache_size);
+  stream = stream_create(correct_chunk, &task, thread_num, USER_FILE_DELIM);
+
+  printf("Correcting %s with %u threads\n", (fd == STDIN_FILENO) ? "standard input" : file_path, thread_num);
+  stream_run(stream, fd, output);
+  clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+  printf("Corrected %lu words in %f sec, first corrections after %f sec\n", stream->words,
+          (double)(end_time.tv_sec - stream->start_time.tv_sec) + (double)(end_time.tv_nsec - stream->start_time.tv_nsec) / 1e9,
+          (stream->first_output >= 0) ? stream->first_output : 0.0);
+  if(task.cache != NULL){
+    printf("Cache: %lu hits, %lu misses, %lu evictions\n", task.cache->hits, task.cache->misses, task.cache->evictions);
+  }
+
+  if(fd != STDIN_FILENO){
+    close(fd);
+  }
+  fclose(output);
+  stream_free(stream);
+  pthread_mutex_destroy(&task.cache_lock);
+  free_corrector(&corrector);
+  cache_free(task.cache);
+}
+
+/**
+ * @brief This function loads dictionary and writes it packed in a binary image,
+ *        that can be given in place of dictionary for starting without loading it
+ * 
+ * @param dictionary_path   dictionary file
+ * @param image_path        dictionary image to write
+ */
+static void compile_dictionary(const char *dictionary_path, const char *image_path){
+  ArrayWords *dictionary = NULL;
+  PackedDictionary *packed = NULL;
+
+  setvbuf(stdout, NULL, _IONBF, 0);
+  printf("Loading dictionary... ");
+  dictionary = load_file(dictionary_path, DICTIONARY_DELIM);
+  packed = packed_dictionary_build(dictionary->word, dictionary->el_num);
+  free_structure_arraywords(dictionary);
+
+  packed_dictionary_save(packed, image_path);
+  printf("Dictionary image written to %s, %.1f MB\n", image_path, (double)packed_dictionary_size(packed) / (1024 * 1024));
+  packed_dictionary_free(packed);
+}
+
 int main(int argc, char **argv){
   
-  if(argc < 2){
-    printf("Usage: dyn_edit_distance_main <file to be correct> <dictionary>\n");
+  int mode = MODE_PACKED;
+  long thread_num = sysconf(_SC_NPROCESSORS_ONLN);
+  unsigned long cache_size = 0;
+  int use_cache = 1, serve = 0, stream = 0, cache_size_set = 0, first_option = 3;
+  char *end_p = NULL;
+
+  if(argc < 3){
+    printf(USAGE);
     exit(EXIT_FAILURE);
   }
+  if(strcmp(argv[1], "--serve") == 0){
+    if(argc < 4){
+      printf(USAGE);
+      exit(EXIT_FAILURE);
+    }
+    serve = 1;
+    first_option = 4;
+  }else if(strcmp(argv[1], "--stream") == 0){
+    if(argc < 4){
+      printf(USAGE);
+      exit(EXIT_FAILURE);
+    }
+    stream = 1;
+    first_option = 4;
+  }
+  if(strcmp(argv[1], "--compile-dict") == 0){
+    if(argc != 4){
+      printf(USAGE);
+      exit(EXIT_FAILURE);
+    }
+    compile_dictionary(argv[2], argv[3]);
+    exit(EXIT_SUCCESS);
+  }
 
-  correct_text_with_dictionary(argv[1],argv[2]);
+  for(int i = first_option; i < argc; i++){
+    if(strcmp(argv[i], "--linear") == 0){
+      mode = MODE_LINEAR;
+    }else if(strcmp(argv[i], "--bktree") == 0){
+      mode = MODE_BKTREE;
+    }else if(strcmp(argv[i], "--symspell") == 0){
+      mode = MODE_SYMSPELL;
+    }else if(strcmp(argv[i], "--trie") == 0){
+      mode = MODE_TRIE;
+    }else if(strcmp(argv[i], "--packed") == 0){
+      mode = MODE_PACKED;
+    }else if(strcmp(argv[i], "--batch") == 0){
+      mode = MODE_BATCH;
+    }else if(strcmp(argv[i], "--threads") == 0 && i + 1 < argc){
+      thread_num = strtol(argv[++i], &end_p, 10);
+      if(*end_p != '\0' || thread_num < 1 || thread_num > MAX_THREADS){
+        printf("Number of threads must be between 1 and %d\n", MAX_THREADS);
+        exit(EXIT_FAILURE);
+      }
+    }else if(strcmp(argv[i], "--cache-size") == 0 && i + 1 < argc){
+      cache_size = strtoul(argv[++i], &end_p, 10);
+      if(*end_p != '\0' || argv[i][0] == '-' || cache_size >= CACHE_NONE){
+        printf("Cache size must be a number of words, 0 for no limit\n");
+        exit(EXIT_FAILURE);
+      }
+      cache_size_set = 1;
+    }else if(strcmp(argv[i], "--no-cache") == 0){
+      use_cache = 0;
+    }else{
+      printf(USAGE);
+      exit(EXIT_FAILURE);
+    }
+  }
+  if(thread_num < 1){
+    thread_num = 1;
+  }else if(thread_num > MAX_THREADS){
+    thread_num = MAX_THREADS;
+  }
+
+  if(serve){
+    // a server sees unbounded distinct words
+    serve_corrections(argv[2], argv[3], mode, (unsigned)thread_num, use_cache, cache_size_set ? cache_size : SERVER_CACHE_SIZE);
+  }else if(stream){
+    // memory of cache has to be bounded as the rest of pipeline
+    stream_corrections(argv[2], argv[3], mode, (unsigned)thread_num, use_cache, cache_size_set ? cache_size : STREAM_CACHE_SIZE);
+  }else{
+    correct_text_with_dictionary(argv[1],argv[2],mode,(unsigned)thread_num,use_cache,cache_size);
+  }
 
   printf("Exiting\n");
   exit(EXIT_SUCCESS);
-}
\ No newline at end of file
+}
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "unity/unity.h"
 #include "edit_distance_dyn.h"
@@ -39,6 +40,71 @@ static void test_two_string_same_len(void){
   TEST_ASSERT_EQUAL_INT(2, edit_distance_dyn(s1, s2));
 }
 
+static void test_same_as_memo_random_strings(void){
+  char s1[40], s2[40];
+  
+  srand(17);
+  for(int t = 0; t < 500; t++){
+    int len1 = rand() % 39, len2 = rand() % 39;
+    for(int i = 0; i < len1; i++) s1[i] = (char)('a' + rand() % 4);
+    for(int i = 0; i < len2; i++) s2[i] = (char)('a' + rand() % 4);
+    s1[len1] = '\0';
+    s2[len2] = '\0';
+    TEST_ASSERT_EQUAL_INT(edit_distance_dyn_memo(s1, s2), edit_distance_dyn(s1, s2));
+  }
+}
+
+static void test_long_strings(void){
+  unsigned long len = 20000;
+  char *s1 = (char *)malloc(len + 1);
+  char *s2 = (char *)malloc(len + 1);
+  
+  memset(s1, 'a', len);
+  memset(s2, 'a', len);
+  s1[len] = s2[len] = '\0';
+  s2[len/2] = 'b';
+  TEST_ASSERT_EQUAL_INT(2, edit_distance_dyn(s1, s2));
+  free(s1);
+  free(s2);
+}
+
+static void test_bounded_within_bound(void){
+  char *s1 = "tassa";
+  char *s2 = "passato";
+  TEST_ASSERT_EQUAL_INT(4, edit_distance_bounded(s1, s2, 4));
+  TEST_ASSERT_EQUAL_INT(4, edit_distance_bounded(s1, s2, 10));
+}
+
+static void test_bounded_over_bound(void){
+  char *s1 = "tassa";
+  char *s2 = "passato";
+  TEST_ASSERT_EQUAL_INT(4, edit_distance_bounded(s1, s2, 3));
+  TEST_ASSERT_EQUAL_INT(1, edit_distance_bounded(s1, s2, 0));
+}
+
+static void test_bounded_length_difference(void){
+  char *s1 = "a";
+  char *s2 = "welcome";
+  TEST_ASSERT_EQUAL_INT(3, edit_distance_bounded(s1, s2, 2));
+}
+
+static void test_bounded_same_as_dyn_random_strings(void){
+  char s1[200], s2[200];
+  unsigned exact, bound;
+  
+  srand(23);
+  for(int t = 0; t < 3000; t++){
+    int len1 = rand() % 199, len2 = rand() % 199;
+    for(int i = 0; i < len1; i++) s1[i] = (char)('a' + rand() % 3);
+    for(int i = 0; i < len2; i++) s2[i] = (char)('a' + rand() % 3);
+    s1[len1] = '\0';
+    s2[len2] = '\0';
+    exact = edit_distance_dyn(s1, s2);
+    bound = (unsigned)(rand() % 250);
+    TEST_ASSERT_EQUAL_INT(exact <= bound ? exact : bound + 1, edit_distance_bounded(s1, s2, bound));
+  }
+}
+
 int main(void){
 
   // test session
@@ -49,6 +115,12 @@ int main(void){
   RUN_TEST(test_equal_strings);
   RUN_TEST(test_two_string_different_len);
   RUN_TEST(test_two_string_same_len);
+  RUN_TEST(test_same_as_memo_random_strings);
+  RUN_TEST(test_long_strings);
+  RUN_TEST(test_bounded_within_bound);
+  RUN_TEST(test_bounded_over_bound);
+  RUN_TEST(test_bounded_length_difference);
+  RUN_TEST(test_bounded_same_as_dyn_random_strings);
 
   return UNITY_END();
 }
@@ -0,0 +1,107 @@
+#ifndef _EDIT_DISTANCE_INDEX_TEST_H_
+#define _EDIT_DISTANCE_INDEX_TEST_H_
+
+/*
+ * Check shared by tests of dictionary indexes (BK-tree, SymSpell, trie, packed, batch):
+ * every index must find the same words of a linear scan with edit_distance_dyn.
+ * Included only by test files, after unity.h.
+ */
+
+#include <stdlib.h>
+#include <limits.h>
+#include "edit_distance_dyn.h"
+
+/**
+ * @brief Search function of an index, as the *_search_min functions
+ *
+ * @param index         index, built on words given to assert_same_as_linear_scan
+ * @param word          word to search
+ * @param max_distance  max distance of interest, UINT_MAX for no limit
+ * @param results       address where allocated indexes of found words are stored, in dictionary order
+ * @param result_num    address where number of found words is stored
+ * @return unsigned     minimum distance, max_distance + 1 if no word is found
+ */
+typedef unsigned (*IndexSearch)(const void *index, const char *word, unsigned max_distance, unsigned long **results, unsigned long *result_num);
+
+/**
+ * @brief Generate random words on the first alphabet letters, few letters give many words
+ *        at the same distance
+ *
+ * @param word_num  number of words
+ * @param max_len   words are shorter than max_len
+ * @param alphabet  number of letters
+ * @return char**   allocated words, to free with free_random_words
+ */
+static char **random_words(unsigned long word_num, int max_len, int alphabet){
+  char **words = (char **)malloc(word_num * sizeof(char *));
+
+  TEST_ASSERT_NOT_NULL(words);
+  for(unsigned long i = 0; i < word_num; i++){
+    int len = rand() % max_len;
+    words[i] = (char *)malloc((unsigned long)len + 1);
+    TEST_ASSERT_NOT_NULL(words[i]);
+    for(int k = 0; k < len; k++) words[i][k] = (char)('a' + rand() % alphabet);
+    words[i][len] = '\0';
+  }
+  return words;
+}
+
+static void free_random_words(char **words, unsigned long word_num){
+  for(unsigned long i = 0; i < word_num; i++){
+    free(words[i]);
+  }
+  free(words);
+}
+
+/**
+ * @brief Check distance and found words of random queries against a linear scan of words
+ *
+ * @param index         index built on words
+ * @param search        search function of index
+ * @param words         dictionary words
+ * @param word_num      number of words
+ * @param max_distance  max distance given to search: words farther are not found
+ * @param query_num     number of random queries
+ * @param max_len       queries are shorter than max_len
+ * @param alphabet      number of letters of queries
+ */
+static void assert_same_as_linear_scan(const void *index, IndexSearch search, char **words, unsigned long word_num,
+                                        unsigned max_distance, int query_num, int max_len, int alphabet){
+  char *query = (char *)malloc((unsigned long)max_len + 1);
+  unsigned long *found, found_num, exp_num;
+  unsigned min_ed, distance;
+
+  TEST_ASSERT_NOT_NULL(query);
+  for(int t = 0; t < query_num; t++){
+    int len = rand() % max_len;
+    for(int k = 0; k < len; k++) query[k] = (char)('a' + rand() % alphabet);
+    query[len] = '\0';
+
+    min_ed = UINT_MAX;
+    for(unsigned long i = 0; i < word_num; i++){
+      distance = edit_distance_dyn(words[i], query);
+      if(distance < min_ed) min_ed = distance;
+    }
+    if(min_ed != UINT_MAX && min_ed > max_distance){
+      TEST_ASSERT_EQUAL_INT(max_distance + 1, search(index, query, max_distance, &found, &found_num));
+      TEST_ASSERT_EQUAL_UINT64(0, found_num);
+      free(found);
+      continue;
+    }
+    TEST_ASSERT_EQUAL_INT(min_ed, search(index, query, max_distance, &found, &found_num));
+
+    exp_num = 0;
+    for(unsigned long i = 0; i < word_num; i++){
+      if(edit_distance_dyn(words[i], query) == min_ed){
+        TEST_ASSERT_TRUE(exp_num < found_num);
+        TEST_ASSERT_EQUAL_UINT64(i, found[exp_num]);
+        exp_num++;
+      }
+    }
+    TEST_ASSERT_EQUAL_UINT64(exp_num, found_num);
+    free(found);
+  }
+  free(query);
+}
+
+#endif
@@ -0,0 +1,468 @@
+/**
+ * @file edit_distance_myers.c
+ * @author Daniele Di Palma
+ * @brief Edit distance (insertions and deletions only) with Myers' O(ND) difference algorithm
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include "edit_distance_myers.h"
+#include "edit_distance_bp.h"
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+#define NOT_REACHED_FORWARD (-1L)       // diagonal not reached yet by forward search
+#define NOT_REACHED_BACKWARD (LONG_MAX) // diagonal not reached yet by backward search
+
+#define AUTO_MIN_LEN (64)        // shorter strings always use bit-parallel LCS
+#define AUTO_SAMPLES (16)        // windows of s1 searched in s2
+#define AUTO_WINDOW (16)         // length of a window
+#define AUTO_BUDGET_RATIO (8)    // Myers gives up after min(len) / AUTO_BUDGET_RATIO steps
+#define AUTO_ESTIMATE_MARGIN (4) // Myers is tried if estimated changes are at most budget / AUTO_ESTIMATE_MARGIN
+
+// number of equal bytes at lower and higher addresses of two words, given their xor (not 0)
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define EQUAL_LEADING_BYTES(x) ((unsigned long)__builtin_clzll(x) / 8)
+#define EQUAL_TRAILING_BYTES(x) ((unsigned long)__builtin_ctzll(x) / 8)
+#else
+#define EQUAL_LEADING_BYTES(x) ((unsigned long)__builtin_ctzll(x) / 8)
+#define EQUAL_TRAILING_BYTES(x) ((unsigned long)__builtin_clzll(x) / 8)
+#endif
+
+/**
+ * @brief It rappresents furthest points reached on every diagonal by forward and backward
+ *        search, allocated once for the whole edit script
+ */
+typedef struct _SnakeWorkspace{
+  long *forward;    // greatest x reached from start of table
+  long *backward;   // smallest x reached from end of table
+} SnakeWorkspace;
+
+/**
+ * @brief Length of common prefix of a and b, compared 8 characters at a time
+ *
+ * @param a     first string
+ * @param b     second string
+ * @param len   maximum length
+ * @return unsigned long length of common prefix
+ */
+static unsigned long snake(const unsigned char *a, const unsigned char *b, unsigned long len){
+  unsigned long i = 0;
+  uint64_t word_a, word_b;
+
+  while(i + 8 <= len){
+    memcpy(&word_a, a + i, 8);
+    memcpy(&word_b, b + i, 8);
+    if(word_a != word_b){
+      return i + EQUAL_LEADING_BYTES(word_a ^ word_b);
+    }
+    i += 8;
+  }
+  while(i < len && a[i] == b[i]){
+    i++;
+  }
+  return i;
+}
+
+/**
+ * @brief Length of common suffix of strings ending at a_end and b_end, compared 8 characters at a time
+ *
+ * @param a_end   end of first string
+ * @param b_end   end of second string
+ * @param len     maximum length
+ * @return unsigned long length of common suffix
+ */
+static unsigned long reverse_snake(const unsigned char *a_end, const unsigned char *b_end, unsigned long len){
+  unsigned long i = 0;
+  uint64_t word_a, word_b;
+
+  while(i + 8 <= len){
+    memcpy(&word_a, a_end - i - 8, 8);
+    memcpy(&word_b, b_end - i - 8, 8);
+    if(word_a != word_b){
+      return i + EQUAL_TRAILING_BYTES(word_a ^ word_b);
+    }
+    i += 8;
+  }
+  while(i < len && *(a_end - i - 1) == *(b_end - i - 1)){
+    i++;
+  }
+  return i;
+}
+
+/**
+ * @brief First diagonal not lower than k with the same parity and not lower than low
+ */
+static long clip_min(long k, long low){
+  return k >= low ? k : low + (low - k) % 2;
+}
+
+/**
+ * @brief Last diagonal not greater than k with the same parity and not greater than high
+ */
+static long clip_max(long k, long high){
+  return k <= high ? k : high - (k - high) % 2;
+}
+
+/**
+ * @brief Furthest x reachable on diagonal k (x - y = k) with one more operation from
+ *        diagonals k - 1 and k + 1, staying inside a table of m x n
+ *
+ * @param v   furthest x reached on every diagonal with one operation less
+ * @param k   diagonal
+ * @param m   length of first string
+ * @param n   length of second string
+ * @return long x, NOT_REACHED_FORWARD if diagonal can't be reached
+ */
+static long forward_step(const long *v, long k, long m, long n){
+  long x = NOT_REACHED_FORWARD;
+
+  // insertion of a character of second string
+  if(v[k + 1] != NOT_REACHED_FORWARD && v[k + 1] - k <= n){
+    x = v[k + 1];
+  }
+  // deletion of a character of first string
+  if(v[k - 1] != NOT_REACHED_FORWARD && v[k - 1] + 1 <= m && v[k - 1] + 1 > x){
+    x = v[k - 1] + 1;
+  }
+  return x;
+}
+
+/**
+ * @brief Smallest x reachable on diagonal k going backwards with one more operation from
+ *        diagonals k - 1 and k + 1, staying inside the table
+ *
+ * @param v   smallest x reached on every diagonal with one operation less
+ * @param k   diagonal
+ * @return long x, NOT_REACHED_BACKWARD if diagonal can't be reached
+ */
+static long backward_step(const long *v, long k){
+  long x = NOT_REACHED_BACKWARD;
+
+  // deletion of a character of first string
+  if(v[k + 1] != NOT_REACHED_BACKWARD && v[k + 1] >= 1){
+    x = v[k + 1] - 1;
+  }
+  // insertion of a character of second string
+  if(v[k - 1] != NOT_REACHED_BACKWARD && v[k - 1] - k >= 0 && v[k - 1] < x){
+    x = v[k - 1];
+  }
+  return x;
+}
+
+/**
+ * @brief Length of common prefix of two strings starting at a + x and b + y
+ */
+static unsigned long char_snake(const void *a, const void *b, unsigned long x, unsigned long y, unsigned long len){
+  return snake((const unsigned char *)a + x, (const unsigned char *)b + y, len);
+}
+
+/**
+ * @brief Length of common prefix of two sequences of ids starting at a + x and b + y
+ */
+static unsigned long u32_snake(const void *a, const void *b, unsigned long x, unsigned long y, unsigned long len){
+  const uint32_t *p = (const uint32_t *)a + x, *q = (const uint32_t *)b + y;
+  unsigned long i = 0;
+
+  while(i < len && p[i] == q[i]){
+    i++;
+  }
+  return i;
+}
+
+/**
+ * @brief Greedy forward search of Myers' algorithm, stopping after bound operations
+ *
+ * @param a           first sequence
+ * @param m           length of a
+ * @param b           second sequence
+ * @param n           length of b
+ * @param bound       maximum distance of interest
+ * @param snake_from  length of common prefix of a and b starting at given x and y
+ * @return unsigned long number of operation if it is <= bound, bound + 1 otherwise
+ */
+static unsigned long greedy_search(const void *a, unsigned long m, const void *b, unsigned long n, unsigned long bound,
+                                   unsigned long (*snake_from)(const void *, const void *, unsigned long, unsigned long, unsigned long)){
+  unsigned long max_d = bound < m + n ? bound : m + n, result = max_d + 1;
+  long *v = NULL, x, y, k;
+
+  v = (long *)malloc((2 * max_d + 3) * sizeof(long));
+  if(v == NULL){
+    ERROR_EXIT("Unable to allocate diagonals");
+  }
+  // diagonals from -(max_d + 1) to max_d + 1, initialized only when first read
+  v += max_d + 1;
+
+  for(long d = 0; d <= (long)max_d && result > max_d; d++){
+    v[-d - 1] = NOT_REACHED_FORWARD;
+    v[d + 1] = NOT_REACHED_FORWARD;
+    for(k = clip_min(-d, -(long)n); k <= clip_max(d, (long)m); k += 2){
+      x = (d == 0) ? 0 : forward_step(v, k, (long)m, (long)n);
+      if(x != NOT_REACHED_FORWARD){
+        y = x - k;
+        x += (long)snake_from(a, b, (unsigned long)x, (unsigned long)y,
+                              (unsigned long)((long)m - x < (long)n - y ? (long)m - x : (long)n - y));
+        if(x == (long)m && x - k == (long)n){
+          result = (unsigned long)d;
+          break;
+        }
+      }
+      v[k] = x;
+    }
+  }
+
+  free(v - max_d - 1);
+  // max_d + 1 is bound + 1 when bound is reached
+  return result;
+}
+
+unsigned edit_distance_myers_bounded(char *s1, char *s2, unsigned bound){
+  const unsigned char *a = (const unsigned char *)s1, *b = (const unsigned char *)s2;
+  unsigned long m, n, suffix, diff;
+
+  if(s1 == NULL || s2 == NULL){
+    ERROR_EXIT("Strings can't be NULL");
+  }
+  m = strlen(s1);
+  n = strlen(s2);
+  if(m + n >= UINT_MAX){
+    ERROR_EXIT("Strings too long");
+  }
+  diff = m > n ? m - n : n - m;
+  if(diff > bound){
+    return bound + 1;
+  }
+
+  suffix = reverse_snake(a + m, b + n, m < n ? m : n);
+  return (unsigned)greedy_search(a, m - suffix, b, n - suffix, bound, char_snake);
+}
+
+unsigned long edit_distance_myers_u32_bounded(const uint32_t *seq1, unsigned long len1, const uint32_t *seq2, unsigned long len2,
+                                              unsigned long bound){
+  if((seq1 == NULL && len1 > 0) || (seq2 == NULL && len2 > 0)){
+    ERROR_EXIT("Sequences can't be NULL");
+  }
+  if((len1 > len2 ? len1 - len2 : len2 - len1) > bound){
+    return bound + 1;
+  }
+  return greedy_search(seq1, len1, seq2, len2, bound, u32_snake);
+}
+
+unsigned edit_distance_myers(char *s1, char *s2){
+  return edit_distance_myers_bounded(s1, s2, UINT_MAX);
+}
+
+/**
+ * @brief Find middle snake of an optimal path of a table of m x n, with m > 0, n > 0 and
+ *        first and last characters of a and b different (so distance is at least 2)
+ *
+ * @param ws        workspace with at least m + n + 3 diagonals
+ * @param a         first string
+ * @param m         length of a
+ * @param b         second string
+ * @param n         length of b
+ * @param snake_x   array where x of start and end of snake are stored
+ * @param snake_y   array where y of start and end of snake are stored
+ */
+static void middle_snake(SnakeWorkspace *ws, const unsigned char *a, long m, const unsigned char *b, long n,
+                         long snake_x[2], long snake_y[2]){
+  long *forward = ws->forward + n + 1, *backward = ws->backward + n + 1;
+  long delta = m - n, x, y, k;
+  int odd = (delta % 2 != 0);
+
+  // diagonals from -(n + 1) to m + 1, initialized only when first read
+  for(long d = 0; ; d++){
+    if(d <= n){
+      forward[-d - 1] = NOT_REACHED_FORWARD;
+    }
+    if(d <= m){
+      forward[d + 1] = NOT_REACHED_FORWARD;
+    }
+    if(delta - d >= -n){
+      backward[delta - d - 1] = NOT_REACHED_BACKWARD;
+    }
+    if(delta + d <= m){
+      backward[delta + d + 1] = NOT_REACHED_BACKWARD;
+    }
+    for(k = clip_min(-d, -n); k <= clip_max(d, m); k += 2){
+      x = (d == 0) ? 0 : forward_step(forward, k, m, n);
+      if(x == NOT_REACHED_FORWARD){
+        forward[k] = x;
+        continue;
+      }
+      y = x - k;
+      snake_x[0] = x;
+      snake_y[0] = y;
+      x += (long)snake(a + x, b + y, (unsigned long)(m - x < n - y ? m - x : n - y));
+      forward[k] = x;
+      // paths overlap with backward path of d - 1 operations
+      if(odd && k >= delta - d + 1 && k <= delta + d - 1 && backward[k] != NOT_REACHED_BACKWARD && backward[k] <= x){
+        snake_x[1] = x;
+        snake_y[1] = x - k;
+        return;
+      }
+    }
+
+    for(k = clip_min(delta - d, -n); k <= clip_max(delta + d, m); k += 2){
+      x = (d == 0) ? m : backward_step(backward, k);
+      if(x == NOT_REACHED_BACKWARD){
+        backward[k] = x;
+        continue;
+      }
+      y = x - k;
+      snake_x[1] = x;
+      snake_y[1] = y;
+      x -= (long)reverse_snake(a + x, b + y, (unsigned long)(x < y ? x : y));
+      backward[k] = x;
+      // paths overlap with forward path of d operations
+      if(!odd && k >= -d && k <= d && forward[k] != NOT_REACHED_FORWARD && x <= forward[k]){
+        snake_x[0] = x;
+        snake_y[0] = x - k;
+        return;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Append to script operations transforming a into b
+ *
+ * @param ws      workspace
+ * @param script  script
+ * @param a       first string
+ * @param m       length of a
+ * @param b       second string
+ * @param n       length of b
+ */
+static void myers_script(SnakeWorkspace *ws, EditScript *script, const unsigned char *a, unsigned long m,
+                         const unsigned char *b, unsigned long n){
+  unsigned long prefix, suffix;
+  long snake_x[2], snake_y[2];
+
+  prefix = snake(a, b, m < n ? m : n);
+  edit_script_append(script, EDIT_KEEP, prefix);
+  a += prefix;
+  b += prefix;
+  m -= prefix;
+  n -= prefix;
+  suffix = reverse_snake(a + m, b + n, m < n ? m : n);
+  m -= suffix;
+  n -= suffix;
+
+  if(m == 0 || n == 0){
+    edit_script_append(script, EDIT_DELETE, m);
+    edit_script_append(script, EDIT_INSERT, n);
+  }else{
+    middle_snake(ws, a, (long)m, b, (long)n, snake_x, snake_y);
+    myers_script(ws, script, a, (unsigned long)snake_x[0], b, (unsigned long)snake_y[0]);
+    edit_script_append(script, EDIT_KEEP, (unsigned long)(snake_x[1] - snake_x[0]));
+    myers_script(ws, script, a + snake_x[1], m - (unsigned long)snake_x[1], b + snake_y[1], n - (unsigned long)snake_y[1]);
+  }
+
+  edit_script_append(script, EDIT_KEEP, suffix);
+}
+
+EditScript *edit_script_myers(char *s1, char *s2){
+  EditScript *script = NULL;
+  SnakeWorkspace ws;
+  unsigned long m, n;
+
+  if(s1 == NULL || s2 == NULL){
+    ERROR_EXIT("Strings can't be NULL");
+  }
+  m = strlen(s1);
+  n = strlen(s2);
+  if(m + n >= UINT_MAX){
+    ERROR_EXIT("Strings too long");
+  }
+
+  script = edit_script_create();
+  ws.forward = (long *)malloc((m + n + 3) * sizeof(long));
+  ws.backward = (long *)malloc((m + n + 3) * sizeof(long));
+  if(ws.forward == NULL || ws.backward == NULL){
+    ERROR_EXIT("Unable to allocate diagonals");
+  }
+
+  myers_script(&ws, script, (const unsigned char *)s1, m, (const unsigned char *)s2, n);
+
+  free(ws.forward);
+  free(ws.backward);
+  return script;
+}
+
+/**
+ * @brief Check if a window of AUTO_WINDOW characters appears in b at most radius
+ *        positions away from expected one, nearest positions first
+ *
+ * @param window    window
+ * @param b         string
+ * @param n         length of b, at least AUTO_WINDOW
+ * @param expected  expected position, at most n - AUTO_WINDOW
+ * @param radius    maximum distance from expected position
+ * @return int 1 if window is found, 0 otherwise
+ */
+static int window_found(const char *window, const char *b, unsigned long n, unsigned long expected, unsigned long radius){
+  for(unsigned long r = 0; r <= radius; r++){
+    if(r > expected && expected + r > n - AUTO_WINDOW){
+      return 0;
+    }
+    if(expected + r <= n - AUTO_WINDOW && memcmp(window, b + expected + r, AUTO_WINDOW) == 0){
+      return 1;
+    }
+    if(r > 0 && r <= expected && memcmp(window, b + expected - r, AUTO_WINDOW) == 0){
+      return 1;
+    }
+  }
+  return 0;
+}
+
+unsigned edit_distance_auto(char *s1, char *s2){
+  unsigned long m, n, budget, position, expected, misses = 0;
+  unsigned result;
+
+  if(s1 == NULL || s2 == NULL){
+    ERROR_EXIT("Strings can't be NULL");
+  }
+  m = strlen(s1);
+  n = strlen(s2);
+  if(m < AUTO_MIN_LEN || n < AUTO_MIN_LEN){
+    return edit_distance_bp(s1, s2);
+  }
+  if(m + n >= UINT_MAX){
+    ERROR_EXIT("Strings too long");
+  }
+
+  // Myers explores about D^2 cells, as many as words operations of bit-parallel LCS
+  // when D is min(len) / 8; changes drift windows by at most D positions
+  budget = (m < n ? m : n) / AUTO_BUDGET_RATIO;
+  for(unsigned long i = 0; i < AUTO_SAMPLES; i++){
+    position = i * (m - AUTO_WINDOW) / (AUTO_SAMPLES - 1);
+    expected = position * n / m;
+    if(expected > n - AUTO_WINDOW){
+      expected = n - AUTO_WINDOW;
+    }
+    if(!window_found(s1 + position, s2, n, expected, budget)){
+      misses++;
+    }
+  }
+
+  // Every missed window has at least one change, so s1 has at least about
+  // misses * m / (AUTO_SAMPLES * AUTO_WINDOW) changes (miss rate of sampled characters
+  // extended to all s1). It is a lower bound: a window can hide many changes, so the
+  // estimate must be well below budget for Myers to be worth trying, otherwise it often
+  // gives up and bit-parallel LCS runs after it. Comparison is multiplied out to avoid
+  // truncation; with m close to n it accepts up to AUTO_SAMPLES / 2 missed windows.
+  if(misses * m * AUTO_ESTIMATE_MARGIN <= budget * AUTO_SAMPLES * AUTO_WINDOW){
+    result = edit_distance_myers_bounded(s1, s2, (unsigned)budget);
+    if(result <= budget){
+      return result;
+    }
+  }
+  return edit_distance_bp(s1, s2);
+}
@@ -0,0 +1,73 @@
+#ifndef _EDIT_DISTANCE_MYERS_H_
+#define _EDIT_DISTANCE_MYERS_H_
+
+#include <stdint.h>
+#include "edit_distance_script.h"
+
+/**
+ * @brief Calculate edit distance (insertions and deletions only) between two strings
+ *        with Myers' greedy O(ND) algorithm: for d = 0, 1, ... it keeps the furthest point
+ *        reached with d operations on every diagonal of the table and follows runs of
+ *        equal characters (snakes) for free, 8 characters at a time.
+ *        O((len(s1) + len(s2)) * D) time in the worst case, O(len(s1) + len(s2) + D^2)
+ *        when differences are few and scattered, O(len(s1) + len(s2)) memory.
+ *
+ * @param s1  first string, can't be NULL
+ * @param s2  second string, can't be NULL
+ * @return unsigned number of operation
+ */
+unsigned edit_distance_myers(char *s1, char *s2);
+
+/**
+ * @brief Calculate edit_distance_myers if it is not greater than bound, stopping after
+ *        bound steps: O((len(s1) + len(s2)) * bound) time, O(bound) memory.
+ *
+ * @param s1      first string, can't be NULL
+ * @param s2      second string, can't be NULL
+ * @param bound   maximum distance of interest
+ * @return unsigned number of operation if it is <= bound, bound + 1 otherwise
+ */
+unsigned edit_distance_myers_bounded(char *s1, char *s2, unsigned bound);
+
+/**
+ * @brief Calculate edit distance (insertions and deletions only) between two sequences
+ *        of 32 bit ids with the same search of edit_distance_myers_bounded, stopping after
+ *        bound steps: O((len1 + len2) * bound) time, O(bound) memory.
+ *
+ * @param seq1    first sequence, can't be NULL if len1 > 0
+ * @param len1    length of first sequence
+ * @param seq2    second sequence, can't be NULL if len2 > 0
+ * @param len2    length of second sequence
+ * @param bound   maximum distance of interest
+ * @return unsigned long number of operation if it is <= bound, bound + 1 otherwise
+ */
+unsigned long edit_distance_myers_u32_bounded(const uint32_t *seq1, unsigned long len1, const uint32_t *seq2, unsigned long len2,
+                                              unsigned long bound);
+
+/**
+ * @brief Calculate a minimum edit script (insertions and deletions only) transforming s1 into s2
+ *        with linear space variant of Myers' algorithm: greedy search runs at the same time
+ *        from start and from end of the table until the two paths meet on the middle snake,
+ *        then both halves around the snake are solved recursively.
+ *        O((len(s1) + len(s2)) * D) time, O(len(s1) + len(s2)) memory.
+ *
+ * @param s1  first string, can't be NULL
+ * @param s2  second string, can't be NULL
+ * @return EditScript* allocated script, to free with edit_script_free
+ */
+EditScript *edit_script_myers(char *s1, char *s2);
+
+/**
+ * @brief Calculate edit distance between two strings choosing the algorithm.
+ *        Windows sampled from s1 are searched near their expected position in s2 to
+ *        estimate D: if few of them are changed the distance is calculated with
+ *        edit_distance_myers_bounded, giving up when it costs as much as bit-parallel LCS,
+ *        otherwise (and for short strings) with edit_distance_bp.
+ *
+ * @param s1  first string, can't be NULL
+ * @param s2  second string, can't be NULL
+ * @return unsigned number of operation
+ */
+unsigned edit_distance_auto(char *s1, char *s2);
+
+#endif
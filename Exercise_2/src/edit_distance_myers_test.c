@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include "unity/unity.h"
+#include "edit_distance_myers.h"
+#include "edit_distance_bp.h"
+#include "edit_distance_dyn.h"
+
+static void check_script(char *s1, char *s2, unsigned distance){
+  EditScript *script = edit_script_myers(s1, s2);
+  char *result = edit_script_apply(script, s1, s2);
+
+  TEST_ASSERT_EQUAL_INT(distance, script->distance);
+  TEST_ASSERT_EQUAL_STRING(s2, result);
+  for(unsigned long r = 0; r < script->run_num; r++){
+    TEST_ASSERT_TRUE(script->runs[r].len > 0);
+    TEST_ASSERT_TRUE(r == 0 || script->runs[r].op != script->runs[r - 1].op);
+  }
+  free(result);
+  edit_script_free(script);
+}
+
+static void test_small_strings(void){
+  TEST_ASSERT_EQUAL_INT(0, edit_distance_myers("", ""));
+  TEST_ASSERT_EQUAL_INT(7, edit_distance_myers("", "welcome"));
+  TEST_ASSERT_EQUAL_INT(5, edit_distance_myers("hello", ""));
+  TEST_ASSERT_EQUAL_INT(0, edit_distance_myers("pioppo", "pioppo"));
+  TEST_ASSERT_EQUAL_INT(4, edit_distance_myers("tassa", "passato"));
+  TEST_ASSERT_EQUAL_INT(2, edit_distance_myers("casa", "cara"));
+  TEST_ASSERT_EQUAL_INT(3, edit_distance_myers("perch\xc3\xa9", "perche"));
+  check_script("", "", 0);
+  check_script("tassa", "passato", 4);
+  check_script("casa", "cara", 2);
+  check_script("abc", "xyz", 6);
+}
+
+static void test_bounded(void){
+  TEST_ASSERT_EQUAL_INT(4, edit_distance_myers_bounded("tassa", "passato", 4));
+  TEST_ASSERT_EQUAL_INT(4, edit_distance_myers_bounded("tassa", "passato", 3));
+  TEST_ASSERT_EQUAL_INT(2, edit_distance_myers_bounded("casa", "cassaforte", 1));
+  TEST_ASSERT_EQUAL_INT(0, edit_distance_myers_bounded("pioppo", "pioppo", 0));
+}
+
+static void test_same_as_dyn_random_strings(void){
+  char s1[300], s2[300];
+  uint32_t ids1[300], ids2[300];
+  unsigned distance;
+
+  srand(43);
+  for(int t = 0; t < 2000; t++){
+    // lengths around the single word limit of the selector and the 8 characters of snakes
+    int len1 = rand() % 299, len2 = (t % 2) ? rand() % 70 : rand() % 299;
+    for(int i = 0; i < len1; i++) s1[i] = (char)('a' + rand() % 3);
+    for(int i = 0; i < len2; i++) s2[i] = (char)('a' + rand() % 3);
+    s1[len1] = '\0';
+    s2[len2] = '\0';
+    distance = edit_distance_dyn(s1, s2);
+    TEST_ASSERT_EQUAL_INT(distance, edit_distance_myers(s1, s2));
+    TEST_ASSERT_EQUAL_INT(distance, edit_distance_auto(s1, s2));
+    TEST_ASSERT_EQUAL_INT(edit_distance_bounded(s1, s2, (unsigned)t % 100), edit_distance_myers_bounded(s1, s2, (unsigned)t % 100));
+    check_script(s1, s2, distance);
+
+    // same search on ids
+    for(int i = 0; i < len1; i++) ids1[i] = (uint32_t)s1[i] * 100003u;
+    for(int i = 0; i < len2; i++) ids2[i] = (uint32_t)s2[i] * 100003u;
+    TEST_ASSERT_EQUAL_UINT64(edit_distance_myers_bounded(s1, s2, (unsigned)t % 100),
+                             edit_distance_myers_u32_bounded(ids1, (unsigned long)len1, ids2, (unsigned long)len2, (unsigned long)t % 100));
+  }
+}
+
+static void test_near_identical_long_strings(void){
+  unsigned long len = 200000, k = 0;
+  char *s1 = (char *)malloc(len + 1);
+  char *s2 = (char *)malloc(len + 100);
+  unsigned distance;
+
+  srand(47);
+  for(unsigned long i = 0; i < len; i++){
+    s1[i] = (char)('a' + rand() % 26);
+  }
+  s1[len] = '\0';
+  // 80 changes spread along the string and 10 characters appended
+  for(unsigned long i = 0; i < len; i++){
+    if(i % 5000 == 17){
+      s2[k++] = 'Z';
+    }else if(i % 5000 == 2500){
+      continue;
+    }
+    s2[k++] = s1[i];
+  }
+  memcpy(&s2[k], "blockblock", 10);
+  k += 10;
+  s2[k] = '\0';
+
+  distance = edit_distance_bp(s1, s2);
+  TEST_ASSERT_EQUAL_INT(90, distance);
+  TEST_ASSERT_EQUAL_INT(distance, edit_distance_myers(s1, s2));
+  TEST_ASSERT_EQUAL_INT(distance, edit_distance_auto(s1, s2));
+  check_script(s1, s2, distance);
+  free(s1);
+  free(s2);
+}
+
+int main(void){
+
+  // test session
+  UNITY_BEGIN();
+  RUN_TEST(test_small_strings);
+  RUN_TEST(test_bounded);
+  RUN_TEST(test_same_as_dyn_random_strings);
+  RUN_TEST(test_near_identical_long_strings);
+
+  return UNITY_END();
+}
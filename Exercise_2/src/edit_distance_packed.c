@@ -0,0 +1,486 @@
+/**
+ * @file edit_distance_packed.c
+ * @author Daniele Di Palma
+ * @brief Dictionary packed by word length for nearest words search with edit distance
+ *        (insertions and deletions only)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "edit_distance_query.h"
+#include "edit_distance_packed.h"
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+#define INITIAL_CAPACITY (16)
+#define IMAGE_MAGIC ("EDPACKED")      // first 8 bytes of an image
+#define IMAGE_VERSION (1)
+#define IMAGE_BYTE_ORDER (0x0102030405060708ULL)
+#define IMAGE_ALIGN(x) (((x) + 7) & ~(unsigned long)7)
+
+/**
+ * @brief It rappresents the header of a binary image, followed by bucket_start, bucket_offset,
+ *        signatures, ids, positions and blob
+ */
+typedef struct _PackedImageHeader{
+  char magic[8];          // IMAGE_MAGIC, without terminator
+  uint32_t version;       // IMAGE_VERSION
+  uint32_t word_size;     // sizeof(unsigned long) of writer
+  uint64_t byte_order;    // IMAGE_BYTE_ORDER as stored by writer
+  uint64_t word_num;
+  uint64_t max_len;
+  uint64_t blob_size;
+  uint64_t image_size;    // size of whole image
+} PackedImageHeader;
+
+static int compare_index(const void *idx_1, const void *idx_2){
+  unsigned long idx_1_v = *(const unsigned long *)idx_1;
+  unsigned long idx_2_v = *(const unsigned long *)idx_2;
+  return (idx_1_v > idx_2_v) - (idx_1_v < idx_2_v);
+}
+
+/**
+ * @brief Calculate character presence signature of a string
+ *
+ * @param str       string
+ * @param len       length of string
+ * @return uint64_t signature, bit (c % 64) is set for every character c
+ */
+static uint64_t signature(const char *str, unsigned long len){
+  uint64_t sig = 0;
+  for(unsigned long i = 0; i < len; i++){
+    sig |= (uint64_t)1 << ((unsigned char)str[i] % 64);
+  }
+  return sig;
+}
+
+PackedDictionary *packed_dictionary_build(char **words, unsigned long word_num){
+  PackedDictionary *dictionary = NULL;
+  unsigned long *lengths = NULL, *next = NULL;
+  unsigned long pos;
+
+  if(words == NULL && word_num > 0){
+    ERROR_EXIT("Dictionary words reference can't be NULL");
+  }
+  if(word_num >= UINT32_MAX){
+    ERROR_EXIT("Too many dictionary words");
+  }
+
+  dictionary = (PackedDictionary *)malloc(sizeof(PackedDictionary));
+  lengths = (unsigned long *)malloc((word_num > 0 ? word_num : 1) * sizeof(unsigned long));
+  if(dictionary == NULL || lengths == NULL){
+    ERROR_EXIT("Unable to allocate packed dictionary");
+  }
+  dictionary->word_num = word_num;
+  dictionary->max_len = 0;
+  dictionary->image = NULL;
+  dictionary->image_size = 0;
+  for(unsigned long i = 0; i < word_num; i++){
+    lengths[i] = strlen(words[i]);
+    if(lengths[i] > dictionary->max_len){
+      dictionary->max_len = lengths[i];
+    }
+  }
+
+  dictionary->bucket_start = (unsigned long *)calloc(dictionary->max_len + 2, sizeof(unsigned long));
+  dictionary->bucket_offset = (unsigned long *)malloc((dictionary->max_len + 1) * sizeof(unsigned long));
+  next = (unsigned long *)malloc((dictionary->max_len + 1) * sizeof(unsigned long));
+  if(dictionary->bucket_start == NULL || dictionary->bucket_offset == NULL || next == NULL){
+    ERROR_EXIT("Unable to allocate buckets");
+  }
+
+  // counting sort of words by length, stable so buckets keep dictionary order
+  for(unsigned long i = 0; i < word_num; i++){
+    dictionary->bucket_start[lengths[i] + 1]++;
+  }
+  dictionary->blob_size = 0;
+  for(unsigned long len = 0; len <= dictionary->max_len; len++){
+    dictionary->bucket_offset[len] = dictionary->blob_size;
+    dictionary->blob_size += dictionary->bucket_start[len + 1] * (len + 1);
+    dictionary->bucket_start[len + 1] += dictionary->bucket_start[len];
+    next[len] = dictionary->bucket_start[len];
+  }
+
+  dictionary->blob = (char *)malloc(dictionary->blob_size > 0 ? dictionary->blob_size : 1);
+  dictionary->ids = (uint32_t *)malloc((word_num > 0 ? word_num : 1) * sizeof(uint32_t));
+  dictionary->positions = (uint32_t *)malloc((word_num > 0 ? word_num : 1) * sizeof(uint32_t));
+  dictionary->signatures = (uint64_t *)malloc((word_num > 0 ? word_num : 1) * sizeof(uint64_t));
+  if(dictionary->blob == NULL || dictionary->ids == NULL || dictionary->positions == NULL || dictionary->signatures == NULL){
+    ERROR_EXIT("Unable to allocate packed words");
+  }
+
+  for(unsigned long i = 0; i < word_num; i++){
+    pos = next[lengths[i]]++;
+    memcpy(&dictionary->blob[dictionary->bucket_offset[lengths[i]] + (pos - dictionary->bucket_start[lengths[i]]) * (lengths[i] + 1)], words[i], lengths[i] + 1);
+    dictionary->ids[pos] = (uint32_t)i;
+    dictionary->positions[i] = (uint32_t)pos;
+    dictionary->signatures[pos] = signature(words[i], lengths[i]);
+  }
+
+  free(lengths);
+  free(next);
+  return dictionary;
+}
+
+char *packed_dictionary_word(const PackedDictionary *dictionary, unsigned long id){
+  unsigned long pos, len = 0;
+
+  if(dictionary == NULL){
+    ERROR_EXIT("Packed dictionary reference can't be NULL");
+  }
+  if(id >= dictionary->word_num){
+    ERROR_EXIT("Word index out of dictionary");
+  }
+
+  pos = dictionary->positions[id];
+  // bucket of position: few buckets, words are rarely long
+  while(dictionary->bucket_start[len + 1] <= pos){
+    len++;
+  }
+  return &dictionary->blob[dictionary->bucket_offset[len] + (pos - dictionary->bucket_start[len]) * (len + 1)];
+}
+
+unsigned packed_search_min_with(const PackedDictionary *dictionary, const char *word, unsigned max_distance,
+                                PackedScorer scorer, void *context, unsigned long batch_size,
+                                unsigned long **results, unsigned long *result_num){
+  char **batch = NULL;
+  unsigned long *batch_pos = NULL, *found = NULL;
+  unsigned *batch_results = NULL;
+  unsigned long found_num = 0, found_capacity = INITIAL_CAPACITY, word_len, len, delta, max_delta, batch_num, pos;
+  unsigned radius = max_distance, best;
+  uint64_t sig;
+  char *bucket;
+
+  if(dictionary == NULL){
+    ERROR_EXIT("Packed dictionary reference can't be NULL");
+  }
+  if(word == NULL){
+    ERROR_EXIT("Word to search is NULL");
+  }
+  if(scorer == NULL || batch_size == 0){
+    ERROR_EXIT("Scorer can't be NULL and batch size must be positive");
+  }
+  if(results == NULL || result_num == NULL){
+    ERROR_EXIT("Results references can't be NULL");
+  }
+
+  best = (max_distance == UINT_MAX) ? UINT_MAX : max_distance + 1;
+  *results = NULL;
+  *result_num = 0;
+
+  found = (unsigned long *)malloc(found_capacity * sizeof(unsigned long));
+  batch = (char **)malloc(batch_size * sizeof(char *));
+  batch_pos = (unsigned long *)malloc(batch_size * sizeof(unsigned long));
+  batch_results = (unsigned *)malloc(batch_size * sizeof(unsigned));
+  if(found == NULL || batch == NULL || batch_pos == NULL || batch_results == NULL){
+    ERROR_EXIT("Unable to allocate memory for search");
+  }
+  word_len = strlen(word);
+  sig = signature(word, word_len);
+  max_delta = (word_len > dictionary->max_len) ? word_len : dictionary->max_len;
+
+  // length difference is a lower bound of distance: nearest lengths first
+  for(delta = 0; delta <= max_delta && delta <= radius; delta++){
+    for(int side = 0; side < 2; side++){
+      if(side == 0){
+        if(delta > word_len){
+          continue;
+        }
+        len = word_len - delta;
+      }else{
+        if(delta == 0 || word_len + delta > dictionary->max_len){
+          continue;
+        }
+        len = word_len + delta;
+      }
+      if(len > dictionary->max_len){
+        continue;
+      }
+
+      // radius can shrink after every batch, below length difference of bucket
+      bucket = &dictionary->blob[dictionary->bucket_offset[len]];
+      pos = dictionary->bucket_start[len];
+      while(pos < dictionary->bucket_start[len + 1] && delta <= radius){
+        batch_num = 0;
+        for(; pos < dictionary->bucket_start[len + 1] && batch_num < batch_size; pos++){
+          if((unsigned)__builtin_popcountll(sig ^ dictionary->signatures[pos]) <= radius){
+            batch[batch_num] = &bucket[(pos - dictionary->bucket_start[len]) * (len + 1)];
+            batch_pos[batch_num++] = pos;
+          }
+        }
+        if(batch_num == 0){
+          continue;
+        }
+        scorer(context, batch, len, batch_num, radius, batch_results);
+
+        for(unsigned long k = 0; k < batch_num; k++){
+          if(batch_results[k] > radius){
+            continue;
+          }
+          if(batch_results[k] < best){
+            best = batch_results[k];
+            radius = best;
+            found_num = 0;
+          }
+          if(found_num >= found_capacity){
+            found_capacity *= 2;
+            found = (unsigned long *)realloc(found, found_capacity * sizeof(unsigned long));
+            if(found == NULL){
+              ERROR_EXIT("Unable to re-allocate found words");
+            }
+          }
+          found[found_num++] = dictionary->ids[batch_pos[k]];
+        }
+      }
+    }
+  }
+  free(batch);
+  free(batch_pos);
+  free(batch_results);
+
+  if(found_num == 0){
+    free(found);
+    return best;
+  }
+  qsort(found, found_num, sizeof(unsigned long), compare_index);
+  *results = found;
+  *result_num = found_num;
+  return best;
+}
+
+/**
+ * @brief Score candidates one at a time with bit-parallel LCS, as PackedScorer
+ *
+ * @param context     prepared query (EdQuery *)
+ * @param candidates  candidates
+ * @param cand_len    length of every candidate
+ * @param cand_num    number of candidates
+ * @param radius      distances greater than radius are not calculated exactly
+ * @param results     distance of every candidate
+ */
+static void query_scorer(void *context, char **candidates, unsigned long cand_len, unsigned long cand_num, unsigned radius, unsigned *results){
+  for(unsigned long k = 0; k < cand_num; k++){
+    results[k] = ed_query_distance_len((const EdQuery *)context, candidates[k], cand_len, radius);
+  }
+}
+
+unsigned packed_search_min(const PackedDictionary *dictionary, const char *word, unsigned max_distance, unsigned long **results, unsigned long *result_num){
+  EdQuery *query;
+  unsigned best;
+
+  if(word == NULL){
+    ERROR_EXIT("Word to search is NULL");
+  }
+  query = ed_query_build(word);
+  best = packed_search_min_with(dictionary, word, max_distance, query_scorer, query, 1, results, result_num);
+  ed_query_free(query);
+  return best;
+}
+
+unsigned long packed_dictionary_size(const PackedDictionary *dictionary){
+  if(dictionary == NULL){
+    ERROR_EXIT("Packed dictionary reference can't be NULL");
+  }
+  return sizeof(PackedDictionary) + dictionary->blob_size
+          + dictionary->word_num * (2 * sizeof(uint32_t) + sizeof(uint64_t))
+          + (2 * dictionary->max_len + 3) * sizeof(unsigned long);
+}
+
+/**
+ * @brief Calculate offsets of arrays in an image
+ *
+ * @param word_num    number of words
+ * @param max_len     length of longest word
+ * @param offsets     address where offsets of bucket_start, bucket_offset, signatures, ids, positions and blob are stored
+ * @param blob_size   size of blob
+ * @return unsigned long size of image
+ */
+static unsigned long image_layout(unsigned long word_num, unsigned long max_len, unsigned long blob_size, unsigned long offsets[6]){
+  offsets[0] = IMAGE_ALIGN(sizeof(PackedImageHeader));
+  offsets[1] = IMAGE_ALIGN(offsets[0] + (max_len + 2) * sizeof(unsigned long));
+  offsets[2] = IMAGE_ALIGN(offsets[1] + (max_len + 1) * sizeof(unsigned long));
+  offsets[3] = IMAGE_ALIGN(offsets[2] + word_num * sizeof(uint64_t));
+  offsets[4] = IMAGE_ALIGN(offsets[3] + word_num * sizeof(uint32_t));
+  offsets[5] = IMAGE_ALIGN(offsets[4] + word_num * sizeof(uint32_t));
+  return offsets[5] + blob_size;
+}
+
+/**
+ * @brief Write an array at its offset of image, padding from current position of file
+ */
+static void write_section(FILE *fp, unsigned long offset, const void *data, unsigned long size){
+  static const char padding[8] = {0};
+  long position = ftell(fp);
+
+  if(position < 0 || (unsigned long)position > offset ||
+     fwrite(padding, 1, offset - (unsigned long)position, fp) != offset - (unsigned long)position ||
+     (size > 0 && fwrite(data, 1, size, fp) != size)){
+    ERROR_EXIT("Unable to write dictionary image");
+  }
+}
+
+void packed_dictionary_save(const PackedDictionary *dictionary, const char *path){
+  PackedImageHeader header;
+  unsigned long offsets[6];
+  char *tmp_path = NULL;
+  FILE *fp = NULL;
+
+  if(dictionary == NULL || path == NULL){
+    ERROR_EXIT("Packed dictionary and path can't be NULL");
+  }
+  memset(&header, 0, sizeof(PackedImageHeader));
+  memcpy(header.magic, IMAGE_MAGIC, sizeof(header.magic));
+  header.version = IMAGE_VERSION;
+  header.word_size = (uint32_t)sizeof(unsigned long);
+  header.byte_order = IMAGE_BYTE_ORDER;
+  header.word_num = dictionary->word_num;
+  header.max_len = dictionary->max_len;
+  header.blob_size = dictionary->blob_size;
+  header.image_size = image_layout(dictionary->word_num, dictionary->max_len, dictionary->blob_size, offsets);
+
+  tmp_path = (char *)malloc(strlen(path) + 5);
+  if(tmp_path == NULL){
+    ERROR_EXIT("Unable to allocate path");
+  }
+  strcpy(tmp_path, path);
+  strcat(tmp_path, ".tmp");
+  fp = fopen(tmp_path, "wb");
+  if(fp == NULL){
+    ERROR_EXIT("Unable to create dictionary image");
+  }
+  write_section(fp, 0, &header, sizeof(PackedImageHeader));
+  write_section(fp, offsets[0], dictionary->bucket_start, (dictionary->max_len + 2) * sizeof(unsigned long));
+  write_section(fp, offsets[1], dictionary->bucket_offset, (dictionary->max_len + 1) * sizeof(unsigned long));
+  write_section(fp, offsets[2], dictionary->signatures, dictionary->word_num * sizeof(uint64_t));
+  write_section(fp, offsets[3], dictionary->ids, dictionary->word_num * sizeof(uint32_t));
+  write_section(fp, offsets[4], dictionary->positions, dictionary->word_num * sizeof(uint32_t));
+  write_section(fp, offsets[5], dictionary->blob, dictionary->blob_size);
+  if(fclose(fp) != 0 || rename(tmp_path, path) != 0){
+    ERROR_EXIT("Unable to write dictionary image");
+  }
+  free(tmp_path);
+}
+
+int packed_dictionary_is_image(const char *path){
+  char magic[8];
+  FILE *fp = NULL;
+  int is_image;
+
+  if(path == NULL){
+    ERROR_EXIT("Path can't be NULL");
+  }
+  fp = fopen(path, "rb");
+  if(fp == NULL){
+    return 0;
+  }
+  is_image = fread(magic, 1, sizeof(magic), fp) == sizeof(magic) && memcmp(magic, IMAGE_MAGIC, sizeof(magic)) == 0;
+  fclose(fp);
+  return is_image;
+}
+
+PackedDictionary *packed_dictionary_map(const char *path){
+  PackedDictionary *dictionary = NULL;
+  const PackedImageHeader *header = NULL;
+  unsigned long offsets[6];
+  struct stat file_stat;
+  char *image = NULL;
+  int fd;
+
+  if(path == NULL){
+    ERROR_EXIT("Path can't be NULL");
+  }
+  fd = open(path, O_RDONLY);
+  if(fd < 0 || fstat(fd, &file_stat) != 0){
+    ERROR_EXIT("Unable to open dictionary image");
+  }
+  if((unsigned long)file_stat.st_size < sizeof(PackedImageHeader)){
+    ERROR_EXIT("Dictionary image too short");
+  }
+  image = (char *)mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  if(image == MAP_FAILED){
+    ERROR_EXIT("Unable to map dictionary image");
+  }
+  close(fd);
+
+  header = (const PackedImageHeader *)image;
+  if(memcmp(header->magic, IMAGE_MAGIC, sizeof(header->magic)) != 0 || header->version != IMAGE_VERSION ||
+     header->word_size != sizeof(unsigned long) || header->byte_order != IMAGE_BYTE_ORDER){
+    ERROR_EXIT("Dictionary image of another version or architecture");
+  }
+  if(header->word_num >= UINT32_MAX || header->max_len >= (uint64_t)file_stat.st_size ||
+     header->blob_size >= (uint64_t)file_stat.st_size || header->image_size != (uint64_t)file_stat.st_size ||
+     image_layout(header->word_num, header->max_len, header->blob_size, offsets) != header->image_size){
+    ERROR_EXIT("Corrupted dictionary image");
+  }
+
+  dictionary = (PackedDictionary *)malloc(sizeof(PackedDictionary));
+  if(dictionary == NULL){
+    ERROR_EXIT("Unable to allocate packed dictionary");
+  }
+  dictionary->word_num = header->word_num;
+  dictionary->max_len = header->max_len;
+  dictionary->blob_size = header->blob_size;
+  dictionary->bucket_start = (unsigned long *)&image[offsets[0]];
+  dictionary->bucket_offset = (unsigned long *)&image[offsets[1]];
+  dictionary->signatures = (uint64_t *)&image[offsets[2]];
+  dictionary->ids = (uint32_t *)&image[offsets[3]];
+  dictionary->positions = (uint32_t *)&image[offsets[4]];
+  dictionary->blob = &image[offsets[5]];
+  dictionary->image = image;
+  dictionary->image_size = header->image_size;
+
+  // buckets are used to index blob and arrays
+  if(dictionary->bucket_start[0] != 0 || dictionary->bucket_start[dictionary->max_len + 1] != dictionary->word_num){
+    ERROR_EXIT("Corrupted dictionary image");
+  }
+  for(unsigned long len = 0; len <= dictionary->max_len; len++){
+    if(dictionary->bucket_start[len + 1] < dictionary->bucket_start[len] ||
+       dictionary->bucket_offset[len] != (len > 0 ? dictionary->bucket_offset[len - 1] + (dictionary->bucket_start[len] - dictionary->bucket_start[len - 1]) * len : 0)){
+      ERROR_EXIT("Corrupted dictionary image");
+    }
+  }
+  if(dictionary->bucket_offset[dictionary->max_len] + (dictionary->word_num - dictionary->bucket_start[dictionary->max_len]) * (dictionary->max_len + 1) != dictionary->blob_size){
+    ERROR_EXIT("Corrupted dictionary image");
+  }
+
+  // positions and ids are used to index arrays, words of a bucket must have its length
+  for(unsigned long i = 0; i < dictionary->word_num; i++){
+    if(dictionary->positions[i] >= dictionary->word_num || dictionary->ids[dictionary->positions[i]] != i){
+      ERROR_EXIT("Corrupted dictionary image");
+    }
+  }
+  for(unsigned long len = 0; len <= dictionary->max_len; len++){
+    const char *word = &dictionary->blob[dictionary->bucket_offset[len]];
+    for(unsigned long pos = dictionary->bucket_start[len]; pos < dictionary->bucket_start[len + 1]; pos++, word += len + 1){
+      if(word[len] != '\0' || memchr(word, '\0', len) != NULL){
+        ERROR_EXIT("Corrupted dictionary image");
+      }
+    }
+  }
+  return dictionary;
+}
+
+void packed_dictionary_free(PackedDictionary *dictionary){
+  if(dictionary != NULL && dictionary->image != NULL){
+    munmap(dictionary->image, dictionary->image_size);
+    free(dictionary);
+  }else if(dictionary != NULL){
+    free(dictionary->blob);
+    free(dictionary->ids);
+    free(dictionary->positions);
+    free(dictionary->signatures);
+    free(dictionary->bucket_start);
+    free(dictionary->bucket_offset);
+    free(dictionary);
+  }
+}
@@ -0,0 +1,138 @@
+#ifndef _EDIT_DISTANCE_PACKED_H_
+#define _EDIT_DISTANCE_PACKED_H_
+
+#include <stdint.h>
+
+/**
+ * @brief It rappresents a dictionary packed in a single blob with words grouped by length:
+ *        bucket of length L is a contiguous array of strings of L + 1 bytes (terminator included),
+ *        so a word is found from its position without offsets.
+ *        Every word has a 64 bit signature with bit (c % 64) set for every character c in it:
+ *        characters in only one of two words need at least one insertion or deletion each,
+ *        so popcount of xor of signatures is a lower bound of distance.
+ */
+typedef struct _PackedDictionary{
+  char *blob;                   // words grouped by length, in dictionary order in every bucket
+  unsigned long blob_size;      // size of blob in bytes
+  uint32_t *ids;                // dictionary index of every packed word
+  uint32_t *positions;          // packed position of every dictionary word
+  uint64_t *signatures;         // character presence signature of every packed word
+  unsigned long *bucket_start;  // first packed word of every length, max_len + 2 entries
+  unsigned long *bucket_offset; // offset in blob of every bucket, max_len + 1 entries
+  unsigned long max_len;        // length of longest word
+  unsigned long word_num;       // number of words
+  void *image;                  // mapped image all arrays point into, NULL if dictionary was built
+  unsigned long image_size;     // size of mapped image
+} PackedDictionary;
+
+/**
+ * @brief Build packed dictionary copying dictionary words.
+ *
+ * @param words     array of dictionary words, can't be NULL if word_num > 0
+ * @param word_num  number of words, less than 2^32
+ * @return PackedDictionary* allocated dictionary, to free with packed_dictionary_free
+ */
+PackedDictionary *packed_dictionary_build(char **words, unsigned long word_num);
+
+/**
+ * @brief Get a word of packed dictionary
+ *
+ * @param dictionary    packed dictionary, can't be NULL
+ * @param id            index of word in original dictionary
+ * @return char*        word stored in packed dictionary
+ */
+char *packed_dictionary_word(const PackedDictionary *dictionary, unsigned long id);
+
+/**
+ * @brief Calculate distance between searched word and candidates of the same length
+ *
+ * @param context     data given to packed_search_min_with
+ * @param candidates  candidates, words of packed dictionary
+ * @param cand_len    length of every candidate
+ * @param cand_num    number of candidates, from 1 to batch size given to packed_search_min_with
+ * @param radius      distances greater than radius can be any value greater than radius
+ * @param results     array of cand_num results, results[i] is distance of candidates[i]
+ */
+typedef void (*PackedScorer)(void *context, char **candidates, unsigned long cand_len, unsigned long cand_num, unsigned radius, unsigned *results);
+
+/**
+ * @brief Search all dictionary words at minimum distance from word.
+ *        Buckets are visited in order of length difference from word, until it exceeds
+ *        best distance found; candidates are skipped if signature lower bound exceeds it.
+ *
+ * @param dictionary    packed dictionary, can't be NULL
+ * @param word          word to search, can't be NULL
+ * @param max_distance  max distance of interest, UINT_MAX for no limit
+ * @param results       address where an allocated array of indexes of found words is stored,
+ *                      in dictionary order, to free by caller (NULL if no word is found)
+ * @param result_num    address where number of found words is stored
+ * @return unsigned     minimum distance, max_distance + 1 if no word is found (UINT_MAX if max_distance is UINT_MAX)
+ */
+unsigned packed_search_min(const PackedDictionary *dictionary, const char *word, unsigned max_distance, unsigned long **results, unsigned long *result_num);
+
+/**
+ * @brief Search all dictionary words at minimum distance from word as packed_search_min,
+ *        candidates of a bucket passing signature filter are given to scorer in batches.
+ *
+ * @param dictionary    packed dictionary, can't be NULL
+ * @param word          word to search, can't be NULL
+ * @param max_distance  max distance of interest, UINT_MAX for no limit
+ * @param scorer        function calculating distances of a batch, can't be NULL
+ * @param context       data given to scorer
+ * @param batch_size    max number of candidates of a batch, greater than 0
+ * @param results       address where an allocated array of indexes of found words is stored,
+ *                      in dictionary order, to free by caller (NULL if no word is found)
+ * @param result_num    address where number of found words is stored
+ * @return unsigned     minimum distance, max_distance + 1 if no word is found (UINT_MAX if max_distance is UINT_MAX)
+ */
+unsigned packed_search_min_with(const PackedDictionary *dictionary, const char *word, unsigned max_distance,
+                                PackedScorer scorer, void *context, unsigned long batch_size,
+                                unsigned long **results, unsigned long *result_num);
+
+/**
+ * @brief Calculate memory used by packed dictionary
+ *
+ * @param dictionary      packed dictionary, can't be NULL
+ * @return unsigned long  size in bytes
+ */
+unsigned long packed_dictionary_size(const PackedDictionary *dictionary);
+
+/**
+ * @brief Write packed dictionary in a binary image: a versioned header followed by arrays
+ *        and blob as they are in memory, every array aligned to 8 bytes.
+ *        Image is written in a temporary file renamed to path, so processes mapping
+ *        an old image at path are not affected.
+ *
+ * @param dictionary  packed dictionary, can't be NULL
+ * @param path        path of image, can't be NULL
+ */
+void packed_dictionary_save(const PackedDictionary *dictionary, const char *path);
+
+/**
+ * @brief Check if a file is an image written by packed_dictionary_save
+ *
+ * @param path  path of file, can't be NULL
+ * @return int  1 if file starts with image magic, 0 otherwise (also if it can't be read)
+ */
+int packed_dictionary_is_image(const char *path);
+
+/**
+ * @brief Map a binary image read-only: arrays of dictionary point into the mapping, so nothing
+ *        is copied and pages are shared between processes mapping the same image.
+ *        Header, buckets, ids, positions and word terminators are checked before use
+ *        (signatures are only a filter), image must have been written by a build with
+ *        same version, word size and byte order.
+ *
+ * @param path  path of image, can't be NULL
+ * @return PackedDictionary* mapped dictionary, to free with packed_dictionary_free
+ */
+PackedDictionary *packed_dictionary_map(const char *path);
+
+/**
+ * @brief Free packed dictionary
+ *
+ * @param dictionary  dictionary to free
+ */
+void packed_dictionary_free(PackedDictionary *dictionary);
+
+#endif
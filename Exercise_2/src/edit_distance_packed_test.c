@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include "unity/unity.h"
+#include "edit_distance_packed.h"
+#include "edit_distance_index_test.h"
+
+static char *dictionary[] = {"casa", "cassa", "cosa", "tassa", "passato", "casa", "pioppo", "cara", "a", ""};
+static const unsigned long dictionary_num = 10;
+
+static void test_empty_dictionary(void){
+  PackedDictionary *packed = packed_dictionary_build(NULL, 0);
+  unsigned long *found, found_num;
+
+  TEST_ASSERT_EQUAL_INT(UINT_MAX, packed_search_min(packed, "casa", UINT_MAX, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(0, found_num);
+  TEST_ASSERT_NULL(found);
+  packed_dictionary_free(packed);
+}
+
+static void test_length_buckets(void){
+  char *words[] = {"casa", "a", "cassa", "", "cosa", "passato"};
+  PackedDictionary *packed = packed_dictionary_build(words, 6);
+  unsigned long exp_start[] = {0, 1, 2, 2, 2, 4, 5, 5, 6};
+  unsigned long exp_offset[] = {0, 1, 3, 3, 3, 13, 19, 19};
+
+  TEST_ASSERT_EQUAL_UINT64(7, packed->max_len);
+  TEST_ASSERT_EQUAL_UINT64(27, packed->blob_size);
+  for(unsigned long len = 0; len <= packed->max_len + 1; len++){
+    TEST_ASSERT_EQUAL_UINT64(exp_start[len], packed->bucket_start[len]);
+  }
+  for(unsigned long len = 0; len <= packed->max_len; len++){
+    TEST_ASSERT_EQUAL_UINT64(exp_offset[len], packed->bucket_offset[len]);
+  }
+
+  // bucket of length 4 holds "casa" and "cosa" in dictionary order, without offsets
+  TEST_ASSERT_EQUAL_MEMORY("casa\0cosa\0", &packed->blob[packed->bucket_offset[4]], 10);
+  TEST_ASSERT_EQUAL_UINT32(0, packed->ids[2]);
+  TEST_ASSERT_EQUAL_UINT32(4, packed->ids[3]);
+  for(uint32_t i = 0; i < 6; i++){
+    TEST_ASSERT_EQUAL_UINT32(i, packed->ids[packed->positions[i]]);
+  }
+  packed_dictionary_free(packed);
+}
+
+static void test_length_lower_bound(void){
+  char *words[] = {"a", "abcdefghij"};
+  PackedDictionary *packed = packed_dictionary_build(words, 2);
+  unsigned long *found, found_num;
+
+  TEST_ASSERT_EQUAL_INT(1, packed_search_min(packed, "abcdefghijk", 1, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(1, found_num);
+  TEST_ASSERT_EQUAL_UINT64(1, found[0]);
+  free(found);
+
+  // length differences are 5 and 4
+  TEST_ASSERT_EQUAL_INT(4, packed_search_min(packed, "abcdef", 3, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(0, found_num);
+  TEST_ASSERT_NULL(found);
+  packed_dictionary_free(packed);
+}
+
+static void test_signature_lower_bound(void){
+  char *words[] = {"ab", "a!", "wxyz"}, **random;
+  PackedDictionary *packed = packed_dictionary_build(words, 3), *random_packed;
+  unsigned long *found, found_num;
+  uint64_t sig_i, sig_j;
+
+  TEST_ASSERT_EQUAL_HEX64((1ULL << ('a' % 64)) | (1ULL << ('b' % 64)), packed->signatures[packed->positions[0]]);
+
+  // '!' and 'a' share a bit: the bound is lower, the word is still found
+  TEST_ASSERT_EQUAL_HEX64(1ULL << ('a' % 64), packed->signatures[packed->positions[1]]);
+  TEST_ASSERT_EQUAL_INT(1, packed_search_min(packed, "!", UINT_MAX, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(1, found_num);
+  TEST_ASSERT_EQUAL_UINT64(1, found[0]);
+  free(found);
+  packed_dictionary_free(packed);
+
+  // popcount of xor never exceeds distance
+  srand(71);
+  random = random_words(200, 10, 8);
+  random_packed = packed_dictionary_build(random, 200);
+  for(uint32_t i = 0; i < 200; i++){
+    sig_i = random_packed->signatures[random_packed->positions[i]];
+    for(uint32_t j = 0; j < 200; j++){
+      sig_j = random_packed->signatures[random_packed->positions[j]];
+      TEST_ASSERT_TRUE((unsigned)__builtin_popcountll(sig_i ^ sig_j) <= edit_distance_dyn(random[i], random[j]));
+    }
+  }
+  packed_dictionary_free(random_packed);
+  free_random_words(random, 200);
+}
+
+static void test_packed_words(void){
+  PackedDictionary *packed = packed_dictionary_build(dictionary, dictionary_num);
+
+  for(unsigned long i = 0; i < dictionary_num; i++){
+    TEST_ASSERT_EQUAL_STRING(dictionary[i], packed_dictionary_word(packed, i));
+  }
+  TEST_ASSERT_TRUE(packed_dictionary_size(packed) > packed->blob_size);
+  packed_dictionary_free(packed);
+}
+
+static unsigned search_min(const void *packed, const char *word, unsigned max_distance, unsigned long **results, unsigned long *result_num){
+  return packed_search_min((const PackedDictionary *)packed, word, max_distance, results, result_num);
+}
+
+static void test_same_as_linear_scan(void){
+  char **words;
+  PackedDictionary *packed;
+
+  srand(29);
+  words = random_words(2000, 10, 4);
+  packed = packed_dictionary_build(words, 2000);
+  assert_same_as_linear_scan(packed, search_min, words, 2000, UINT_MAX, 200, 12, 4);
+  assert_same_as_linear_scan(packed, search_min, words, 2000, 1, 200, 12, 4);
+  packed_dictionary_free(packed);
+  free_random_words(words, 2000);
+}
+
+static void test_mapped_image(void){
+  char path[] = "/tmp/packed_test_XXXXXX";
+  int fd = mkstemp(path);
+  PackedDictionary *packed = packed_dictionary_build(dictionary, dictionary_num), *mapped;
+  unsigned long *found, found_num, *mapped_found, mapped_found_num;
+  char *queries[] = {"casa", "cas", "pippo", "zzzzzzzz", ""};
+
+  TEST_ASSERT_TRUE(fd >= 0);
+  close(fd);
+  TEST_ASSERT_FALSE(packed_dictionary_is_image(path));
+  packed_dictionary_save(packed, path);
+  TEST_ASSERT_TRUE(packed_dictionary_is_image(path));
+  mapped = packed_dictionary_map(path);
+
+  TEST_ASSERT_NOT_NULL(mapped->image);
+  TEST_ASSERT_EQUAL_UINT64(packed->word_num, mapped->word_num);
+  TEST_ASSERT_EQUAL_UINT64(packed->max_len, mapped->max_len);
+  for(unsigned long i = 0; i < dictionary_num; i++){
+    TEST_ASSERT_EQUAL_STRING(dictionary[i], packed_dictionary_word(mapped, i));
+  }
+  for(int q = 0; q < 5; q++){
+    TEST_ASSERT_EQUAL_INT(packed_search_min(packed, queries[q], UINT_MAX, &found, &found_num),
+                          packed_search_min(mapped, queries[q], UINT_MAX, &mapped_found, &mapped_found_num));
+    TEST_ASSERT_EQUAL_UINT64(found_num, mapped_found_num);
+    for(unsigned long i = 0; i < found_num; i++){
+      TEST_ASSERT_EQUAL_UINT64(found[i], mapped_found[i]);
+    }
+    free(found);
+    free(mapped_found);
+  }
+  packed_dictionary_free(mapped);
+  packed_dictionary_free(packed);
+
+  // empty dictionary
+  packed = packed_dictionary_build(NULL, 0);
+  packed_dictionary_save(packed, path);
+  mapped = packed_dictionary_map(path);
+  TEST_ASSERT_EQUAL_UINT64(0, mapped->word_num);
+  packed_dictionary_free(mapped);
+  packed_dictionary_free(packed);
+  unlink(path);
+}
+
+/**
+ * @brief Map an image in a child process, corrupted images make packed_dictionary_map exit
+ *
+ * @param path  path of image
+ * @return int  1 if child exited with failure
+ */
+static int map_fails(const char *path){
+  int status;
+  pid_t pid = fork();
+
+  TEST_ASSERT_TRUE(pid >= 0);
+  if(pid == 0){
+    freopen("/dev/null", "w", stderr);
+    packed_dictionary_free(packed_dictionary_map(path));
+    _exit(EXIT_SUCCESS);
+  }
+  TEST_ASSERT_EQUAL_INT(pid, waitpid(pid, &status, 0));
+  return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_FAILURE;
+}
+
+/**
+ * @brief Save a valid image of dictionary and overwrite some bytes of it
+ *
+ * @param path    path of image
+ * @param offset  offset of bytes in image
+ * @param data    new bytes
+ * @param size    number of bytes
+ */
+static void save_corrupted(const char *path, long offset, const void *data, unsigned long size){
+  PackedDictionary *packed = packed_dictionary_build(dictionary, dictionary_num);
+  int fd;
+
+  packed_dictionary_save(packed, path);
+  packed_dictionary_free(packed);
+  fd = open(path, O_WRONLY);
+  TEST_ASSERT_TRUE(fd >= 0);
+  TEST_ASSERT_EQUAL_INT((long)size, pwrite(fd, data, size, offset));
+  close(fd);
+}
+
+static void test_corrupted_image(void){
+  char path[] = "/tmp/packed_test_XXXXXX";
+  int fd = mkstemp(path);
+  PackedDictionary *packed = packed_dictionary_build(dictionary, dictionary_num), *mapped;
+  long positions, ids, blob;
+  uint32_t out_of_range = 10, other_id = 1;
+  char letter = 'x';
+
+  TEST_ASSERT_TRUE(fd >= 0);
+  close(fd);
+  packed_dictionary_save(packed, path);
+  mapped = packed_dictionary_map(path);
+  positions = (char *)mapped->positions - (char *)mapped->image;
+  ids = (char *)mapped->ids - (char *)mapped->image;
+  blob = mapped->blob - (char *)mapped->image;
+  TEST_ASSERT_FALSE(map_fails(path));
+
+  // position past the last word
+  save_corrupted(path, positions, &out_of_range, sizeof(uint32_t));
+  TEST_ASSERT_TRUE(map_fails(path));
+
+  // id not matching position of word 0
+  save_corrupted(path, ids + (long)(mapped->positions[0] * sizeof(uint32_t)), &other_id, sizeof(uint32_t));
+  TEST_ASSERT_TRUE(map_fails(path));
+
+  // terminator of "casa" in the bucket of length 4
+  save_corrupted(path, blob + (long)mapped->bucket_offset[4] + 4, &letter, 1);
+  TEST_ASSERT_TRUE(map_fails(path));
+
+  // terminator inside a word of the bucket of length 5
+  letter = '\0';
+  save_corrupted(path, blob + (long)mapped->bucket_offset[5] + 2, &letter, 1);
+  TEST_ASSERT_TRUE(map_fails(path));
+
+  packed_dictionary_free(mapped);
+  packed_dictionary_free(packed);
+  unlink(path);
+}
+
+int main(void){
+
+  // test session
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_dictionary);
+  RUN_TEST(test_length_buckets);
+  RUN_TEST(test_length_lower_bound);
+  RUN_TEST(test_signature_lower_bound);
+  RUN_TEST(test_packed_words);
+  RUN_TEST(test_same_as_linear_scan);
+  RUN_TEST(test_mapped_image);
+  RUN_TEST(test_corrupted_image);
+
+  return UNITY_END();
+}
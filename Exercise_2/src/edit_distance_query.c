@@ -0,0 +1,180 @@
+/**
+ * @file edit_distance_query.c
+ * @author Daniele Di Palma
+ * @brief Edit distance (insertions and deletions only) of a preprocessed query word
+ *        against many candidates
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include "edit_distance_query.h"
+#include "edit_distance_bp.h"
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+#define WORD_BITS (64)
+#define STACK_WORDS (16)
+
+/**
+ * @brief Calculate lower bound of distance from character histograms: every insertion
+ *        or deletion changes one count by one, so distance is at least
+ *        len(query) + len(candidate) - 2 * sum over c of min(query count, candidate count).
+ *        Only counters of characters in candidate are initialized and read.
+ *
+ * @param query     preprocessed query
+ * @param candidate candidate string
+ * @param cand_len  length of candidate
+ * @return unsigned long lower bound of distance
+ */
+static unsigned long histogram_lower_bound(const EdQuery *query, const unsigned char *candidate, unsigned long cand_len){
+  unsigned used[QUERY_ALPHABET_SIZE];
+  unsigned long common = 0;
+
+  for(unsigned long j = 0; j < cand_len; j++){
+    used[candidate[j]] = 0;
+  }
+  for(unsigned long j = 0; j < cand_len; j++){
+    common += (used[candidate[j]]++ < query->histogram[candidate[j]]);
+  }
+  return query->len + cand_len - 2 * common;
+}
+
+/**
+ * @brief Calculate LCS length of query word and candidate with bit-parallel recurrence
+ *        (see edit_distance_bp.c) on the precomputed Peq table.
+ *
+ * @param query     preprocessed query, query->len > 0
+ * @param candidate candidate string
+ * @param cand_len  length of candidate
+ * @return unsigned long length of LCS
+ */
+static unsigned long query_lcs(const EdQuery *query, const unsigned char *candidate, unsigned long cand_len){
+  uint64_t stack_v[STACK_WORDS];
+  uint64_t *v = stack_v, *peq_c;
+  uint64_t u, last_mask;
+  unsigned long words = query->words, lcs = 0;
+
+  last_mask = (query->len % WORD_BITS == 0) ? ~(uint64_t)0 : (((uint64_t)1 << (query->len % WORD_BITS)) - 1);
+
+  if(words == 1){
+    uint64_t v1 = ~(uint64_t)0;
+    for(unsigned long j = 0; j < cand_len; j++){
+      u = v1 & query->peq[candidate[j]];
+      v1 = (v1 + u) | (v1 & ~u);
+    }
+    return (unsigned long)__builtin_popcountll(~v1 & last_mask);
+  }
+
+  if(words > STACK_WORDS){
+    v = (uint64_t *)malloc(words * sizeof(uint64_t));
+    if(v == NULL){
+      ERROR_EXIT("Unable to allocate bit vector");
+    }
+  }
+  for(unsigned long w = 0; w < words; w++){
+    v[w] = ~(uint64_t)0;
+  }
+
+  for(unsigned long j = 0; j < cand_len; j++){
+    peq_c = &query->peq[candidate[j] * words];
+    bp_lcs_step(v, peq_c, words);
+  }
+
+  for(unsigned long w = 0; w < words; w++){
+    lcs += (unsigned long)__builtin_popcountll(~v[w] & (w == words - 1 ? last_mask : ~(uint64_t)0));
+  }
+
+  if(v != stack_v){
+    free(v);
+  }
+  return lcs;
+}
+
+EdQuery *ed_query_build(const char *word){
+  EdQuery *query = NULL;
+  const unsigned char *uword = (const unsigned char *)word;
+
+  if(word == NULL){
+    ERROR_EXIT("Query word is NULL");
+  }
+
+  query = (EdQuery *)malloc(sizeof(EdQuery));
+  if(query == NULL){
+    ERROR_EXIT("Unable to allocate query");
+  }
+  query->word = word;
+  query->len = strlen(word);
+  query->words = (query->len == 0) ? 1 : (query->len + WORD_BITS - 1) / WORD_BITS;
+  query->peq = (uint64_t *)calloc(QUERY_ALPHABET_SIZE * query->words, sizeof(uint64_t));
+  if(query->peq == NULL){
+    ERROR_EXIT("Unable to allocate Peq table");
+  }
+  memset(query->histogram, 0, sizeof(query->histogram));
+
+  for(unsigned long i = 0; i < query->len; i++){
+    query->peq[uword[i] * query->words + i / WORD_BITS] |= (uint64_t)1 << (i % WORD_BITS);
+    query->histogram[uword[i]]++;
+  }
+  return query;
+}
+
+unsigned ed_query_distance(const EdQuery *query, const char *candidate, unsigned bound){
+  if(candidate == NULL){
+    ERROR_EXIT("Candidate string is NULL");
+  }
+  return ed_query_distance_len(query, candidate, strlen(candidate), bound);
+}
+
+unsigned ed_query_distance_len(const EdQuery *query, const char *candidate, unsigned long cand_len, unsigned bound){
+  const unsigned char *ucandidate = (const unsigned char *)candidate;
+  unsigned long len_diff, distance;
+
+  if(query == NULL){
+    ERROR_EXIT("Query is NULL");
+  }
+  if(candidate == NULL){
+    ERROR_EXIT("Candidate string is NULL");
+  }
+
+  if(query->len + cand_len >= UINT_MAX){
+    ERROR_EXIT("Strings too long");
+  }
+
+  len_diff = (cand_len > query->len) ? cand_len - query->len : query->len - cand_len;
+  if(len_diff > bound){
+    return bound + 1;
+  }
+  if(query->len == 0){
+    return (unsigned)cand_len;
+  }
+  // filter is useful only if distance can exceed bound
+  if(query->len + cand_len > bound && histogram_lower_bound(query, ucandidate, cand_len) > bound){
+    return bound + 1;
+  }
+
+  distance = query->len + cand_len - 2 * query_lcs(query, ucandidate, cand_len);
+  return (distance > bound) ? bound + 1 : (unsigned)distance;
+}
+
+void ed_query_distance_batch(const EdQuery *query, char **candidates, unsigned long cand_num, unsigned bound, unsigned *results){
+  if(candidates == NULL || results == NULL){
+    ERROR_EXIT("Candidates and results references can't be NULL");
+  }
+
+  for(unsigned long i = 0; i < cand_num; i++){
+    results[i] = ed_query_distance(query, candidates[i], bound);
+  }
+}
+
+void ed_query_free(EdQuery *query){
+  if(query != NULL){
+    free(query->peq);
+    free(query);
+  }
+}
@@ -0,0 +1,74 @@
+#ifndef _EDIT_DISTANCE_QUERY_H_
+#define _EDIT_DISTANCE_QUERY_H_
+
+#include <stdint.h>
+#include <limits.h>
+
+#define QUERY_ALPHABET_SIZE (UCHAR_MAX + 1)
+
+/**
+ * @brief It rappresents a word preprocessed once to be compared with many candidates.
+ *        Bit i of peq[c * words + i / 64] is set if word[i] == c (Peq table of bit-parallel LCS),
+ *        histogram[c] counts occurrences of c in word.
+ *        The structure is only read by comparisons, so it can be shared between threads.
+ */
+typedef struct _EdQuery{
+  const char *word;                             // query word, not copied
+  unsigned long len;                            // length of word
+  unsigned long words;                          // 64 bit words of every Peq bit vector
+  uint64_t *peq;                                // QUERY_ALPHABET_SIZE * words bit vectors
+  unsigned histogram[QUERY_ALPHABET_SIZE];      // occurrences of every character
+} EdQuery;
+
+/**
+ * @brief Build query for a word. Word is not copied, it must live as long as the query.
+ *
+ * @param word      query word, can't be NULL
+ * @return EdQuery* allocated query, to free with ed_query_free
+ */
+EdQuery *ed_query_build(const char *word);
+
+/**
+ * @brief Calculate edit distance (insertions and deletions only) between query word and candidate,
+ *        with the same result of edit_distance_bounded. Candidate is rejected without LCS
+ *        if length difference or character histogram difference (both lower bounds
+ *        of distance) exceed bound, otherwise distance is computed with bit-parallel LCS
+ *        on the precomputed Peq table.
+ *
+ * @param query     preprocessed query, can't be NULL
+ * @param candidate candidate string, can't be NULL
+ * @param bound     max distance of interest, UINT_MAX for exact distance
+ * @return unsigned distance if it is <= bound, bound + 1 otherwise
+ */
+unsigned ed_query_distance(const EdQuery *query, const char *candidate, unsigned bound);
+
+/**
+ * @brief Calculate ed_query_distance of a candidate whose length is already known.
+ *
+ * @param query     preprocessed query, can't be NULL
+ * @param candidate candidate string, can't be NULL
+ * @param cand_len  length of candidate
+ * @param bound     max distance of interest, UINT_MAX for exact distance
+ * @return unsigned distance if it is <= bound, bound + 1 otherwise
+ */
+unsigned ed_query_distance_len(const EdQuery *query, const char *candidate, unsigned long cand_len, unsigned bound);
+
+/**
+ * @brief Calculate ed_query_distance for a block of candidates.
+ *
+ * @param query         preprocessed query, can't be NULL
+ * @param candidates    array of candidate strings, can't be NULL
+ * @param cand_num      number of candidates
+ * @param bound         max distance of interest, UINT_MAX for exact distances
+ * @param results       array of cand_num results, results[i] is distance of candidates[i]
+ */
+void ed_query_distance_batch(const EdQuery *query, char **candidates, unsigned long cand_num, unsigned bound, unsigned *results);
+
+/**
+ * @brief Free query
+ *
+ * @param query   query to free
+ */
+void ed_query_free(EdQuery *query);
+
+#endif
@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "unity/unity.h"
+#include "edit_distance_query.h"
+#include "edit_distance_dyn.h"
+
+static void test_empty_query(void){
+  EdQuery *query = ed_query_build("");
+  TEST_ASSERT_EQUAL_INT(0, ed_query_distance(query, "", UINT_MAX));
+  TEST_ASSERT_EQUAL_INT(7, ed_query_distance(query, "welcome", UINT_MAX));
+  ed_query_free(query);
+}
+
+static void test_empty_candidate(void){
+  EdQuery *query = ed_query_build("hello");
+  TEST_ASSERT_EQUAL_INT(5, ed_query_distance(query, "", UINT_MAX));
+  ed_query_free(query);
+}
+
+static void test_one_query_many_candidates(void){
+  EdQuery *query = ed_query_build("tassa");
+  TEST_ASSERT_EQUAL_INT(0, ed_query_distance(query, "tassa", UINT_MAX));
+  TEST_ASSERT_EQUAL_INT(4, ed_query_distance(query, "passato", UINT_MAX));
+  TEST_ASSERT_EQUAL_INT(2, ed_query_distance(query, "tasse", UINT_MAX));
+  TEST_ASSERT_EQUAL_INT(1, ed_query_distance(query, "tass", UINT_MAX));
+  ed_query_free(query);
+}
+
+static void test_over_bound(void){
+  EdQuery *query = ed_query_build("casa");
+  // rejected by length, by histogram and by LCS
+  TEST_ASSERT_EQUAL_INT(2, ed_query_distance(query, "casalinga", 1));
+  TEST_ASSERT_EQUAL_INT(3, ed_query_distance(query, "zzzz", 2));
+  TEST_ASSERT_EQUAL_INT(3, ed_query_distance(query, "saca", 2));
+  TEST_ASSERT_EQUAL_INT(2, ed_query_distance(query, "cara", 2));
+  ed_query_free(query);
+}
+
+static void test_batch(void){
+  char *candidates[] = {"pioppo", "pippo", "poppi", "", "pioppone"};
+  unsigned exp_results[] = {0, 1, 3, 4, 2};
+  unsigned results[5];
+  EdQuery *query = ed_query_build("pioppo");
+
+  ed_query_distance_batch(query, candidates, 5, 3, results);
+  TEST_ASSERT_EQUAL_UINT_ARRAY(exp_results, results, 5);
+  ed_query_free(query);
+}
+
+static void test_same_as_dyn_random_strings(void){
+  char s1[300], s2[300];
+  EdQuery *query;
+
+  srand(23);
+  for(int t = 0; t < 2000; t++){
+    // query lengths around the single word limit and multiple words
+    int len1 = (t % 2) ? rand() % 70 : rand() % 299, len2 = rand() % 299;
+    unsigned bound = (unsigned)(rand() % 40), exact;
+    for(int i = 0; i < len1; i++) s1[i] = (char)('a' + rand() % 3);
+    for(int i = 0; i < len2; i++) s2[i] = (char)('a' + rand() % 3);
+    s1[len1] = '\0';
+    s2[len2] = '\0';
+    exact = edit_distance_dyn(s1, s2);
+    query = ed_query_build(s1);
+    TEST_ASSERT_EQUAL_INT(exact, ed_query_distance(query, s2, UINT_MAX));
+    TEST_ASSERT_EQUAL_INT(exact <= bound ? exact : bound + 1, ed_query_distance(query, s2, bound));
+    ed_query_free(query);
+  }
+}
+
+static void test_long_query(void){
+  unsigned long len = 20000;
+  char *s1 = (char *)malloc(len + 1);
+  char *s2 = (char *)malloc(len + 1);
+  EdQuery *query;
+
+  memset(s1, 'a', len);
+  memset(s2, 'a', len);
+  s1[len] = s2[len] = '\0';
+  s2[len/2] = 'b';
+  query = ed_query_build(s1);
+  TEST_ASSERT_EQUAL_INT(2, ed_query_distance(query, s2, UINT_MAX));
+  ed_query_free(query);
+  free(s1);
+  free(s2);
+}
+
+int main(void){
+
+  // test session
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_query);
+  RUN_TEST(test_empty_candidate);
+  RUN_TEST(test_one_query_many_candidates);
+  RUN_TEST(test_over_bound);
+  RUN_TEST(test_batch);
+  RUN_TEST(test_same_as_dyn_random_strings);
+  RUN_TEST(test_long_query);
+
+  return UNITY_END();
+}
@@ -0,0 +1,269 @@
+/**
+ * @file edit_distance_script.c
+ * @author Daniele Di Palma
+ * @brief Edit script (insertions and deletions only) in linear space with Hirschberg's algorithm
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include "edit_distance_script.h"
+#include "edit_distance_bp.h"
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+#define INITIAL_CAPACITY (16)
+#define ALPHABET_SIZE (UCHAR_MAX + 1)
+#define WORD_BITS (64)
+
+/**
+ * @brief It rappresents memory shared by all steps of divide and conquer,
+ *        allocated once for the longest second string
+ */
+typedef struct _Workspace{
+  uint64_t *peq;          // bit vectors of characters of second string, all 0 between steps
+  uint64_t *v;            // bit vector of LCS row
+  uint32_t *row;          // LCS of first half with every prefix of second string
+  uint32_t *reverse_row;  // LCS of second half with every suffix of second string
+} Workspace;
+
+/**
+ * @brief Calculate LCS of a with every prefix of b, with bit-parallel LCS on bit vectors long as b.
+ *        If reverse is set both strings are read backwards, so row[k] is LCS of a
+ *        with last k characters of b.
+ *
+ * @param ws        workspace
+ * @param a         first string
+ * @param a_len     length of a
+ * @param b         second string
+ * @param b_len     length of b, greater than 0
+ * @param reverse   1 for read strings backwards
+ * @param row       array of b_len + 1 results
+ */
+static void lcs_row(Workspace *ws, const unsigned char *a, unsigned long a_len, const unsigned char *b, unsigned long b_len,
+                    int reverse, uint32_t *row){
+  unsigned long words = (b_len + WORD_BITS - 1) / WORD_BITS, t;
+  uint64_t *peq_c, *v = ws->v;
+
+  for(t = 0; t < b_len; t++){
+    ws->peq[b[reverse ? b_len - 1 - t : t] * words + t / WORD_BITS] |= (uint64_t)1 << (t % WORD_BITS);
+  }
+  for(unsigned long w = 0; w < words; w++){
+    v[w] = ~(uint64_t)0;
+  }
+
+  for(unsigned long i = 0; i < a_len; i++){
+    peq_c = &ws->peq[a[reverse ? a_len - 1 - i : i] * words];
+    bp_lcs_step(v, peq_c, words);
+  }
+
+  // zero bits of v mark columns where LCS grows
+  row[0] = 0;
+  for(t = 0; t < b_len; t++){
+    row[t + 1] = row[t] + (uint32_t)(((v[t / WORD_BITS] >> (t % WORD_BITS)) & 1) ^ 1);
+  }
+
+  for(t = 0; t < b_len; t++){
+    ws->peq[b[reverse ? b_len - 1 - t : t] * words + t / WORD_BITS] = 0;
+  }
+}
+
+/**
+ * @brief Append to script operations transforming a into b
+ *
+ * @param ws      workspace
+ * @param script  script
+ * @param a       first string
+ * @param m       length of a
+ * @param b       second string
+ * @param n       length of b
+ */
+static void hirschberg(Workspace *ws, EditScript *script, const unsigned char *a, unsigned long m, const unsigned char *b, unsigned long n){
+  unsigned long prefix = 0, suffix = 0, mid, split = 0, best = 0;
+  const unsigned char *found;
+
+  while(prefix < m && prefix < n && a[prefix] == b[prefix]){
+    prefix++;
+  }
+  edit_script_append(script, EDIT_KEEP, prefix);
+  a += prefix;
+  b += prefix;
+  m -= prefix;
+  n -= prefix;
+  while(suffix < m && suffix < n && a[m - 1 - suffix] == b[n - 1 - suffix]){
+    suffix++;
+  }
+  m -= suffix;
+  n -= suffix;
+
+  if(m == 0 || n == 0){
+    edit_script_append(script, EDIT_DELETE, m);
+    edit_script_append(script, EDIT_INSERT, n);
+  }else if(m == 1){
+    found = (const unsigned char *)memchr(b, a[0], n);
+    if(found == NULL){
+      edit_script_append(script, EDIT_DELETE, 1);
+      edit_script_append(script, EDIT_INSERT, n);
+    }else{
+      edit_script_append(script, EDIT_INSERT, (unsigned long)(found - b));
+      edit_script_append(script, EDIT_KEEP, 1);
+      edit_script_append(script, EDIT_INSERT, n - (unsigned long)(found - b) - 1);
+    }
+  }else{
+    mid = m / 2;
+    lcs_row(ws, a, mid, b, n, 0, ws->row);
+    lcs_row(ws, a + mid, m - mid, b, n, 1, ws->reverse_row);
+    for(unsigned long k = 0; k <= n; k++){
+      if(ws->row[k] + ws->reverse_row[n - k] > best){
+        best = ws->row[k] + ws->reverse_row[n - k];
+        split = k;
+      }
+    }
+    hirschberg(ws, script, a, mid, b, split);
+    hirschberg(ws, script, a + mid, m - mid, b + split, n - split);
+  }
+
+  edit_script_append(script, EDIT_KEEP, suffix);
+}
+
+EditScript *edit_script(char *s1, char *s2){
+  EditScript *script = NULL;
+  Workspace ws;
+  unsigned long m, n, words;
+
+  if(s1 == NULL || s2 == NULL){
+    ERROR_EXIT("Strings can't be NULL");
+  }
+  m = strlen(s1);
+  n = strlen(s2);
+  if(m + n >= UINT_MAX){
+    ERROR_EXIT("Strings too long");
+  }
+
+  script = edit_script_create();
+  words = (n + WORD_BITS - 1) / WORD_BITS;
+  ws.peq = (uint64_t *)calloc(ALPHABET_SIZE * (words > 0 ? words : 1), sizeof(uint64_t));
+  ws.v = (uint64_t *)malloc((words > 0 ? words : 1) * sizeof(uint64_t));
+  ws.row = (uint32_t *)malloc((n + 1) * sizeof(uint32_t));
+  ws.reverse_row = (uint32_t *)malloc((n + 1) * sizeof(uint32_t));
+  if(ws.peq == NULL || ws.v == NULL || ws.row == NULL || ws.reverse_row == NULL){
+    ERROR_EXIT("Unable to allocate memory for edit script");
+  }
+
+  hirschberg(&ws, script, (const unsigned char *)s1, m, (const unsigned char *)s2, n);
+
+  free(ws.peq);
+  free(ws.v);
+  free(ws.row);
+  free(ws.reverse_row);
+  return script;
+}
+
+EditScript *edit_script_create(void){
+  EditScript *script = (EditScript *)malloc(sizeof(EditScript));
+  if(script == NULL){
+    ERROR_EXIT("Unable to allocate edit script");
+  }
+  script->run_capacity = INITIAL_CAPACITY;
+  script->run_num = 0;
+  script->distance = 0;
+  script->runs = (EditRun *)malloc(script->run_capacity * sizeof(EditRun));
+  if(script->runs == NULL){
+    ERROR_EXIT("Unable to allocate edit runs");
+  }
+  return script;
+}
+
+void edit_script_append(EditScript *script, char op, unsigned long len){
+  if(script == NULL){
+    ERROR_EXIT("Script can't be NULL");
+  }
+  if(len == 0){
+    return;
+  }
+  if(op != EDIT_KEEP){
+    script->distance += (unsigned)len;
+  }
+  if(script->run_num > 0 && script->runs[script->run_num - 1].op == op){
+    script->runs[script->run_num - 1].len += len;
+    return;
+  }
+  if(script->run_num >= script->run_capacity){
+    script->run_capacity *= 2;
+    script->runs = (EditRun *)realloc(script->runs, script->run_capacity * sizeof(EditRun));
+    if(script->runs == NULL){
+      ERROR_EXIT("Unable to re-allocate edit runs");
+    }
+  }
+  script->runs[script->run_num].op = op;
+  script->runs[script->run_num].len = len;
+  script->run_num++;
+}
+
+char *edit_script_apply(const EditScript *script, char *s1, char *s2){
+  unsigned long i = 0, j = 0, k = 0, m, n;
+  char *result = NULL;
+
+  if(script == NULL || s1 == NULL || s2 == NULL){
+    ERROR_EXIT("Script and strings can't be NULL");
+  }
+  m = strlen(s1);
+  n = strlen(s2);
+  result = (char *)malloc(n + 1);
+  if(result == NULL){
+    ERROR_EXIT("Unable to allocate result");
+  }
+
+  for(unsigned long r = 0; r < script->run_num; r++){
+    const EditRun *run = &script->runs[r];
+    if((run->op != EDIT_INSERT && i + run->len > m) || (run->op != EDIT_DELETE && j + run->len > n)){
+      ERROR_EXIT("Edit script doesn't match strings");
+    }
+    if(run->op == EDIT_KEEP){
+      memcpy(&result[k], &s1[i], run->len);
+      i += run->len;
+      j += run->len;
+      k += run->len;
+    }else if(run->op == EDIT_DELETE){
+      i += run->len;
+    }else{
+      memcpy(&result[k], &s2[j], run->len);
+      j += run->len;
+      k += run->len;
+    }
+  }
+  result[k] = '\0';
+  return result;
+}
+
+char *edit_script_to_string(const EditScript *script){
+  unsigned long size = 1, pos = 0;
+  char *str = NULL;
+
+  if(script == NULL){
+    ERROR_EXIT("Script can't be NULL");
+  }
+  // up to 20 digits for every length
+  size += script->run_num * 21;
+  str = (char *)malloc(size);
+  if(str == NULL){
+    ERROR_EXIT("Unable to allocate string");
+  }
+  str[0] = '\0';
+  for(unsigned long r = 0; r < script->run_num; r++){
+    pos += (unsigned long)sprintf(&str[pos], "%lu%c", script->runs[r].len, script->runs[r].op);
+  }
+  return str;
+}
+
+void edit_script_free(EditScript *script){
+  if(script != NULL){
+    free(script->runs);
+    free(script);
+  }
+}
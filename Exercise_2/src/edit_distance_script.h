@@ -0,0 +1,87 @@
+#ifndef _EDIT_DISTANCE_SCRIPT_H_
+#define _EDIT_DISTANCE_SCRIPT_H_
+
+#include <stdint.h>
+
+// operations of an edit script
+#define EDIT_KEEP ('=')     // character of first string is kept
+#define EDIT_DELETE ('-')   // character of first string is deleted
+#define EDIT_INSERT ('+')   // character of second string is inserted
+
+/**
+ * @brief It rappresents a run of consecutive operations of the same type
+ */
+typedef struct _EditRun{
+  unsigned long len;  // number of operations
+  char op;            // EDIT_KEEP, EDIT_DELETE or EDIT_INSERT
+} EditRun;
+
+/**
+ * @brief It rappresents operations transforming first string into second string,
+ *        run-length encoded: consecutive runs have different operations
+ */
+typedef struct _EditScript{
+  EditRun *runs;              // runs in order
+  unsigned long run_num;      // number of runs
+  unsigned long run_capacity; // capacity of runs
+  unsigned distance;          // number of insertions and deletions
+} EditScript;
+
+/**
+ * @brief Calculate a minimum edit script (insertions and deletions only) transforming s1 into s2
+ *        with Hirschberg's divide and conquer: s1 is split in half and the split point of s2
+ *        is the one maximizing LCS of the two halves, found from the last LCS row of first half
+ *        and of reversed second half. Rows are computed with bit-parallel LCS on bit vectors
+ *        long as s2, common prefix and suffix are kept without computing rows.
+ *        O(len(s1) * len(s2) / 64) time, O(len(s1) + len(s2)) memory.
+ *
+ * @param s1  first string, can't be NULL
+ * @param s2  second string, can't be NULL
+ * @return EditScript* allocated script, to free with edit_script_free
+ */
+EditScript *edit_script(char *s1, char *s2);
+
+/**
+ * @brief Allocate an empty edit script
+ *
+ * @return EditScript* allocated script, to free with edit_script_free
+ */
+EditScript *edit_script_create(void);
+
+/**
+ * @brief Append operations to script, merging them with last run if it has the same operation.
+ *        Distance is increased by insertions and deletions.
+ *
+ * @param script  script, can't be NULL
+ * @param op      EDIT_KEEP, EDIT_DELETE or EDIT_INSERT
+ * @param len     number of operations, nothing is appended if 0
+ */
+void edit_script_append(EditScript *script, char op, unsigned long len);
+
+/**
+ * @brief Apply edit script to s1, inserted characters are taken from s2
+ *
+ * @param script  script computed by edit_script(s1, s2), can't be NULL
+ * @param s1      first string, can't be NULL
+ * @param s2      second string, can't be NULL
+ * @return char*  allocated result, equal to s2
+ */
+char *edit_script_apply(const EditScript *script, char *s1, char *s2);
+
+/**
+ * @brief Format edit script as a string of runs, every run is its length followed by
+ *        its operation (e.g. "3=1-2+")
+ *
+ * @param script  script, can't be NULL
+ * @return char*  allocated string
+ */
+char *edit_script_to_string(const EditScript *script);
+
+/**
+ * @brief Free edit script
+ *
+ * @param script  script to free
+ */
+void edit_script_free(EditScript *script);
+
+#endif
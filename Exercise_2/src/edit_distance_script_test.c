@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity/unity.h"
+#include "edit_distance_script.h"
+#include "edit_distance_dyn.h"
+
+static void check_script(char *s1, char *s2){
+  EditScript *script = edit_script(s1, s2);
+  char *result = edit_script_apply(script, s1, s2);
+
+  TEST_ASSERT_EQUAL_INT(edit_distance_dyn(s1, s2), script->distance);
+  TEST_ASSERT_EQUAL_STRING(s2, result);
+  for(unsigned long r = 0; r < script->run_num; r++){
+    TEST_ASSERT_TRUE(script->runs[r].len > 0);
+    TEST_ASSERT_TRUE(r == 0 || script->runs[r].op != script->runs[r - 1].op);
+  }
+  free(result);
+  edit_script_free(script);
+}
+
+static void test_empty_strings(void){
+  EditScript *script = edit_script("", "");
+
+  TEST_ASSERT_EQUAL_INT(0, script->distance);
+  TEST_ASSERT_EQUAL_UINT64(0, script->run_num);
+  edit_script_free(script);
+  check_script("", "welcome");
+  check_script("hello", "");
+}
+
+static void test_script_string(void){
+  EditScript *script = edit_script("casa", "cassa");
+  char *str = edit_script_to_string(script);
+
+  TEST_ASSERT_EQUAL_STRING("3=1+1=", str);
+  free(str);
+  edit_script_free(script);
+
+  script = edit_script("pioppo", "pioppo");
+  str = edit_script_to_string(script);
+  TEST_ASSERT_EQUAL_STRING("6=", str);
+  free(str);
+  edit_script_free(script);
+
+  script = edit_script("abc", "xyz");
+  str = edit_script_to_string(script);
+  TEST_ASSERT_EQUAL_STRING("3-3+", str);
+  free(str);
+  edit_script_free(script);
+}
+
+static void test_small_strings(void){
+  check_script("tassa", "passato");
+  check_script("passato", "tassa");
+  check_script("casa", "cara");
+  check_script("perch\xc3\xa9", "perche");
+}
+
+static void test_same_as_dyn_random_strings(void){
+  char s1[300], s2[300];
+
+  srand(41);
+  for(int t = 0; t < 1000; t++){
+    // lengths around the single word limit and multiple words
+    int len1 = rand() % 299, len2 = (t % 2) ? rand() % 70 : rand() % 299;
+    for(int i = 0; i < len1; i++) s1[i] = (char)('a' + rand() % 3);
+    for(int i = 0; i < len2; i++) s2[i] = (char)('a' + rand() % 3);
+    s1[len1] = '\0';
+    s2[len2] = '\0';
+    check_script(s1, s2);
+  }
+}
+
+int main(void){
+
+  // test session
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_strings);
+  RUN_TEST(test_script_string);
+  RUN_TEST(test_small_strings);
+  RUN_TEST(test_same_as_dyn_random_strings);
+
+  return UNITY_END();
+}
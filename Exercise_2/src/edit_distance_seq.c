@@ -0,0 +1,285 @@
+/**
+ * @file edit_distance_seq.c
+ * @author Daniele Di Palma
+ * @brief Edit distance (insertions and deletions only) between sequences of any type of element
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "edit_distance_seq.h"
+#include "edit_distance_myers.h"
+#include "edit_distance_bp.h"
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+#define MYERS_BUDGET_RATIO (16)   // Myers gives up after min(len) / MYERS_BUDGET_RATIO operations
+#define WORD_BITS (64)
+
+/**
+ * @brief It rappresents distinct ids of a sequence, with open addressing
+ */
+typedef struct _SymbolTable{
+  uint32_t *keys;           // ids
+  unsigned long *symbols;   // symbol of id + 1, 0 for empty slots
+  unsigned long mask;       // number of slots - 1, number of slots is a power of 2
+  unsigned long symbol_num; // number of distinct ids
+} SymbolTable;
+
+/**
+ * @brief It rappresents an element of one of two sequences numbered one after the other
+ */
+typedef struct _Element{
+  void *value;                        // address of element
+  unsigned long index;                // index of element, the ones of second sequence follow first sequence
+  int (*precedes)(void *, void *);    // precedence relation between elements
+} Element;
+
+/**
+ * @brief Find slot of an id
+ *
+ * @param table   symbol table
+ * @param key     id
+ * @return unsigned long slot of id, or empty slot where id goes
+ */
+static unsigned long symbol_slot(const SymbolTable *table, uint32_t key){
+  unsigned long slot = (unsigned long)(((uint64_t)key * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & table->mask;
+
+  while(table->symbols[slot] != 0 && table->keys[slot] != key){
+    slot = (slot + 1) & table->mask;
+  }
+  return slot;
+}
+
+/**
+ * @brief Calculate LCS of two sequences with bit-parallel LCS on bit vectors long as b
+ *
+ * @param a   first sequence
+ * @param m   length of a
+ * @param b   second sequence
+ * @param n   length of b, greater than 0
+ * @return unsigned long LCS length
+ */
+static unsigned long lcs_u32(const uint32_t *a, unsigned long m, const uint32_t *b, unsigned long n){
+  unsigned long words = (n + WORD_BITS - 1) / WORD_BITS, slots = 1, lcs = 0, symbol, slot, *symbol_of, *offsets, *positions, *dense_of, dense_num = 0;
+  uint64_t *dense, *scratch, *v, *peq, u;
+  SymbolTable table;
+
+  while(slots < 2 * n){
+    slots *= 2;
+  }
+  table.keys = (uint32_t *)malloc(slots * sizeof(uint32_t));
+  table.symbols = (unsigned long *)calloc(slots, sizeof(unsigned long));
+  table.mask = slots - 1;
+  table.symbol_num = 0;
+  symbol_of = (unsigned long *)malloc(n * sizeof(unsigned long));
+  offsets = (unsigned long *)calloc(n + 1, sizeof(unsigned long));
+  positions = (unsigned long *)malloc(n * sizeof(unsigned long));
+  if(table.keys == NULL || table.symbols == NULL || symbol_of == NULL || offsets == NULL || positions == NULL){
+    ERROR_EXIT("Unable to allocate symbols");
+  }
+
+  // positions of every symbol of b, grouped by symbol
+  for(unsigned long j = 0; j < n; j++){
+    slot = symbol_slot(&table, b[j]);
+    if(table.symbols[slot] == 0){
+      table.keys[slot] = b[j];
+      table.symbols[slot] = ++table.symbol_num;
+    }
+    symbol_of[j] = table.symbols[slot] - 1;
+    offsets[symbol_of[j] + 1]++;
+  }
+  for(symbol = 0; symbol < table.symbol_num; symbol++){
+    offsets[symbol + 1] += offsets[symbol];
+  }
+  for(unsigned long j = 0; j < n; j++){
+    positions[offsets[symbol_of[j]]++] = j;
+  }
+  for(symbol = table.symbol_num; symbol > 0; symbol--){
+    offsets[symbol] = offsets[symbol - 1];
+  }
+  offsets[0] = 0;
+
+  // bit vectors of symbols with at least one position for every word, at most WORD_BITS of them
+  // (symbol_of is no longer needed and is reused for their indexes + 1)
+  dense_of = symbol_of;
+  for(symbol = 0; symbol < table.symbol_num; symbol++){
+    dense_of[symbol] = (offsets[symbol + 1] - offsets[symbol] >= words) ? ++dense_num : 0;
+  }
+  dense = (uint64_t *)calloc((dense_num + 1) * words, sizeof(uint64_t));
+  v = (uint64_t *)malloc(words * sizeof(uint64_t));
+  if(dense == NULL || v == NULL){
+    ERROR_EXIT("Unable to allocate bit vectors");
+  }
+  // last vector is filled for rare symbols
+  scratch = &dense[dense_num * words];
+  for(symbol = 0; symbol < table.symbol_num; symbol++){
+    if(dense_of[symbol] != 0){
+      for(unsigned long p = offsets[symbol]; p < offsets[symbol + 1]; p++){
+        dense[(dense_of[symbol] - 1) * words + positions[p] / WORD_BITS] |= (uint64_t)1 << (positions[p] % WORD_BITS);
+      }
+    }
+  }
+  for(unsigned long w = 0; w < words; w++){
+    v[w] = ~(uint64_t)0;
+  }
+
+  for(unsigned long i = 0; i < m; i++){
+    slot = symbol_slot(&table, a[i]);
+    // without matches row doesn't change
+    if(table.symbols[slot] == 0){
+      continue;
+    }
+    symbol = table.symbols[slot] - 1;
+    if(dense_of[symbol] != 0){
+      peq = &dense[(dense_of[symbol] - 1) * words];
+    }else{
+      peq = scratch;
+      for(unsigned long p = offsets[symbol]; p < offsets[symbol + 1]; p++){
+        peq[positions[p] / WORD_BITS] |= (uint64_t)1 << (positions[p] % WORD_BITS);
+      }
+    }
+
+    bp_lcs_step(v, peq, words);
+
+    if(peq == scratch){
+      for(unsigned long p = offsets[symbol]; p < offsets[symbol + 1]; p++){
+        peq[positions[p] / WORD_BITS] = 0;
+      }
+    }
+  }
+
+  // zero bits of v in first n positions mark matches of LCS
+  for(unsigned long w = 0; w < words; w++){
+    u = (w == words - 1 && n % WORD_BITS != 0) ? ((uint64_t)1 << (n % WORD_BITS)) - 1 : ~(uint64_t)0;
+    lcs += (unsigned long)__builtin_popcountll(~v[w] & u);
+  }
+
+  free(table.keys);
+  free(table.symbols);
+  free(symbol_of);
+  free(offsets);
+  free(positions);
+  free(dense);
+  free(v);
+  return lcs;
+}
+
+unsigned long edit_distance_seq_u32(const uint32_t *seq1, unsigned long len1, const uint32_t *seq2, unsigned long len2){
+  unsigned long prefix = 0, suffix = 0, budget, result;
+
+  if((seq1 == NULL && len1 > 0) || (seq2 == NULL && len2 > 0)){
+    ERROR_EXIT("Sequences can't be NULL");
+  }
+  while(prefix < len1 && prefix < len2 && seq1[prefix] == seq2[prefix]){
+    prefix++;
+  }
+  seq1 += prefix;
+  seq2 += prefix;
+  len1 -= prefix;
+  len2 -= prefix;
+  while(suffix < len1 && suffix < len2 && seq1[len1 - 1 - suffix] == seq2[len2 - 1 - suffix]){
+    suffix++;
+  }
+  len1 -= suffix;
+  len2 -= suffix;
+  if(len1 == 0 || len2 == 0){
+    return len1 + len2;
+  }
+
+  budget = (len1 < len2 ? len1 : len2) / MYERS_BUDGET_RATIO;
+  if((len1 > len2 ? len1 - len2 : len2 - len1) <= budget){
+    result = edit_distance_myers_u32_bounded(seq1, len1, seq2, len2, budget);
+    if(result <= budget){
+      return result;
+    }
+  }
+  if(len2 <= len1){
+    return len1 + len2 - 2 * lcs_u32(seq1, len1, seq2, len2);
+  }
+  return len1 + len2 - 2 * lcs_u32(seq2, len2, seq1, len1);
+}
+
+/**
+ * @brief Compare two elements as qsort() wants, with their precedence relation
+ *
+ * @param e1    first Element
+ * @param e2    second Element
+ * @return int  negative if first element precedes second, 0 if they are equal, positive otherwise
+ */
+static int compare_elements(const void *e1, const void *e2){
+  const Element *x = (const Element *)e1, *y = (const Element *)e2;
+
+  switch(x->precedes(x->value, y->value)){
+    case 2:
+      return 0;
+    case 1:
+      return -1;
+    default:
+      return 1;
+  }
+}
+
+unsigned long edit_distance_seq(void *seq1, unsigned long len1, void *seq2, unsigned long len2, unsigned long size_el,
+                                int (*precedes)(void *, void *)){
+  char *a = (char *)seq1, *b = (char *)seq2;
+  unsigned long prefix = 0, suffix = 0, num, result;
+  uint32_t *ids, id = 0;
+  Element *elements;
+
+  if((seq1 == NULL && len1 > 0) || (seq2 == NULL && len2 > 0) || precedes == NULL){
+    ERROR_EXIT("Sequences and precedes can't be NULL");
+  }
+  if(size_el == 0){
+    ERROR_EXIT("Size of element can't be 0");
+  }
+  while(prefix < len1 && prefix < len2 && precedes(a + prefix * size_el, b + prefix * size_el) == 2){
+    prefix++;
+  }
+  a += prefix * size_el;
+  b += prefix * size_el;
+  len1 -= prefix;
+  len2 -= prefix;
+  while(suffix < len1 && suffix < len2 && precedes(a + (len1 - 1 - suffix) * size_el, b + (len2 - 1 - suffix) * size_el) == 2){
+    suffix++;
+  }
+  len1 -= suffix;
+  len2 -= suffix;
+  if(len1 == 0 || len2 == 0){
+    return len1 + len2;
+  }
+  num = len1 + len2;
+  if(num > UINT32_MAX){
+    ERROR_EXIT("Sequences too long");
+  }
+
+  elements = (Element *)malloc(num * sizeof(Element));
+  ids = (uint32_t *)malloc(num * sizeof(uint32_t));
+  if(elements == NULL || ids == NULL){
+    ERROR_EXIT("Unable to allocate ids");
+  }
+
+  // equal elements get the same id
+  for(unsigned long i = 0; i < num; i++){
+    elements[i].value = (i < len1) ? a + i * size_el : b + (i - len1) * size_el;
+    elements[i].index = i;
+    elements[i].precedes = precedes;
+  }
+  qsort(elements, num, sizeof(Element), compare_elements);
+  for(unsigned long i = 0; i < num; i++){
+    if(i > 0 && precedes(elements[i - 1].value, elements[i].value) != 2){
+      id++;
+    }
+    ids[elements[i].index] = id;
+  }
+
+  result = edit_distance_seq_u32(ids, len1, ids + len1, len2);
+
+  free(elements);
+  free(ids);
+  return result;
+}
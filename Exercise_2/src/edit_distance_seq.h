@@ -0,0 +1,44 @@
+#ifndef _EDIT_DISTANCE_SEQ_H_
+#define _EDIT_DISTANCE_SEQ_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Calculate edit distance (insertions and deletions only) between two sequences
+ *        of 32 bit ids (e.g. lines or tokens hashed to integers).
+ *        Common prefix and suffix are skipped, then Myers' O(ND) algorithm is tried with
+ *        a budget of min(len1, len2) / 16 operations; if distance is greater, LCS is computed
+ *        bit-parallel on bit vectors long as the shortest sequence. Ids are mapped to
+ *        symbols of the shortest sequence with a hash table: bit vectors of frequent
+ *        symbols are precomputed, the ones of rare symbols are filled for every row.
+ *        O(len1 + len2 + D^2) time for few scattered differences, O(len1 * len2 / 64) otherwise,
+ *        O(len1 + len2) memory.
+ *
+ * @param seq1  first sequence, can't be NULL if len1 > 0
+ * @param len1  length of first sequence
+ * @param seq2  second sequence, can't be NULL if len2 > 0
+ * @param len2  length of second sequence
+ * @return unsigned long number of operation
+ */
+unsigned long edit_distance_seq_u32(const uint32_t *seq1, unsigned long len1, const uint32_t *seq2, unsigned long len2);
+
+/**
+ * @brief Calculate edit distance (insertions and deletions only) between two sequences
+ *        of elements of any type, compared with precedes function pointer as in sort().
+ *        Common prefix and suffix are skipped, then remaining elements of both sequences
+ *        are sorted together (O(n log n) comparisons) to give equal elements the same
+ *        32 bit id, and distance is calculated with edit_distance_seq_u32.
+ *
+ * @param seq1      first sequence, can't be NULL if len1 > 0
+ * @param len1      length of first sequence
+ * @param seq2      second sequence, can't be NULL if len2 > 0
+ * @param len2      length of second sequence
+ * @param size_el   size of sequence element
+ * @param precedes  pointer function for precedence relation between elements.
+ *                  This function must return 2 if elements are equal, 1 if first element precede second, 0 otherwise.
+ * @return unsigned long number of operation
+ */
+unsigned long edit_distance_seq(void *seq1, unsigned long len1, void *seq2, unsigned long len2, unsigned long size_el,
+                                int (*precedes)(void *, void *));
+
+#endif
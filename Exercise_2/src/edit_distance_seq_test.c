@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "unity/unity.h"
+#include "edit_distance_seq.h"
+#include "edit_distance_bp.h"
+#include "edit_distance_dyn.h"
+
+static int precedes_char(void *c1, void *c2){
+  if(*(char *)c1 == *(char *)c2){
+    return 2;
+  }
+  return *(char *)c1 < *(char *)c2;
+}
+
+static int precedes_line(void *l1, void *l2){
+  int cmp = strcmp(*(char **)l1, *(char **)l2);
+  if(cmp == 0){
+    return 2;
+  }
+  return cmp < 0;
+}
+
+/**
+ * @brief Fill sequence of ids and string with a character for every id
+ */
+static void random_sequence(uint32_t *seq, char *str, unsigned long len, int alphabet){
+  for(unsigned long i = 0; i < len; i++){
+    int symbol = rand() % alphabet;
+    // ids far apart, characters from 1
+    seq[i] = (uint32_t)symbol * 2654435761u;
+    str[i] = (char)(1 + symbol);
+  }
+  str[len] = '\0';
+}
+
+static void test_small_sequences(void){
+  char s1[] = "tassa", s2[] = "passato";
+  uint32_t ids1[] = {7, 8, 9}, ids2[] = {7, 9, 10, UINT32_MAX};
+
+  TEST_ASSERT_EQUAL_UINT64(4, edit_distance_seq(s1, 5, s2, 7, sizeof(char), precedes_char));
+  TEST_ASSERT_EQUAL_UINT64(5, edit_distance_seq(s1, 5, NULL, 0, sizeof(char), precedes_char));
+  TEST_ASSERT_EQUAL_UINT64(0, edit_distance_seq(s1, 5, s1, 5, sizeof(char), precedes_char));
+  TEST_ASSERT_EQUAL_UINT64(3, edit_distance_seq_u32(ids1, 3, ids2, 4));
+  TEST_ASSERT_EQUAL_UINT64(0, edit_distance_seq_u32(NULL, 0, NULL, 0));
+  TEST_ASSERT_EQUAL_UINT64(4, edit_distance_seq_u32(NULL, 0, ids2, 4));
+}
+
+static void test_lines(void){
+  char *lines1[] = {"#include <stdio.h>", "", "int main(void){", "  puts(\"ciao\");", "  return 0;", "}", ""};
+  char *lines2[] = {"#include <stdio.h>", "#include <stdlib.h>", "", "int main(void){", "  puts(\"hello\");", "", "  return 0;", "}"};
+
+  // one line added, one changed, one added, last empty line removed
+  TEST_ASSERT_EQUAL_UINT64(5, edit_distance_seq(lines1, 7, lines2, 8, sizeof(char *), precedes_line));
+}
+
+static void test_same_as_dyn_random_sequences(void){
+  uint32_t seq1[300], seq2[300];
+  char s1[301], s2[301];
+  int alphabets[] = {2, 4, 26, 200};
+
+  srand(53);
+  for(int t = 0; t < 2000; t++){
+    // lengths around a single word of bits and multiple words
+    unsigned long len1 = (unsigned long)rand() % 299, len2 = (t % 2) ? (unsigned long)rand() % 70 : (unsigned long)rand() % 299;
+    int alphabet = alphabets[t % 4];
+    random_sequence(seq1, s1, len1, alphabet);
+    random_sequence(seq2, s2, len2, alphabet);
+    TEST_ASSERT_EQUAL_UINT64(edit_distance_dyn(s1, s2), edit_distance_seq_u32(seq1, len1, seq2, len2));
+    TEST_ASSERT_EQUAL_UINT64(edit_distance_dyn(s1, s2), edit_distance_seq(s1, len1, s2, len2, sizeof(char), precedes_char));
+  }
+}
+
+static void test_same_as_bp_long_sequences(void){
+  unsigned long len = 20000, k;
+  uint32_t *seq1 = (uint32_t *)malloc(len * sizeof(uint32_t)), *seq2 = (uint32_t *)malloc(2 * len * sizeof(uint32_t));
+  char *s1 = (char *)malloc(len + 1), *s2 = (char *)malloc(2 * len + 1);
+
+  srand(59);
+  for(int t = 0; t < 6; t++){
+    // different sequences, then changes every 10 and every 1000 elements
+    int alphabet = (t % 2) ? 3 : 200, edit_period = (t < 2) ? 0 : (t < 4) ? 10 : 1000;
+    random_sequence(seq1, s1, len, alphabet);
+    if(edit_period == 0){
+      random_sequence(seq2, s2, len, alphabet);
+      k = len;
+    }else{
+      k = 0;
+      for(unsigned long i = 0; i < len; i++){
+        int r = rand() % (2 * edit_period);
+        if(r == 0){
+          continue;
+        }else if(r == 1){
+          int symbol = rand() % alphabet;
+          seq2[k] = (uint32_t)symbol * 2654435761u;
+          s2[k++] = (char)(1 + symbol);
+        }
+        seq2[k] = seq1[i];
+        s2[k++] = s1[i];
+      }
+      s2[k] = '\0';
+    }
+    TEST_ASSERT_EQUAL_UINT64(edit_distance_bp(s1, s2), edit_distance_seq_u32(seq1, len, seq2, k));
+  }
+  free(seq1);
+  free(seq2);
+  free(s1);
+  free(s2);
+}
+
+int main(void){
+
+  // test session
+  UNITY_BEGIN();
+  RUN_TEST(test_small_sequences);
+  RUN_TEST(test_lines);
+  RUN_TEST(test_same_as_dyn_random_sequences);
+  RUN_TEST(test_same_as_bp_long_sequences);
+
+  return UNITY_END();
+}
@@ -0,0 +1,627 @@
+/**
+ * @file edit_distance_server.c
+ * @author Daniele Di Palma
+ * @brief Server of length-prefixed requests on a Unix domain socket, with an epoll
+ *        event loop and a pool of worker threads answering requests in batches
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include "edit_distance_server.h"
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+#define HEADER_SIZE (4)                           // length of frame
+#define READ_SIZE (1 << 16)                       // min free space of input buffer on read
+#define MAX_BUFFERED (4 * (SERVER_MAX_FRAME + HEADER_SIZE))  // max bytes of requests waiting on a connection
+#define MAX_EVENTS (64)
+#define LISTEN_BACKLOG (128)
+
+/**
+ * @brief It rappresents a connection of a client
+ */
+typedef struct _ServerConnection{
+  int fd;
+  char *in;                   // bytes read, not framed yet
+  unsigned long in_len;
+  unsigned long in_capacity;
+  char *out;                  // response frame being written
+  unsigned long out_len;
+  unsigned long out_sent;
+  int busy;                   // 1 if a request is being answered
+  int closed;                 // 1 if client closed connection or on error, freed when not busy
+  struct _ServerConnection *prev, *next;  // list of open connections
+} ServerConnection;
+
+/**
+ * @brief Stop or resume polling of listening socket: when no file descriptor is left
+ *        for accepting, listening socket stays readable and would wake epoll_wait forever
+ */
+static void set_accepting(Server *server, int accepting){
+  struct epoll_event event;
+
+  event.events = accepting ? EPOLLIN : 0;
+  event.data.ptr = &server->listen_fd;
+  if(epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, server->listen_fd, &event) != 0){
+    ERROR_EXIT("Unable to update socket events");
+  }
+  server->accept_paused = !accepting;
+}
+
+static void set_events(Server *server, ServerConnection *connection, uint32_t events){
+  struct epoll_event event;
+
+  event.events = events;
+  event.data.ptr = connection;
+  if(epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, connection->fd, &event) != 0){
+    ERROR_EXIT("Unable to update connection events");
+  }
+}
+
+/**
+ * @brief Close socket of connection. Connection is released now if no request of it is being
+ *        answered, otherwise when response comes back; it is freed after events of current
+ *        wait, that can still refer to it.
+ */
+static void close_connection(Server *server, ServerConnection *connection){
+  if(!connection->closed){
+    connection->closed = 1;
+    close(connection->fd);
+    // a file descriptor is free again
+    if(server->accept_paused){
+      set_accepting(server, 1);
+    }
+  }
+  if(connection->busy){
+    return;
+  }
+  if(connection->prev != NULL){
+    connection->prev->next = connection->next;
+  }else{
+    server->connections = connection->next;
+  }
+  if(connection->next != NULL){
+    connection->next->prev = connection->prev;
+  }
+  connection->next = server->closed;
+  server->closed = connection;
+}
+
+static void free_closed_connections(Server *server){
+  ServerConnection *next = NULL;
+
+  for(; server->closed != NULL; server->closed = next){
+    next = server->closed->next;
+    free(server->closed->in);
+    free(server->closed->out);
+    free(server->closed);
+  }
+}
+
+/**
+ * @brief Queue first request read from connection, if it is complete and connection is not busy
+ */
+static void dispatch_request(Server *server, ServerConnection *connection){
+  ServerRequest *request = NULL;
+  uint32_t len;
+
+  if(connection->busy || connection->closed || connection->in_len < HEADER_SIZE){
+    return;
+  }
+  memcpy(&len, connection->in, HEADER_SIZE);
+  len = ntohl(len);
+  if(len > SERVER_MAX_FRAME){
+    close_connection(server, connection);
+    return;
+  }
+  if(connection->in_len < HEADER_SIZE + (unsigned long)len){
+    return;
+  }
+
+  request = (ServerRequest *)malloc(sizeof(ServerRequest));
+  if(request == NULL || (request->payload = (char *)malloc((unsigned long)len + 1)) == NULL){
+    ERROR_EXIT("Unable to allocate request");
+  }
+  memcpy(request->payload, &connection->in[HEADER_SIZE], len);
+  request->payload[len] = '\0';
+  request->len = len;
+  request->response = NULL;
+  request->response_len = 0;
+  request->connection = connection;
+  request->next = NULL;
+  connection->in_len -= HEADER_SIZE + (unsigned long)len;
+  memmove(connection->in, &connection->in[HEADER_SIZE + len], connection->in_len);
+  connection->busy = 1;
+
+  pthread_mutex_lock(&server->lock);
+  if(server->pending_tail != NULL){
+    server->pending_tail->next = request;
+  }else{
+    server->pending_head = request;
+  }
+  server->pending_tail = request;
+  pthread_cond_signal(&server->pending_ready);
+  pthread_mutex_unlock(&server->lock);
+}
+
+/**
+ * @brief Read all available bytes of connection and queue a request if complete
+ */
+static void read_connection(Server *server, ServerConnection *connection){
+  ssize_t read_size;
+  char *grown = NULL;
+
+  for(;;){
+    if(connection->in_capacity - connection->in_len < READ_SIZE){
+      if(connection->in_capacity >= MAX_BUFFERED){
+        // too many requests sent without reading responses
+        close_connection(server, connection);
+        return;
+      }
+      grown = (char *)realloc(connection->in, connection->in_capacity * 2);
+      if(grown == NULL){
+        ERROR_EXIT("Unable to re-allocate input buffer");
+      }
+      connection->in = grown;
+      connection->in_capacity *= 2;
+    }
+    read_size = read(connection->fd, &connection->in[connection->in_len], connection->in_capacity - connection->in_len);
+    if(read_size > 0){
+      connection->in_len += (unsigned long)read_size;
+    }else if(read_size < 0 && errno == EINTR){
+      continue;
+    }else if(read_size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+      break;
+    }else{
+      close_connection(server, connection);
+      return;
+    }
+  }
+  dispatch_request(server, connection);
+}
+
+/**
+ * @brief Write response of connection until socket is full, then wait for it to be writable.
+ *        When response is written next request is queued.
+ */
+static void write_connection(Server *server, ServerConnection *connection){
+  ssize_t sent;
+
+  while(connection->out_sent < connection->out_len){
+    sent = send(connection->fd, &connection->out[connection->out_sent], connection->out_len - connection->out_sent, MSG_NOSIGNAL);
+    if(sent > 0){
+      connection->out_sent += (unsigned long)sent;
+    }else if(sent < 0 && errno == EINTR){
+      continue;
+    }else if(sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+      set_events(server, connection, EPOLLIN | EPOLLOUT);
+      return;
+    }else{
+      connection->busy = 0;
+      close_connection(server, connection);
+      return;
+    }
+  }
+  free(connection->out);
+  connection->out = NULL;
+  connection->out_len = connection->out_sent = 0;
+  connection->busy = 0;
+  set_events(server, connection, EPOLLIN);
+  dispatch_request(server, connection);
+}
+
+/**
+ * @brief Send responses of answered requests
+ */
+static void send_responses(Server *server){
+  ServerRequest *request = NULL, *next = NULL;
+  ServerConnection *connection = NULL;
+  uint64_t count;
+  uint32_t len;
+
+  if(read(server->wake_fd, &count, sizeof(count)) < 0 && errno != EAGAIN){
+    ERROR_EXIT("Unable to read wake event");
+  }
+  pthread_mutex_lock(&server->lock);
+  request = server->done_head;
+  server->done_head = server->done_tail = NULL;
+  pthread_mutex_unlock(&server->lock);
+
+  for(; request != NULL; request = next){
+    next = request->next;
+    connection = request->connection;
+    if(connection->closed || request->response_len > SERVER_MAX_FRAME){
+      // client can't receive a response longer than a frame
+      connection->busy = 0;
+      close_connection(server, connection);
+    }else{
+      connection->out = (char *)malloc(HEADER_SIZE + (unsigned long)request->response_len);
+      if(connection->out == NULL){
+        ERROR_EXIT("Unable to allocate response");
+      }
+      len = htonl(request->response_len);
+      memcpy(connection->out, &len, HEADER_SIZE);
+      if(request->response_len > 0){
+        memcpy(&connection->out[HEADER_SIZE], request->response, request->response_len);
+      }
+      connection->out_len = HEADER_SIZE + (unsigned long)request->response_len;
+      connection->out_sent = 0;
+      // busy until response is written, so responses are in order
+      write_connection(server, connection);
+    }
+    free(request->payload);
+    free(request->response);
+    free(request);
+  }
+}
+
+/**
+ * @brief Accept all waiting connections
+ */
+static void accept_connections(Server *server){
+  ServerConnection *connection = NULL;
+  struct epoll_event event;
+  int fd;
+
+  while((fd = accept(server->listen_fd, NULL, NULL)) >= 0){
+    if(fcntl(fd, F_SETFL, O_NONBLOCK) != 0 || fcntl(fd, F_SETFD, FD_CLOEXEC) != 0){
+      ERROR_EXIT("Unable to set connection non-blocking");
+    }
+    connection = (ServerConnection *)calloc(1, sizeof(ServerConnection));
+    if(connection == NULL || (connection->in = (char *)malloc(READ_SIZE)) == NULL){
+      ERROR_EXIT("Unable to allocate connection");
+    }
+    connection->fd = fd;
+    connection->in_capacity = READ_SIZE;
+    connection->next = server->connections;
+    if(server->connections != NULL){
+      server->connections->prev = connection;
+    }
+    server->connections = connection;
+
+    event.events = EPOLLIN;
+    event.data.ptr = connection;
+    if(epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0){
+      ERROR_EXIT("Unable to add connection to epoll");
+    }
+  }
+  if(errno == EMFILE || errno == ENFILE){
+    // waiting connections are accepted when a connection is closed
+    set_accepting(server, 0);
+  }else if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNABORTED){
+    ERROR_EXIT("Unable to accept connection");
+  }
+}
+
+/**
+ * @brief Worker thread: it takes queued requests, up to max_batch at a time, and answers them
+ *
+ * @param arg     pointer to Server struct
+ * @return void*  NULL
+ */
+static void *server_worker(void *arg){
+  Server *server = (Server *)arg;
+  ServerRequest **batch = (ServerRequest **)malloc(server->max_batch * sizeof(ServerRequest *));
+  unsigned long num;
+  uint64_t one = 1;
+
+  if(batch == NULL){
+    ERROR_EXIT("Unable to allocate batch");
+  }
+  for(;;){
+    pthread_mutex_lock(&server->lock);
+    while(server->pending_head == NULL && !server->stopping){
+      pthread_cond_wait(&server->pending_ready, &server->lock);
+    }
+    if(server->stopping){
+      pthread_mutex_unlock(&server->lock);
+      break;
+    }
+    for(num = 0; num < server->max_batch && server->pending_head != NULL; num++){
+      batch[num] = server->pending_head;
+      server->pending_head = server->pending_head->next;
+    }
+    if(server->pending_head == NULL){
+      server->pending_tail = NULL;
+    }
+    pthread_mutex_unlock(&server->lock);
+
+    server->handler(batch, num, server->context);
+
+    pthread_mutex_lock(&server->lock);
+    for(unsigned long i = 0; i < num; i++){
+      batch[i]->next = NULL;
+      if(server->done_tail != NULL){
+        server->done_tail->next = batch[i];
+      }else{
+        server->done_head = batch[i];
+      }
+      server->done_tail = batch[i];
+    }
+    server->requests += num;
+    server->batches++;
+    pthread_mutex_unlock(&server->lock);
+    if(write(server->wake_fd, &one, sizeof(one)) < 0){
+      ERROR_EXIT("Unable to wake event loop");
+    }
+  }
+  free(batch);
+  return NULL;
+}
+
+Server *server_create(const char *socket_path, ServerHandler handler, void *context, unsigned thread_num, unsigned long max_batch){
+  Server *server = NULL;
+  struct sockaddr_un address;
+  struct epoll_event event;
+
+  if(socket_path == NULL || handler == NULL){
+    ERROR_EXIT("Socket path and handler can't be NULL");
+  }
+  if(thread_num < 1 || max_batch < 1){
+    ERROR_EXIT("Server needs at least a thread and a request per batch");
+  }
+  if(strlen(socket_path) >= sizeof(address.sun_path)){
+    ERROR_EXIT("Socket path too long");
+  }
+
+  server = (Server *)calloc(1, sizeof(Server));
+  if(server == NULL || (server->socket_path = (char *)malloc(strlen(socket_path) + 1)) == NULL){
+    ERROR_EXIT("Unable to allocate server");
+  }
+  strcpy(server->socket_path, socket_path);
+  server->handler = handler;
+  server->context = context;
+  server->thread_num = thread_num;
+  server->max_batch = max_batch;
+  if(pthread_mutex_init(&server->lock, NULL) != 0 || pthread_cond_init(&server->pending_ready, NULL) != 0){
+    ERROR_EXIT("Unable to initialize locks");
+  }
+
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strcpy(address.sun_path, socket_path);
+  unlink(socket_path);
+  server->listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if(server->listen_fd < 0 || bind(server->listen_fd, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+     listen(server->listen_fd, LISTEN_BACKLOG) != 0){
+    ERROR_EXIT("Unable to listen on socket");
+  }
+
+  server->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  server->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  server->stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if(server->epoll_fd < 0 || server->wake_fd < 0 || server->stop_fd < 0){
+    ERROR_EXIT("Unable to create event loop");
+  }
+  // special fds are told apart from connections by address of their field
+  event.events = EPOLLIN;
+  event.data.ptr = &server->listen_fd;
+  if(epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->listen_fd, &event) != 0){
+    ERROR_EXIT("Unable to add socket to epoll");
+  }
+  event.data.ptr = &server->wake_fd;
+  if(epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->wake_fd, &event) != 0){
+    ERROR_EXIT("Unable to add eventfd to epoll");
+  }
+  event.data.ptr = &server->stop_fd;
+  if(epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->stop_fd, &event) != 0){
+    ERROR_EXIT("Unable to add eventfd to epoll");
+  }
+  return server;
+}
+
+void server_run(Server *server){
+  struct epoll_event events[MAX_EVENTS];
+  ServerRequest *request = NULL, *next = NULL;
+  ServerConnection *connection = NULL;
+  int event_num, running = 1;
+
+  if(server == NULL){
+    ERROR_EXIT("Server reference can't be NULL");
+  }
+  server->stopping = 0;
+  server->workers = (pthread_t *)malloc(server->thread_num * sizeof(pthread_t));
+  if(server->workers == NULL){
+    ERROR_EXIT("Unable to allocate workers");
+  }
+  for(unsigned t = 0; t < server->thread_num; t++){
+    if(pthread_create(&server->workers[t], NULL, server_worker, server) != 0){
+      ERROR_EXIT("Unable to create worker");
+    }
+  }
+
+  while(running){
+    event_num = epoll_wait(server->epoll_fd, events, MAX_EVENTS, -1);
+    if(event_num < 0 && errno == EINTR){
+      continue;
+    }else if(event_num < 0){
+      ERROR_EXIT("Unable to wait for events");
+    }
+    for(int i = 0; i < event_num; i++){
+      if(events[i].data.ptr == &server->stop_fd){
+        running = 0;
+      }else if(events[i].data.ptr == &server->listen_fd){
+        accept_connections(server);
+      }else if(events[i].data.ptr == &server->wake_fd){
+        send_responses(server);
+      }else{
+        connection = (ServerConnection *)events[i].data.ptr;
+        // connection can be closed by a previous event of same wait
+        if(connection->closed){
+          continue;
+        }
+        if(events[i].events & EPOLLOUT){
+          write_connection(server, connection);
+        }
+        if(!connection->closed && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))){
+          read_connection(server, connection);
+        }
+      }
+    }
+    free_closed_connections(server);
+  }
+
+  pthread_mutex_lock(&server->lock);
+  server->stopping = 1;
+  pthread_cond_broadcast(&server->pending_ready);
+  pthread_mutex_unlock(&server->lock);
+  for(unsigned t = 0; t < server->thread_num; t++){
+    pthread_join(server->workers[t], NULL);
+  }
+  free(server->workers);
+  server->workers = NULL;
+
+  // requests not answered and connections are discarded
+  for(int queue = 0; queue < 2; queue++){
+    for(request = (queue == 0) ? server->pending_head : server->done_head; request != NULL; request = next){
+      next = request->next;
+      request->connection->busy = 0;
+      free(request->payload);
+      free(request->response);
+      free(request);
+    }
+  }
+  server->pending_head = server->pending_tail = server->done_head = server->done_tail = NULL;
+  while(server->connections != NULL){
+    server->connections->busy = 0;
+    close_connection(server, server->connections);
+  }
+  free_closed_connections(server);
+}
+
+void server_stop(Server *server){
+  uint64_t one = 1;
+
+  // only write, safe in signal handlers
+  if(write(server->stop_fd, &one, sizeof(one)) < 0){
+    return;
+  }
+}
+
+void server_free(Server *server){
+  if(server != NULL){
+    close(server->listen_fd);
+    close(server->epoll_fd);
+    close(server->wake_fd);
+    close(server->stop_fd);
+    unlink(server->socket_path);
+    pthread_mutex_destroy(&server->lock);
+    pthread_cond_destroy(&server->pending_ready);
+    free(server->socket_path);
+    free(server);
+  }
+}
+
+int server_connect(const char *socket_path){
+  struct sockaddr_un address;
+  int fd;
+
+  if(socket_path == NULL){
+    ERROR_EXIT("Socket path can't be NULL");
+  }
+  if(strlen(socket_path) >= sizeof(address.sun_path)){
+    return -1;
+  }
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strcpy(address.sun_path, socket_path);
+  fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if(fd < 0){
+    return -1;
+  }
+  if(connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0){
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+/**
+ * @brief Send all bytes on a blocking socket
+ */
+static int send_all(int fd, const char *data, unsigned long len){
+  ssize_t sent;
+
+  while(len > 0){
+    sent = send(fd, data, len, MSG_NOSIGNAL);
+    if(sent < 0 && errno == EINTR){
+      continue;
+    }else if(sent <= 0){
+      return -1;
+    }
+    data += sent;
+    len -= (unsigned long)sent;
+  }
+  return 0;
+}
+
+/**
+ * @brief Receive exactly len bytes from a blocking socket
+ */
+static int recv_all(int fd, char *data, unsigned long len){
+  ssize_t received;
+
+  while(len > 0){
+    received = recv(fd, data, len, 0);
+    if(received < 0 && errno == EINTR){
+      continue;
+    }else if(received <= 0){
+      return -1;
+    }
+    data += received;
+    len -= (unsigned long)received;
+  }
+  return 0;
+}
+
+int server_send_frame(int fd, const char *data, uint32_t len){
+  uint32_t header = htonl(len);
+
+  if(len > SERVER_MAX_FRAME || (data == NULL && len > 0)){
+    return -1;
+  }
+  if(send_all(fd, (const char *)&header, HEADER_SIZE) != 0){
+    return -1;
+  }
+  return send_all(fd, data, len);
+}
+
+char *server_recv_frame(int fd, uint32_t *len){
+  uint32_t header;
+  char *data = NULL;
+
+  if(len == NULL){
+    ERROR_EXIT("Length reference can't be NULL");
+  }
+  if(recv_all(fd, (char *)&header, HEADER_SIZE) != 0){
+    return NULL;
+  }
+  *len = ntohl(header);
+  if(*len > SERVER_MAX_FRAME){
+    return NULL;
+  }
+  data = (char *)malloc((unsigned long)*len + 1);
+  if(data == NULL){
+    ERROR_EXIT("Unable to allocate frame");
+  }
+  if(recv_all(fd, data, *len) != 0){
+    free(data);
+    return NULL;
+  }
+  data[*len] = '\0';
+  return data;
+}
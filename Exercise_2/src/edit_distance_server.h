@@ -0,0 +1,126 @@
+#ifndef _EDIT_DISTANCE_SERVER_H_
+#define _EDIT_DISTANCE_SERVER_H_
+
+#include <stdint.h>
+#include <pthread.h>
+
+#define SERVER_MAX_FRAME (1 << 20)  // max payload of a request or a response
+
+/**
+ * @brief It rappresents a request read from a connection. Frames of protocol, in both
+ *        directions, are a 4 bytes length in network byte order followed by payload.
+ */
+typedef struct _ServerRequest{
+  char *payload;                          // payload of request, followed by '\0'
+  uint32_t len;                           // length of payload
+  char *response;                         // payload of response, allocated by handler with malloc, freed by server
+  uint32_t response_len;                  // length of response
+  struct _ServerConnection *connection;   // connection of request
+  struct _ServerRequest *next;            // next request in queue
+} ServerRequest;
+
+/**
+ * @brief Function answering a batch of requests, called by worker threads:
+ *        it sets response and response_len of every request.
+ *        A connection whose response is longer than SERVER_MAX_FRAME is closed.
+ *
+ * @param requests  requests, from different connections
+ * @param num       number of requests, at least 1
+ * @param context   user context
+ */
+typedef void (*ServerHandler)(ServerRequest **requests, unsigned long num, void *context);
+
+/**
+ * @brief It rappresents a server on a Unix domain socket: an epoll event loop reads and
+ *        writes all connections, a pool of worker threads answers requests.
+ *        Requests waiting in queue are taken by a worker all together, up to max_batch,
+ *        so concurrent requests are answered in batches.
+ *        A connection has at most a request being answered: requests sent without waiting
+ *        for responses are read in order after it, so responses come in order.
+ */
+typedef struct _Server{
+  int listen_fd;                  // listening socket
+  int epoll_fd;                   // epoll instance of event loop
+  int wake_fd;                    // eventfd signaled by workers when requests are answered
+  int stop_fd;                    // eventfd signaled by server_stop
+  char *socket_path;              // path of socket, removed at exit
+  ServerHandler handler;
+  void *context;
+  unsigned thread_num;            // number of worker threads
+  unsigned long max_batch;        // max requests answered by a worker at a time
+  pthread_t *workers;
+  pthread_mutex_t lock;           // guards queues and stopping
+  pthread_cond_t pending_ready;   // signaled when pending requests are queued
+  ServerRequest *pending_head, *pending_tail;   // requests waiting for a worker
+  ServerRequest *done_head, *done_tail;         // answered requests waiting for event loop
+  int stopping;                   // 1 when workers have to exit
+  int accept_paused;              // 1 when listening socket is not polled, no file descriptor is left
+  struct _ServerConnection *connections;        // open connections
+  struct _ServerConnection *closed;             // connections to free after events of current wait
+  unsigned long requests;         // number of answered requests
+  unsigned long batches;          // number of batches
+} Server;
+
+/**
+ * @brief Create a server listening on a Unix domain socket, an existing socket at path is replaced
+ *
+ * @param socket_path   path of socket, can't be NULL
+ * @param handler       function answering requests, can't be NULL
+ * @param context       context passed to handler
+ * @param thread_num    number of worker threads, at least 1
+ * @param max_batch     max requests answered by a worker at a time, at least 1
+ * @return Server*      allocated server, to free with server_free
+ */
+Server *server_create(const char *socket_path, ServerHandler handler, void *context, unsigned thread_num, unsigned long max_batch);
+
+/**
+ * @brief Serve connections until server_stop is called. Requests not answered yet
+ *        are discarded when it returns.
+ *
+ * @param server  server, can't be NULL
+ */
+void server_run(Server *server);
+
+/**
+ * @brief Make server_run return, it can be called from any thread and from signal handlers
+ *
+ * @param server  server, can't be NULL
+ */
+void server_stop(Server *server);
+
+/**
+ * @brief Close socket and free server
+ *
+ * @param server  server to free
+ */
+void server_free(Server *server);
+
+/**
+ * @brief Connect to a server
+ *
+ * @param socket_path   path of socket, can't be NULL
+ * @return int          connected socket, -1 on error
+ */
+int server_connect(const char *socket_path);
+
+/**
+ * @brief Send a frame on a blocking socket
+ *
+ * @param fd      socket
+ * @param data    payload, can't be NULL if len > 0
+ * @param len     length of payload, at most SERVER_MAX_FRAME
+ * @return int    0 on success, -1 on error
+ */
+int server_send_frame(int fd, const char *data, uint32_t len);
+
+/**
+ * @brief Receive a frame from a blocking socket
+ *
+ * @param fd      socket
+ * @param len     address where length of payload is stored
+ * @return char*  allocated payload followed by '\0', to free by caller, NULL if connection is closed, on error
+ *                or if frame is longer than SERVER_MAX_FRAME (then socket can't be used anymore)
+ */
+char *server_recv_frame(int fd, uint32_t *len);
+
+#endif
@@ -0,0 +1,230 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include "unity/unity.h"
+#include "edit_distance_server.h"
+
+#define CLIENTS (16)
+#define CLIENT_REQUESTS (50)
+
+static char socket_path[64];
+static int client_errors[CLIENTS];
+
+/**
+ * @brief Answer requests with payload in upper case, slowly so requests queue up
+ */
+static void upper_handler(ServerRequest **requests, unsigned long num, void *context){
+  (void)context;
+  for(unsigned long i = 0; i < num; i++){
+    requests[i]->response = (char *)malloc(requests[i]->len + 1);
+    for(uint32_t k = 0; k < requests[i]->len; k++){
+      requests[i]->response[k] = (char)toupper((unsigned char)requests[i]->payload[k]);
+    }
+    requests[i]->response_len = requests[i]->len;
+  }
+  usleep(2000);
+}
+
+static void *run_server(void *arg){
+  server_run((Server *)arg);
+  return NULL;
+}
+
+static Server *start_server(pthread_t *thread, unsigned thread_num){
+  Server *server;
+
+  snprintf(socket_path, sizeof(socket_path), "/tmp/server_test_%d.sock", (int)getpid());
+  server = server_create(socket_path, upper_handler, NULL, thread_num, 64);
+  TEST_ASSERT_EQUAL_INT(0, pthread_create(thread, NULL, run_server, server));
+  return server;
+}
+
+static void stop_server(Server *server, pthread_t thread){
+  server_stop(server);
+  pthread_join(thread, NULL);
+  server_free(server);
+}
+
+static void assert_response(int fd, const char *expected){
+  uint32_t len;
+  char *response = server_recv_frame(fd, &len);
+
+  TEST_ASSERT_NOT_NULL(response);
+  TEST_ASSERT_EQUAL_UINT32(strlen(expected), len);
+  TEST_ASSERT_EQUAL_STRING(expected, response);
+  free(response);
+}
+
+static void test_requests_in_order(void){
+  pthread_t thread;
+  Server *server = start_server(&thread, 2);
+  int fd = server_connect(socket_path);
+
+  TEST_ASSERT_TRUE(fd >= 0);
+  TEST_ASSERT_EQUAL_INT(0, server_send_frame(fd, "casa", 4));
+  assert_response(fd, "CASA");
+  TEST_ASSERT_EQUAL_INT(0, server_send_frame(fd, NULL, 0));
+  assert_response(fd, "");
+  // requests sent without waiting for responses
+  TEST_ASSERT_EQUAL_INT(0, server_send_frame(fd, "uno", 3));
+  TEST_ASSERT_EQUAL_INT(0, server_send_frame(fd, "due", 3));
+  TEST_ASSERT_EQUAL_INT(0, server_send_frame(fd, "tre", 3));
+  assert_response(fd, "UNO");
+  assert_response(fd, "DUE");
+  assert_response(fd, "TRE");
+  close(fd);
+  stop_server(server, thread);
+}
+
+/**
+ * @brief Client thread: unity assertions can't fail outside main thread, so it counts
+ *        wrong responses in its slot of errors
+ */
+static void *client(void *arg){
+  int *errors = (int *)arg, id = (int)(errors - client_errors), fd = server_connect(socket_path);
+  char request[32], expected[32], *response;
+  uint32_t len;
+
+  if(fd < 0){
+    (*errors)++;
+    return NULL;
+  }
+  for(int r = 0; r < CLIENT_REQUESTS; r++){
+    snprintf(request, sizeof(request), "client %d request %d", id, r);
+    snprintf(expected, sizeof(expected), "CLIENT %d REQUEST %d", id, r);
+    if(server_send_frame(fd, request, (uint32_t)strlen(request)) != 0 ||
+       (response = server_recv_frame(fd, &len)) == NULL){
+      (*errors)++;
+      break;
+    }
+    if(strcmp(response, expected) != 0){
+      (*errors)++;
+    }
+    free(response);
+  }
+  close(fd);
+  return NULL;
+}
+
+static void test_concurrent_clients(void){
+  pthread_t thread, clients[CLIENTS];
+  Server *server = start_server(&thread, 1);
+
+  for(int i = 0; i < CLIENTS; i++){
+    client_errors[i] = 0;
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&clients[i], NULL, client, &client_errors[i]));
+  }
+  for(int i = 0; i < CLIENTS; i++){
+    pthread_join(clients[i], NULL);
+    TEST_ASSERT_EQUAL_INT(0, client_errors[i]);
+  }
+  TEST_ASSERT_EQUAL_UINT64(CLIENTS * CLIENT_REQUESTS, server->requests);
+  // requests of clients waiting together are answered together
+  TEST_ASSERT_TRUE(server->batches < server->requests);
+  stop_server(server, thread);
+}
+
+static void test_bad_clients(void){
+  pthread_t thread;
+  Server *server = start_server(&thread, 2);
+  int fd = server_connect(socket_path);
+  uint32_t header = htonl(SERVER_MAX_FRAME + 1), len;
+
+  // client leaving before response
+  TEST_ASSERT_TRUE(fd >= 0);
+  TEST_ASSERT_EQUAL_INT(0, server_send_frame(fd, "ciao", 4));
+  close(fd);
+
+  // frame too long closes connection
+  fd = server_connect(socket_path);
+  TEST_ASSERT_EQUAL_INT64(4, (long)write(fd, &header, 4));
+  TEST_ASSERT_NULL(server_recv_frame(fd, &len));
+  close(fd);
+
+  fd = server_connect(socket_path);
+  TEST_ASSERT_EQUAL_INT(0, server_send_frame(fd, "ancora", 6));
+  assert_response(fd, "ANCORA");
+  close(fd);
+  stop_server(server, thread);
+}
+
+static void test_long_frame_rejected(void){
+  int fds[2];
+  uint32_t header = htonl(SERVER_MAX_FRAME + 1), len;
+
+  // client doesn't allocate a frame longer than SERVER_MAX_FRAME
+  TEST_ASSERT_EQUAL_INT(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  TEST_ASSERT_EQUAL_INT64(4, (long)write(fds[0], &header, 4));
+  TEST_ASSERT_NULL(server_recv_frame(fds[1], &len));
+  close(fds[0]);
+  close(fds[1]);
+}
+
+static double cpu_time(void){
+  struct timespec time;
+
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+  return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+}
+
+static void test_no_file_descriptors(void){
+  pthread_t thread;
+  Server *server;
+  struct rlimit old_limit, limit;
+  int fds[4], probe;
+  double cpu_start;
+
+  snprintf(socket_path, sizeof(socket_path), "/tmp/server_test_%d.sock", (int)getpid());
+  server = server_create(socket_path, upper_handler, NULL, 1, 64);
+  // clients wait in backlog, then server can accept only two of them
+  for(int i = 0; i < 4; i++){
+    fds[i] = server_connect(socket_path);
+    TEST_ASSERT_TRUE(fds[i] >= 0);
+  }
+  probe = dup(0);
+  close(probe);
+  TEST_ASSERT_EQUAL_INT(0, getrlimit(RLIMIT_NOFILE, &old_limit));
+  limit = old_limit;
+  limit.rlim_cur = (rlim_t)probe + 2;
+  TEST_ASSERT_EQUAL_INT(0, setrlimit(RLIMIT_NOFILE, &limit));
+  TEST_ASSERT_EQUAL_INT(0, pthread_create(&thread, NULL, run_server, server));
+
+  TEST_ASSERT_EQUAL_INT(0, server_send_frame(fds[0], "uno", 3));
+  assert_response(fds[0], "UNO");
+  // event loop doesn't spin while listening socket is readable and nothing can be accepted
+  cpu_start = cpu_time();
+  usleep(200000);
+  TEST_ASSERT_TRUE(cpu_time() - cpu_start < 0.05);
+  TEST_ASSERT_EQUAL_INT(1, server->accept_paused);
+
+  // a closed connection gives its file descriptor to a waiting client
+  close(fds[0]);
+  TEST_ASSERT_EQUAL_INT(0, server_send_frame(fds[2], "tre", 3));
+  assert_response(fds[2], "TRE");
+
+  TEST_ASSERT_EQUAL_INT(0, setrlimit(RLIMIT_NOFILE, &old_limit));
+  for(int i = 1; i < 4; i++){
+    close(fds[i]);
+  }
+  stop_server(server, thread);
+}
+
+int main(void){
+
+  // test session
+  UNITY_BEGIN();
+  RUN_TEST(test_requests_in_order);
+  RUN_TEST(test_concurrent_clients);
+  RUN_TEST(test_bad_clients);
+  RUN_TEST(test_long_frame_rejected);
+  RUN_TEST(test_no_file_descriptors);
+
+  return UNITY_END();
+}
@@ -0,0 +1,204 @@
+/**
+ * @file edit_distance_simd.c
+ * @author Daniele Di Palma
+ * @brief Edit distance (insertions and deletions only) computed by anti-diagonals
+ *        with SSE4.1 / AVX2 kernels selected at runtime
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include "edit_distance_simd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86
+#endif
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+/**
+ * @brief It rappresents a kernel computing a segment of an anti-diagonal of LCS table:
+ *        cell k is diag[k] + 1 if a[k] == b[k], otherwise max(up[k], left[k]).
+ *
+ * @param cur     cells to compute
+ * @param up      cells above, on previous anti-diagonal
+ * @param left    cells on the left, on previous anti-diagonal
+ * @param diag    cells above on the left, on second previous anti-diagonal
+ * @param a       characters of first string of every cell
+ * @param b       characters of second string of every cell
+ * @param count   number of cells
+ */
+typedef void (*DiagonalKernel)(uint16_t *cur, const uint16_t *up, const uint16_t *left, const uint16_t *diag,
+                                const unsigned char *a, const unsigned char *b, unsigned long count);
+
+/**
+ * @brief Compute a segment of anti-diagonal one cell at a time. Cells are stored modulo 2^16:
+ *        up and left differ by at most 1, so the greatest is found from their difference.
+ */
+static void diagonal_scalar(uint16_t *cur, const uint16_t *up, const uint16_t *left, const uint16_t *diag,
+                            const unsigned char *a, const unsigned char *b, unsigned long count){
+  for(unsigned long k = 0; k < count; k++){
+    if(a[k] == b[k]){
+      cur[k] = (uint16_t)(diag[k] + 1);
+    }else{
+      cur[k] = ((int16_t)(uint16_t)(left[k] - up[k]) > 0) ? left[k] : up[k];
+    }
+  }
+}
+
+#ifdef SIMD_X86
+
+/**
+ * @brief Compute a segment of anti-diagonal 8 cells at a time with SSE4.1
+ */
+__attribute__((target("sse4.1")))
+static void diagonal_sse41(uint16_t *cur, const uint16_t *up, const uint16_t *left, const uint16_t *diag,
+                            const unsigned char *a, const unsigned char *b, unsigned long count){
+  const __m128i zero = _mm_setzero_si128(), one = _mm_set1_epi16(1);
+  __m128i up_v, max_v, match_v, eq;
+  unsigned long k = 0;
+
+  for(; k + 8 <= count; k += 8){
+    eq = _mm_cvtepi8_epi16(_mm_cmpeq_epi8(_mm_loadl_epi64((const __m128i *)&a[k]), _mm_loadl_epi64((const __m128i *)&b[k])));
+    up_v = _mm_loadu_si128((const __m128i *)&up[k]);
+    max_v = _mm_add_epi16(up_v, _mm_max_epi16(_mm_sub_epi16(_mm_loadu_si128((const __m128i *)&left[k]), up_v), zero));
+    match_v = _mm_add_epi16(_mm_loadu_si128((const __m128i *)&diag[k]), one);
+    _mm_storeu_si128((__m128i *)&cur[k], _mm_blendv_epi8(max_v, match_v, eq));
+  }
+  diagonal_scalar(&cur[k], &up[k], &left[k], &diag[k], &a[k], &b[k], count - k);
+}
+
+/**
+ * @brief Compute a segment of anti-diagonal 16 cells at a time with AVX2
+ */
+__attribute__((target("avx2")))
+static void diagonal_avx2(uint16_t *cur, const uint16_t *up, const uint16_t *left, const uint16_t *diag,
+                          const unsigned char *a, const unsigned char *b, unsigned long count){
+  const __m256i zero = _mm256_setzero_si256(), one = _mm256_set1_epi16(1);
+  __m256i up_v, max_v, match_v, eq;
+  unsigned long k = 0;
+
+  for(; k + 16 <= count; k += 16){
+    eq = _mm256_cvtepi8_epi16(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)&a[k]), _mm_loadu_si128((const __m128i *)&b[k])));
+    up_v = _mm256_loadu_si256((const __m256i *)&up[k]);
+    max_v = _mm256_add_epi16(up_v, _mm256_max_epi16(_mm256_sub_epi16(_mm256_loadu_si256((const __m256i *)&left[k]), up_v), zero));
+    match_v = _mm256_add_epi16(_mm256_loadu_si256((const __m256i *)&diag[k]), one);
+    _mm256_storeu_si256((__m256i *)&cur[k], _mm256_blendv_epi8(max_v, match_v, eq));
+  }
+  diagonal_scalar(&cur[k], &up[k], &left[k], &diag[k], &a[k], &b[k], count - k);
+}
+
+#endif
+
+int edit_distance_simd_kernel(void){
+  static int kernel = -1;
+
+  if(kernel < 0){
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")){
+      kernel = SIMD_KERNEL_AVX2;
+    }else if(__builtin_cpu_supports("sse4.1")){
+      kernel = SIMD_KERNEL_SSE41;
+    }else{
+      kernel = SIMD_KERNEL_SCALAR;
+    }
+#else
+    kernel = SIMD_KERNEL_SCALAR;
+#endif
+  }
+  return kernel;
+}
+
+const char *edit_distance_simd_kernel_name(int kernel){
+  if(kernel == SIMD_KERNEL_AVX2){
+    return "avx2";
+  }else if(kernel == SIMD_KERNEL_SSE41){
+    return "sse4.1";
+  }
+  return "scalar";
+}
+
+unsigned edit_distance_simd_with(char *s1, char *s2, int kernel){
+  DiagonalKernel diagonal = diagonal_scalar;
+  const unsigned char *a, *b, *tmp;
+  unsigned char *reversed = NULL;
+  uint16_t *rows = NULL, *prev2, *prev, *cur, *swap, last_v = 0;
+  unsigned long m, n, lo, hi, lcs = 0;
+
+  if(s1 == NULL || s2 == NULL){
+    ERROR_EXIT("Strings can't be NULL");
+  }
+  if(kernel < SIMD_KERNEL_SCALAR || kernel > edit_distance_simd_kernel()){
+    ERROR_EXIT("Kernel not supported by cpu");
+  }
+#ifdef SIMD_X86
+  if(kernel == SIMD_KERNEL_AVX2){
+    diagonal = diagonal_avx2;
+  }else if(kernel == SIMD_KERNEL_SSE41){
+    diagonal = diagonal_sse41;
+  }
+#endif
+
+  // rows of table are the shortest string
+  m = strlen(s1);
+  n = strlen(s2);
+  a = (const unsigned char *)s1;
+  b = (const unsigned char *)s2;
+  if(m > n){
+    tmp = a; a = b; b = tmp;
+    lo = m; m = n; n = lo;
+  }
+  if(m + n >= UINT_MAX){
+    ERROR_EXIT("Strings too long");
+  }
+  if(m == 0){
+    return (unsigned)n;
+  }
+
+  // on anti-diagonal d cell of row i is in column d - i: second string is reversed
+  // so characters of consecutive rows are consecutive
+  reversed = (unsigned char *)malloc(n);
+  rows = (uint16_t *)calloc(3 * (m + 1), sizeof(uint16_t));
+  if(reversed == NULL || rows == NULL){
+    ERROR_EXIT("Unable to allocate anti-diagonals");
+  }
+  for(unsigned long j = 0; j < n; j++){
+    reversed[j] = b[n - 1 - j];
+  }
+  prev2 = rows;
+  prev = &rows[m + 1];
+  cur = &rows[2 * (m + 1)];
+
+  // cells of row 0 and column 0 are 0 and never written
+  for(unsigned long d = 2; d <= m + n; d++){
+    lo = (d > n) ? d - n : 1;
+    hi = (d - 1 < m) ? d - 1 : m;
+    diagonal(&cur[lo], &prev[lo - 1], &prev[lo], &prev2[lo - 1], &a[lo - 1], &reversed[n - d + lo], hi - lo + 1);
+
+    // last row grows by 0 or 1 for every column, so its exact value is the sum of steps
+    if(hi == m){
+      lcs += (uint16_t)(cur[m] - last_v);
+      last_v = cur[m];
+    }
+
+    swap = prev2;
+    prev2 = prev;
+    prev = cur;
+    cur = swap;
+  }
+
+  free(reversed);
+  free(rows);
+  return (unsigned)(m + n - 2 * lcs);
+}
+
+unsigned edit_distance_simd(char *s1, char *s2){
+  return edit_distance_simd_with(s1, s2, edit_distance_simd_kernel());
+}
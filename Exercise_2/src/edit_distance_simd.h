@@ -0,0 +1,52 @@
+#ifndef _EDIT_DISTANCE_SIMD_H_
+#define _EDIT_DISTANCE_SIMD_H_
+
+// kernels of edit_distance_simd_with, a cpu supporting a kernel supports the previous ones
+#define SIMD_KERNEL_SCALAR (0)
+#define SIMD_KERNEL_SSE41 (1)
+#define SIMD_KERNEL_AVX2 (2)
+
+/**
+ * @brief Calculate edit distance between two strings evaluating the LCS table
+ *        by anti-diagonals: cells of an anti-diagonal only depend on the two previous ones,
+ *        so they are computed 8 (SSE4.1) or 16 (AVX2) at a time in 16 bit lanes.
+ *        Only insertions and deletions are allowed, so distance is
+ *        len(s1) + len(s2) - 2 * LCS(s1, s2).
+ *        Lanes wrap around: adjacent LCS cells differ by at most 1, so max of two cells
+ *        is computed from their difference and only the final LCS is tracked exactly,
+ *        strings of any length are supported.
+ *        O(len(s1) * len(s2)) time, O(min(len(s1), len(s2))) memory.
+ *        Kernel is the best one supported by running cpu (see edit_distance_simd_kernel).
+ *
+ * @param s1  first string, can't be NULL
+ * @param s2  second string, can't be NULL
+ * @return unsigned number of operation
+ */
+unsigned edit_distance_simd(char *s1, char *s2);
+
+/**
+ * @brief Calculate edit_distance_simd with a given kernel
+ *
+ * @param s1      first string, can't be NULL
+ * @param s2      second string, can't be NULL
+ * @param kernel  SIMD_KERNEL_SCALAR, SIMD_KERNEL_SSE41 or SIMD_KERNEL_AVX2, supported by cpu
+ * @return unsigned number of operation
+ */
+unsigned edit_distance_simd_with(char *s1, char *s2, int kernel);
+
+/**
+ * @brief Get best kernel supported by running cpu
+ *
+ * @return int  SIMD_KERNEL_AVX2, SIMD_KERNEL_SSE41 or SIMD_KERNEL_SCALAR
+ */
+int edit_distance_simd_kernel(void);
+
+/**
+ * @brief Get name of a kernel
+ *
+ * @param kernel        kernel
+ * @return const char*  name of kernel
+ */
+const char *edit_distance_simd_kernel_name(int kernel);
+
+#endif
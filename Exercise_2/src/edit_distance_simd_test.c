@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity/unity.h"
+#include "edit_distance_simd.h"
+#include "edit_distance_dyn.h"
+#include "edit_distance_bp.h"
+
+static void test_empty_strings(void){
+  for(int kernel = SIMD_KERNEL_SCALAR; kernel <= edit_distance_simd_kernel(); kernel++){
+    TEST_ASSERT_EQUAL_INT(0, edit_distance_simd_with("", "", kernel));
+    TEST_ASSERT_EQUAL_INT(7, edit_distance_simd_with("", "welcome", kernel));
+    TEST_ASSERT_EQUAL_INT(5, edit_distance_simd_with("hello", "", kernel));
+  }
+}
+
+static void test_small_strings(void){
+  for(int kernel = SIMD_KERNEL_SCALAR; kernel <= edit_distance_simd_kernel(); kernel++){
+    TEST_ASSERT_EQUAL_INT(0, edit_distance_simd_with("pioppo", "pioppo", kernel));
+    TEST_ASSERT_EQUAL_INT(4, edit_distance_simd_with("tassa", "passato", kernel));
+    TEST_ASSERT_EQUAL_INT(4, edit_distance_simd_with("passato", "tassa", kernel));
+    TEST_ASSERT_EQUAL_INT(2, edit_distance_simd_with("casa", "cara", kernel));
+    TEST_ASSERT_EQUAL_INT(3, edit_distance_simd_with("perch\xc3\xa9", "perche", kernel));
+  }
+}
+
+static void test_same_as_dyn_random_strings(void){
+  char s1[300], s2[300];
+
+  srand(23);
+  for(int t = 0; t < 1000; t++){
+    // lengths around lane counts and partial vectors
+    int len1 = rand() % 299, len2 = (t % 2) ? rand() % 40 : rand() % 299;
+    for(int i = 0; i < len1; i++) s1[i] = (char)('a' + rand() % 3);
+    for(int i = 0; i < len2; i++) s2[i] = (char)('a' + rand() % 3);
+    s1[len1] = '\0';
+    s2[len2] = '\0';
+    for(int kernel = SIMD_KERNEL_SCALAR; kernel <= edit_distance_simd_kernel(); kernel++){
+      TEST_ASSERT_EQUAL_INT(edit_distance_dyn(s1, s2), edit_distance_simd_with(s1, s2, kernel));
+    }
+  }
+}
+
+static void test_lcs_beyond_16_bits(void){
+  unsigned long len = 68000;
+  char *s1 = (char *)malloc(len + 1);
+  char *s2 = (char *)malloc(len + 1);
+
+  // LCS wraps around 16 bit lanes
+  srand(7);
+  for(unsigned long i = 0; i < len; i++){
+    s1[i] = (char)('a' + rand() % 4);
+    s2[i] = (rand() % 50 == 0) ? (char)('a' + rand() % 4) : s1[i];
+  }
+  s1[len] = s2[len] = '\0';
+  TEST_ASSERT_EQUAL_INT(edit_distance_bp(s1, s2), edit_distance_simd(s1, s2));
+  free(s1);
+  free(s2);
+}
+
+int main(void){
+
+  // test session
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_strings);
+  RUN_TEST(test_small_strings);
+  RUN_TEST(test_same_as_dyn_random_strings);
+  RUN_TEST(test_lcs_beyond_16_bits);
+
+  return UNITY_END();
+}
@@ -0,0 +1,269 @@
+/**
+ * @file edit_distance_stream.c
+ * @author Daniele Di Palma
+ * @brief Pipeline over an input of any size: a reader splits it in chunks of words,
+ *        worker threads process them and a writer writes their output in input order
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "edit_distance_stream.h"
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+/**
+ * @brief Split a piece of input in words and give it to workers,
+ *        waiting while STREAM_MAX_CHUNKS chunks are not written yet
+ *
+ * @param stream  stream
+ * @param text    piece of input, ending between words
+ * @param len     length of text
+ */
+static void push_chunk(Stream *stream, const char *text, unsigned long len){
+  StreamChunk *chunk = NULL;
+  TokenFile *tokens = token_file_parse(text, len, stream->delimiters);
+
+  if(tokens->word_num == 0){
+    token_file_free(tokens);
+    return;
+  }
+  chunk = (StreamChunk *)malloc(sizeof(StreamChunk));
+  if(chunk == NULL){
+    ERROR_EXIT("Unable to allocate chunk");
+  }
+  chunk->tokens = tokens;
+  chunk->output = NULL;
+  chunk->output_len = 0;
+  chunk->done = 0;
+
+  pthread_mutex_lock(&stream->lock);
+  if(stream->read_chunks - stream->written_chunks >= STREAM_MAX_CHUNKS){
+    stream->stalls++;
+  }
+  while(stream->read_chunks - stream->written_chunks >= STREAM_MAX_CHUNKS){
+    pthread_cond_wait(&stream->chunk_written, &stream->lock);
+  }
+  stream->ring[stream->read_chunks % STREAM_MAX_CHUNKS] = chunk;
+  stream->read_chunks++;
+  pthread_cond_signal(&stream->chunk_read);
+  pthread_mutex_unlock(&stream->lock);
+}
+
+/**
+ * @brief Reader stage: it reads input and gives it to workers up to the last delimiter read.
+ *        Buffer is doubled while a single word fills it, up to STREAM_MAX_WORD.
+ *
+ * @param stream  stream
+ * @param fd      input file descriptor
+ */
+static void read_input(Stream *stream, int fd){
+  unsigned long capacity = STREAM_CHUNK_SIZE, filled = 0, end, size;
+  char *buffer = (char *)malloc(capacity);
+  ssize_t read_num;
+  int eof = 0;
+
+  if(buffer == NULL){
+    ERROR_EXIT("Unable to allocate input buffer");
+  }
+  while(!eof){
+    if(filled == capacity){
+      capacity *= 2;
+      buffer = (char *)realloc(buffer, capacity);
+      if(buffer == NULL){
+        ERROR_EXIT("Unable to re-allocate input buffer");
+      }
+    }
+    size = (capacity - filled < STREAM_CHUNK_SIZE) ? capacity - filled : STREAM_CHUNK_SIZE;
+    read_num = read(fd, &buffer[filled], size);
+    if(read_num < 0){
+      if(errno == EINTR){
+        continue;
+      }
+      ERROR_EXIT("Unable to read input");
+    }
+    eof = (read_num == 0);
+    filled += (unsigned long)read_num;
+
+    end = filled;
+    if(!eof){
+      while(end > 0 && buffer[end - 1] != '\0' && strchr(stream->delimiters, buffer[end - 1]) == NULL){
+        end--;
+      }
+      if(end == 0 && filled == STREAM_MAX_WORD){
+        end = filled;
+      }
+    }
+    if(end > 0){
+      push_chunk(stream, buffer, end);
+      memmove(buffer, &buffer[end], filled - end);
+      filled -= end;
+    }
+  }
+  free(buffer);
+
+  pthread_mutex_lock(&stream->lock);
+  stream->eof = 1;
+  pthread_cond_broadcast(&stream->chunk_read);
+  pthread_cond_broadcast(&stream->chunk_done);
+  pthread_mutex_unlock(&stream->lock);
+}
+
+/**
+ * @brief Worker stage: it processes chunks in the order they are read, until input is finished
+ *
+ * @param arg     stream
+ * @return void*  NULL
+ */
+static void *stream_worker(void *arg){
+  Stream *stream = (Stream *)arg;
+  StreamChunk *chunk = NULL;
+
+  while(1){
+    pthread_mutex_lock(&stream->lock);
+    while(stream->taken_chunks == stream->read_chunks && !stream->eof){
+      pthread_cond_wait(&stream->chunk_read, &stream->lock);
+    }
+    if(stream->taken_chunks == stream->read_chunks){
+      pthread_mutex_unlock(&stream->lock);
+      return NULL;
+    }
+    chunk = stream->ring[stream->taken_chunks % STREAM_MAX_CHUNKS];
+    stream->taken_chunks++;
+    pthread_mutex_unlock(&stream->lock);
+
+    stream->handler(chunk, stream->context);
+
+    pthread_mutex_lock(&stream->lock);
+    chunk->done = 1;
+    pthread_cond_signal(&stream->chunk_done);
+    pthread_mutex_unlock(&stream->lock);
+  }
+}
+
+/**
+ * @brief Writer stage: it writes chunks in input order, every chunk as soon as it and
+ *        all previous chunks are processed
+ *
+ * @param arg     stream
+ * @return void*  NULL
+ */
+static void *stream_writer(void *arg){
+  Stream *stream = (Stream *)arg;
+  struct timespec now;
+  StreamChunk *chunk = NULL;
+
+  while(1){
+    pthread_mutex_lock(&stream->lock);
+    while(!(stream->written_chunks < stream->read_chunks && stream->ring[stream->written_chunks % STREAM_MAX_CHUNKS]->done) &&
+          !(stream->eof && stream->written_chunks == stream->read_chunks)){
+      pthread_cond_wait(&stream->chunk_done, &stream->lock);
+    }
+    if(stream->written_chunks == stream->read_chunks){
+      pthread_mutex_unlock(&stream->lock);
+      return NULL;
+    }
+    chunk = stream->ring[stream->written_chunks % STREAM_MAX_CHUNKS];
+    pthread_mutex_unlock(&stream->lock);
+
+    if(chunk->output_len > 0 && fwrite(chunk->output, 1, chunk->output_len, stream->output) != chunk->output_len){
+      ERROR_EXIT("Unable to write output");
+    }
+    fflush(stream->output);
+    if(stream->first_output < 0){
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      stream->first_output = (double)(now.tv_sec - stream->start_time.tv_sec) + (double)(now.tv_nsec - stream->start_time.tv_nsec) / 1e9;
+    }
+    stream->words += chunk->tokens->word_num;
+    token_file_free(chunk->tokens);
+    free(chunk->output);
+    free(chunk);
+
+    pthread_mutex_lock(&stream->lock);
+    stream->ring[stream->written_chunks % STREAM_MAX_CHUNKS] = NULL;
+    stream->written_chunks++;
+    pthread_cond_signal(&stream->chunk_written);
+    pthread_mutex_unlock(&stream->lock);
+  }
+}
+
+Stream *stream_create(StreamHandler handler, void *context, unsigned thread_num, const char *delimiters){
+  Stream *stream = NULL;
+
+  if(handler == NULL || delimiters == NULL){
+    ERROR_EXIT("Handler and delimiters can't be NULL");
+  }
+  if(thread_num == 0){
+    ERROR_EXIT("At least a thread is needed");
+  }
+  stream = (Stream *)malloc(sizeof(Stream));
+  if(stream == NULL){
+    ERROR_EXIT("Unable to allocate stream");
+  }
+  stream->handler = handler;
+  stream->context = context;
+  stream->thread_num = thread_num;
+  stream->delimiters = delimiters;
+  memset(stream->ring, 0, sizeof(stream->ring));
+  stream->read_chunks = stream->taken_chunks = stream->written_chunks = 0;
+  stream->eof = 0;
+  stream->output = NULL;
+  stream->words = 0;
+  stream->stalls = 0;
+  stream->first_output = -1;
+  if(pthread_mutex_init(&stream->lock, NULL) != 0 || pthread_cond_init(&stream->chunk_read, NULL) != 0 ||
+     pthread_cond_init(&stream->chunk_done, NULL) != 0 || pthread_cond_init(&stream->chunk_written, NULL) != 0){
+    ERROR_EXIT("Unable to initialize stream");
+  }
+  return stream;
+}
+
+void stream_run(Stream *stream, int fd, FILE *output){
+  pthread_t *workers = NULL, writer;
+
+  if(stream == NULL || output == NULL){
+    ERROR_EXIT("Stream and output references can't be NULL");
+  }
+  workers = (pthread_t *)malloc(stream->thread_num * sizeof(pthread_t));
+  if(workers == NULL){
+    ERROR_EXIT("Unable to allocate threads");
+  }
+  stream->read_chunks = stream->taken_chunks = stream->written_chunks = 0;
+  stream->eof = 0;
+  stream->output = output;
+  stream->words = 0;
+  stream->stalls = 0;
+  stream->first_output = -1;
+
+  clock_gettime(CLOCK_MONOTONIC, &stream->start_time);
+  for(unsigned t = 0; t < stream->thread_num; t++){
+    if(pthread_create(&workers[t], NULL, stream_worker, stream) != 0){
+      ERROR_EXIT("Unable to create thread");
+    }
+  }
+  if(pthread_create(&writer, NULL, stream_writer, stream) != 0){
+    ERROR_EXIT("Unable to create thread");
+  }
+  read_input(stream, fd);
+  for(unsigned t = 0; t < stream->thread_num; t++){
+    pthread_join(workers[t], NULL);
+  }
+  pthread_join(writer, NULL);
+  free(workers);
+}
+
+void stream_free(Stream *stream){
+  if(stream != NULL){
+    pthread_mutex_destroy(&stream->lock);
+    pthread_cond_destroy(&stream->chunk_read);
+    pthread_cond_destroy(&stream->chunk_done);
+    pthread_cond_destroy(&stream->chunk_written);
+    free(stream);
+  }
+}
@@ -0,0 +1,92 @@
+#ifndef _EDIT_DISTANCE_STREAM_H_
+#define _EDIT_DISTANCE_STREAM_H_
+
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include "edit_distance_tokens.h"
+
+#define STREAM_CHUNK_SIZE (4 * 1024)  // max bytes of input read at a time
+#define STREAM_MAX_CHUNKS (256)       // max chunks read and not written yet, it bounds memory, not threads
+#define STREAM_MAX_WORD (1 << 20)     // longest word kept whole, longer words are split in pieces of this length
+
+/**
+ * @brief It rappresents a chunk of input: words read together and the text written for them
+ */
+typedef struct _StreamChunk{
+  TokenFile *tokens;          // words of chunk, at least 1
+  char *output;               // text written for chunk, allocated by handler with malloc, freed by stream
+  unsigned long output_len;   // length of output
+  int done;                   // 1 when handler has set output
+} StreamChunk;
+
+/**
+ * @brief Function processing a chunk, called by worker threads: it sets output and output_len of chunk.
+ *        Chunks are processed in any order and by many threads at a time.
+ *
+ * @param chunk     chunk to process
+ * @param context   user context
+ */
+typedef void (*StreamHandler)(StreamChunk *chunk, void *context);
+
+/**
+ * @brief It rappresents a pipeline over an input of any size: a reader splits input in chunks
+ *        of words, worker threads process them and a writer writes their output in input order
+ *        as soon as every chunk before is written, while input is still being read.
+ *        Chunks read and not written yet are at most STREAM_MAX_CHUNKS, kept in a ring by
+ *        sequence number: the reader waits for the writer when the ring is full,
+ *        so memory doesn't depend on input size.
+ */
+typedef struct _Stream{
+  StreamHandler handler;
+  void *context;
+  unsigned thread_num;                    // number of worker threads
+  const char *delimiters;                 // characters separating words
+  StreamChunk *ring[STREAM_MAX_CHUNKS];   // chunk of sequence number n is in ring[n % STREAM_MAX_CHUNKS]
+  unsigned long read_chunks;              // chunks given by reader
+  unsigned long taken_chunks;             // chunks taken by workers
+  unsigned long written_chunks;           // chunks written by writer
+  int eof;                                // 1 when input is finished
+  pthread_mutex_t lock;                   // guards ring, counters and eof
+  pthread_cond_t chunk_read;              // signaled to workers when a chunk is read or input is finished
+  pthread_cond_t chunk_done;              // signaled to writer when a chunk is processed or input is finished
+  pthread_cond_t chunk_written;           // signaled to reader when a chunk is written
+  FILE *output;                           // where output of chunks is written
+  unsigned long words;                    // words written
+  unsigned long stalls;                   // times reader waited for a full ring
+  struct timespec start_time;             // start of last stream_run
+  double first_output;                    // seconds from start to first written chunk, -1 if none
+} Stream;
+
+/**
+ * @brief Create a stream pipeline
+ *
+ * @param handler       function processing chunks, can't be NULL
+ * @param context       context passed to handler
+ * @param thread_num    number of worker threads, at least 1
+ * @param delimiters    characters separating words, can't be NULL, must live as long as the stream
+ * @return Stream*      allocated stream, to free with stream_free
+ */
+Stream *stream_create(StreamHandler handler, void *context, unsigned thread_num, const char *delimiters);
+
+/**
+ * @brief Read input until its end and write output of every chunk. Input is read
+ *        STREAM_CHUNK_SIZE bytes at most at a time and given to workers as soon as it comes
+ *        (e.g. a line typed on a terminal). The word crossing the end of what is read is kept
+ *        for the next read, so words are split as in the whole input, unless it is longer than
+ *        STREAM_MAX_WORD.
+ *
+ * @param stream  stream, can't be NULL
+ * @param fd      input file descriptor
+ * @param output  where output is written, can't be NULL
+ */
+void stream_run(Stream *stream, int fd, FILE *output);
+
+/**
+ * @brief Free stream
+ *
+ * @param stream  stream to free
+ */
+void stream_free(Stream *stream);
+
+#endif
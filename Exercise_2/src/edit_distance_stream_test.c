@@ -0,0 +1,271 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "unity/unity.h"
+#include "edit_distance_stream.h"
+#include "edit_distance_tokens.h"
+
+#define DELIMITERS (" \n")
+
+/**
+ * @brief It rappresents input written on a pipe by a feeder thread
+ */
+typedef struct _Feeder{
+  int fd;             // write end of pipe
+  const char *text;
+  unsigned long len;
+  int errors;         // failed writes, checked by main thread
+} Feeder;
+
+/**
+ * @brief It rappresents how the echo handler slows down chunks
+ */
+typedef struct _EchoDelay{
+  unsigned every_chunk_us;    // sleep for every chunk
+  unsigned some_chunks_us;    // sleep for chunks whose first word starts with a, e, i, ...
+} EchoDelay;
+
+/**
+ * @brief Write every word of chunk on a line, as the batch path of expected_output
+ */
+static void echo_handler(StreamChunk *chunk, void *context){
+  const EchoDelay *delay = (const EchoDelay *)context;
+  char *p;
+
+  if(delay != NULL){
+    usleep(delay->every_chunk_us + ((chunk->tokens->word[0][0] - 'a') % 4 == 0 ? delay->some_chunks_us : 0));
+  }
+  chunk->output_len = chunk->tokens->arena_size;
+  chunk->output = p = (char *)malloc(chunk->output_len > 0 ? chunk->output_len : 1);
+  for(unsigned long i = 0; i < chunk->tokens->word_num; i++){
+    unsigned long len = strlen(chunk->tokens->word[i]);
+    memcpy(p, chunk->tokens->word[i], len);
+    p[len] = '\n';
+    p += len + 1;
+  }
+  chunk->output_len = (unsigned long)(p - chunk->output);
+}
+
+static void *feed(void *arg){
+  Feeder *feeder = (Feeder *)arg;
+  unsigned long sent = 0, size;
+  ssize_t written;
+
+  // pieces of different size, reads of stream don't match writes
+  while(sent < feeder->len){
+    size = 1 + (sent * 7919) % 9000;
+    if(size > feeder->len - sent){
+      size = feeder->len - sent;
+    }
+    written = write(feeder->fd, &feeder->text[sent], size);
+    if(written <= 0){
+      feeder->errors++;
+      break;
+    }
+    sent += (unsigned long)written;
+  }
+  close(feeder->fd);
+  return NULL;
+}
+
+/**
+ * @brief Run stream on text written on a pipe
+ *
+ * @param stream      stream
+ * @param text        input
+ * @param len         length of input
+ * @param output_len  address where length of output is stored
+ * @return char*      allocated output followed by '\0'
+ */
+static char *run_stream(Stream *stream, const char *text, unsigned long len, unsigned long *output_len){
+  int fds[2];
+  pthread_t feeder_thread;
+  Feeder feeder;
+  FILE *output = tmpfile();
+  char *result;
+
+  TEST_ASSERT_NOT_NULL(output);
+  TEST_ASSERT_EQUAL_INT(0, pipe(fds));
+  feeder.fd = fds[1];
+  feeder.text = text;
+  feeder.len = len;
+  feeder.errors = 0;
+  TEST_ASSERT_EQUAL_INT(0, pthread_create(&feeder_thread, NULL, feed, &feeder));
+  stream_run(stream, fds[0], output);
+  pthread_join(feeder_thread, NULL);
+  close(fds[0]);
+  TEST_ASSERT_EQUAL_INT(0, feeder.errors);
+
+  *output_len = (unsigned long)ftell(output);
+  result = (char *)malloc(*output_len + 1);
+  rewind(output);
+  TEST_ASSERT_EQUAL_UINT64(*output_len, fread(result, 1, *output_len, output));
+  result[*output_len] = '\0';
+  fclose(output);
+  return result;
+}
+
+/**
+ * @brief Words of the whole input split at once, one for every line
+ */
+static char *expected_output(const char *text, unsigned long len, unsigned long *word_num){
+  TokenFile *tokens = token_file_parse(text, len, DELIMITERS);
+  char *result = (char *)malloc(tokens->arena_size + 1), *p = result;
+
+  for(unsigned long i = 0; i < tokens->word_num; i++){
+    p += sprintf(p, "%s\n", tokens->word[i]);
+  }
+  *p = '\0';
+  *word_num = tokens->word_num;
+  token_file_free(tokens);
+  return result;
+}
+
+/**
+ * @brief Random text of short words separated by one or more delimiters
+ */
+static char *random_text(unsigned long len){
+  char *text = (char *)malloc(len);
+  unsigned long i = 0;
+
+  while(i < len){
+    int word_len = 1 + rand() % 12;
+    for(int k = 0; k < word_len && i < len; k++){
+      text[i++] = (char)('a' + rand() % 26);
+    }
+    for(int k = 0; k < 1 + rand() % 2 && i < len; k++){
+      text[i++] = (rand() % 8 == 0) ? '\n' : ' ';
+    }
+  }
+  return text;
+}
+
+static void assert_same_as_whole_input(Stream *stream, const char *text, unsigned long len){
+  unsigned long output_len, word_num;
+  char *output = run_stream(stream, text, len, &output_len);
+  char *expected = expected_output(text, len, &word_num);
+
+  TEST_ASSERT_EQUAL_UINT64(strlen(expected), output_len);
+  TEST_ASSERT_TRUE(memcmp(expected, output, output_len) == 0);
+  TEST_ASSERT_EQUAL_UINT64(word_num, stream->words);
+  free(output);
+  free(expected);
+}
+
+static void test_empty_input(void){
+  Stream *stream = stream_create(echo_handler, NULL, 2, DELIMITERS);
+  unsigned long output_len;
+  char *output = run_stream(stream, "", 0, &output_len);
+
+  TEST_ASSERT_EQUAL_UINT64(0, output_len);
+  TEST_ASSERT_EQUAL_UINT64(0, stream->words);
+  TEST_ASSERT_EQUAL_UINT64(0, stream->read_chunks);
+  TEST_ASSERT_TRUE(stream->first_output < 0);
+  free(output);
+
+  // only delimiters
+  output = run_stream(stream, " \n \n", 4, &output_len);
+  TEST_ASSERT_EQUAL_UINT64(0, output_len);
+  TEST_ASSERT_EQUAL_UINT64(0, stream->read_chunks);
+  free(output);
+  stream_free(stream);
+}
+
+static void test_same_as_whole_input(void){
+  unsigned long len = 3 * STREAM_MAX_CHUNKS * STREAM_CHUNK_SIZE / 2;
+  char *text;
+  Stream *stream = stream_create(echo_handler, NULL, 4, DELIMITERS);
+
+  srand(73);
+  text = random_text(len);
+
+  // a word longer than a chunk in the middle of input
+  memset(&text[len / 2], 'w', 3 * STREAM_CHUNK_SIZE);
+  assert_same_as_whole_input(stream, text, len);
+  TEST_ASSERT_TRUE(stream->read_chunks > STREAM_MAX_CHUNKS);
+  TEST_ASSERT_TRUE(stream->first_output >= 0);
+  free(text);
+  stream_free(stream);
+}
+
+static void test_word_filling_chunk(void){
+  char *text = (char *)malloc(3 * STREAM_CHUNK_SIZE);
+  Stream *stream = stream_create(echo_handler, NULL, 1, DELIMITERS);
+
+  // a word of exactly STREAM_CHUNK_SIZE fills the first read and is kept whole
+  memset(text, 'x', STREAM_CHUNK_SIZE);
+  memcpy(&text[STREAM_CHUNK_SIZE], " ab cd ", 7);
+  assert_same_as_whole_input(stream, text, STREAM_CHUNK_SIZE + 7);
+
+  // a word crossing the end of the first read
+  memcpy(text, "ab ", 3);
+  memset(&text[3], 'y', 2 * STREAM_CHUNK_SIZE);
+  memcpy(&text[3 + 2 * STREAM_CHUNK_SIZE], " cd", 3);
+  assert_same_as_whole_input(stream, text, 2 * STREAM_CHUNK_SIZE + 6);
+  TEST_ASSERT_EQUAL_UINT64(3, stream->words);
+  free(text);
+  stream_free(stream);
+}
+
+static void test_word_longer_than_max_word(void){
+  unsigned long len = STREAM_MAX_WORD + 10, output_len;
+  char *text = (char *)malloc(len), *output;
+  Stream *stream = stream_create(echo_handler, NULL, 1, DELIMITERS);
+
+  memset(text, 'z', len);
+  output = run_stream(stream, text, len, &output_len);
+
+  // split in a word of STREAM_MAX_WORD and a word of the rest
+  TEST_ASSERT_EQUAL_UINT64(len + 2, output_len);
+  TEST_ASSERT_EQUAL_UINT64(2, stream->words);
+  TEST_ASSERT_EQUAL_INT('\n', output[STREAM_MAX_WORD]);
+  TEST_ASSERT_EQUAL_INT('\n', output[len + 1]);
+  free(output);
+  free(text);
+  stream_free(stream);
+}
+
+static void test_chunk_order(void){
+  unsigned long len = 64 * STREAM_CHUNK_SIZE;
+  EchoDelay delay = {0, 3000};
+  Stream *stream = stream_create(echo_handler, &delay, 4, DELIMITERS);
+  char *text;
+
+  // a quarter of chunks finish after chunks read later
+  srand(79);
+  text = random_text(len);
+  assert_same_as_whole_input(stream, text, len);
+  free(text);
+  stream_free(stream);
+}
+
+static void test_ring_full_stall(void){
+  unsigned long len = 3 * STREAM_MAX_CHUNKS * STREAM_CHUNK_SIZE / 2;
+  EchoDelay delay = {200, 0};
+  Stream *stream = stream_create(echo_handler, &delay, 1, DELIMITERS);
+  char *text;
+
+  // a slow worker can't keep up with reader
+  srand(83);
+  text = random_text(len);
+  assert_same_as_whole_input(stream, text, len);
+  TEST_ASSERT_TRUE(stream->stalls > 0);
+  free(text);
+  stream_free(stream);
+}
+
+int main(void){
+
+  // test session
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_input);
+  RUN_TEST(test_same_as_whole_input);
+  RUN_TEST(test_word_filling_chunk);
+  RUN_TEST(test_word_longer_than_max_word);
+  RUN_TEST(test_chunk_order);
+  RUN_TEST(test_ring_full_stall);
+
+  return UNITY_END();
+}
@@ -0,0 +1,350 @@
+/**
+ * @file edit_distance_symspell.c
+ * @author Daniele Di Palma
+ * @brief Symmetric delete index over a dictionary for nearest words search with edit distance
+ *        (insertions and deletions only)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include "edit_distance_query.h"
+#include "edit_distance_symspell.h"
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+#define INITIAL_CAPACITY (1024)
+#define FNV_OFFSET (2166136261u)
+#define FNV_PRIME (16777619u)
+
+/**
+ * @brief It rappresents hashes of distinct variants of a word
+ *
+ */
+typedef struct _Variants{
+  uint32_t *hash;
+  unsigned long num;
+  unsigned long capacity;
+} Variants;
+
+static int compare_hash(const void *hash_1, const void *hash_2){
+  uint32_t hash_1_v = *(const uint32_t *)hash_1;
+  uint32_t hash_2_v = *(const uint32_t *)hash_2;
+  return (hash_1_v > hash_2_v) - (hash_1_v < hash_2_v);
+}
+
+static int compare_index(const void *idx_1, const void *idx_2){
+  uint32_t idx_1_v = *(const uint32_t *)idx_1;
+  uint32_t idx_2_v = *(const uint32_t *)idx_2;
+  return (idx_1_v > idx_2_v) - (idx_1_v < idx_2_v);
+}
+
+/**
+ * @brief Calculate FNV-1a hash of a string, 0 is reserved for empty entries
+ *
+ * @param str       string
+ * @param len       length of string
+ * @return uint32_t hash, not 0
+ */
+static uint32_t variant_hash(const char *str, unsigned long len){
+  uint32_t hash = FNV_OFFSET;
+  for(unsigned long i = 0; i < len; i++){
+    hash = (hash ^ (unsigned char)str[i]) * FNV_PRIME;
+  }
+  return hash ? hash : 1;
+}
+
+/**
+ * @brief Append hashes of all strings obtained deleting from 1 to depth characters
+ *        of str in positions not before start. Every set of positions is generated once.
+ *
+ * @param variants  variants where hashes are appended
+ * @param str       string, characters are deleted in place and restored
+ * @param len       length of string
+ * @param start     first position that can be deleted
+ * @param depth     max number of deletions
+ */
+static void generate_deletions(Variants *variants, char *str, unsigned long len, unsigned long start, unsigned depth){
+  char deleted;
+
+  for(unsigned long i = start; i < len; i++){
+    // delete str[i] shifting the suffix, restore after recursion
+    deleted = str[i];
+    memmove(&str[i], &str[i + 1], len - i - 1);
+
+    if(variants->num >= variants->capacity){
+      variants->capacity *= 2;
+      variants->hash = (uint32_t *)realloc(variants->hash, variants->capacity * sizeof(uint32_t));
+      if(variants->hash == NULL){
+        ERROR_EXIT("Unable to re-allocate variants");
+      }
+    }
+    variants->hash[variants->num++] = variant_hash(str, len - 1);
+    if(depth > 1){
+      generate_deletions(variants, str, len - 1, i, depth - 1);
+    }
+
+    memmove(&str[i + 1], &str[i], len - i - 1);
+    str[i] = deleted;
+  }
+}
+
+/**
+ * @brief Calculate hashes of distinct variants of the prefix of a word (word prefix included)
+ *
+ * @param variants    variants where hashes are stored, previous content is discarded
+ * @param word        word
+ * @param prefix_len  max length of prefix
+ * @param depth       max number of deletions
+ */
+static void word_variants(Variants *variants, const char *word, unsigned prefix_len, unsigned depth){
+  char prefix[UCHAR_MAX + 1];
+  unsigned long len = strlen(word), unique = 0;
+
+  if(len > prefix_len){
+    len = prefix_len;
+  }
+  memcpy(prefix, word, len);
+
+  variants->num = 0;
+  variants->hash[variants->num++] = variant_hash(prefix, len);
+  if(depth > 0){
+    generate_deletions(variants, prefix, len, 0, depth);
+  }
+
+  // same string can be obtained deleting different positions
+  qsort(variants->hash, variants->num, sizeof(uint32_t), compare_hash);
+  for(unsigned long i = 0; i < variants->num; i++){
+    if(i == 0 || variants->hash[i] != variants->hash[unique - 1]){
+      variants->hash[unique++] = variants->hash[i];
+    }
+  }
+  variants->num = unique;
+}
+
+/**
+ * @brief Find entry of a hash in table
+ *
+ * @param table       hash table
+ * @param capacity    capacity of table, power of 2
+ * @param key         hash of variant
+ * @return SymSpellEntry* entry with key, or empty entry where key has to be inserted
+ */
+static SymSpellEntry *find_entry(SymSpellEntry *table, unsigned long capacity, uint32_t key){
+  unsigned long pos = (key * 2654435761u) & (capacity - 1);
+  while(table[pos].key != 0 && table[pos].key != key){
+    pos = (pos + 1) & (capacity - 1);
+  }
+  return &table[pos];
+}
+
+/**
+ * @brief Double capacity of hash table of index, reinserting entries
+ *
+ * @param index   symmetric delete index
+ */
+static void grow_table(SymSpellIndex *index){
+  SymSpellEntry *old_table = index->table;
+  unsigned long old_capacity = index->capacity;
+
+  index->capacity *= 2;
+  index->table = (SymSpellEntry *)calloc(index->capacity, sizeof(SymSpellEntry));
+  if(index->table == NULL){
+    ERROR_EXIT("Unable to re-allocate hash table");
+  }
+  for(unsigned long i = 0; i < old_capacity; i++){
+    if(old_table[i].key != 0){
+      *find_entry(index->table, index->capacity, old_table[i].key) = old_table[i];
+    }
+  }
+  free(old_table);
+}
+
+SymSpellIndex *symspell_build(char **words, unsigned long word_num, unsigned max_depth, unsigned prefix_len){
+  SymSpellIndex *index = NULL;
+  SymSpellEntry *entry;
+  Variants variants;
+  unsigned long offset = 0;
+
+  if(words == NULL && word_num > 0){
+    ERROR_EXIT("Dictionary words reference can't be NULL");
+  }
+  if(word_num >= UINT32_MAX){
+    ERROR_EXIT("Too many dictionary words");
+  }
+  if(prefix_len <= max_depth || prefix_len > UCHAR_MAX){
+    ERROR_EXIT("Prefix length must be greater than max depth and not greater than 255");
+  }
+
+  index = (SymSpellIndex *)malloc(sizeof(SymSpellIndex));
+  variants.capacity = INITIAL_CAPACITY;
+  variants.hash = (uint32_t *)malloc(variants.capacity * sizeof(uint32_t));
+  if(index == NULL || variants.hash == NULL){
+    ERROR_EXIT("Unable to allocate index");
+  }
+  index->words = words;
+  index->word_num = word_num;
+  index->max_depth = max_depth;
+  index->prefix_len = prefix_len;
+  index->capacity = INITIAL_CAPACITY;
+  index->key_num = 0;
+  index->table = (SymSpellEntry *)calloc(index->capacity, sizeof(SymSpellEntry));
+  if(index->table == NULL){
+    ERROR_EXIT("Unable to allocate hash table");
+  }
+
+  // first pass: count words of every variant, table load is kept under 1/2
+  for(unsigned long i = 0; i < word_num; i++){
+    word_variants(&variants, words[i], prefix_len, max_depth);
+    for(unsigned long v = 0; v < variants.num; v++){
+      entry = find_entry(index->table, index->capacity, variants.hash[v]);
+      if(entry->key == 0){
+        if(2 * (index->key_num + 1) > index->capacity){
+          grow_table(index);
+          entry = find_entry(index->table, index->capacity, variants.hash[v]);
+        }
+        entry->key = variants.hash[v];
+        index->key_num++;
+      }
+      entry->count++;
+    }
+  }
+
+  for(unsigned long i = 0; i < index->capacity; i++){
+    index->table[i].start = (uint32_t)offset;
+    offset += index->table[i].count;
+    index->table[i].count = 0;
+  }
+  if(offset >= UINT32_MAX){
+    ERROR_EXIT("Too many variants, reduce max depth or prefix length");
+  }
+  index->posting_num = offset;
+  index->postings = (uint32_t *)malloc((offset > 0 ? offset : 1) * sizeof(uint32_t));
+  if(index->postings == NULL){
+    ERROR_EXIT("Unable to allocate postings");
+  }
+
+  // second pass: store words, in dictionary order for every variant
+  for(unsigned long i = 0; i < word_num; i++){
+    word_variants(&variants, words[i], prefix_len, max_depth);
+    for(unsigned long v = 0; v < variants.num; v++){
+      entry = find_entry(index->table, index->capacity, variants.hash[v]);
+      index->postings[entry->start + entry->count++] = (uint32_t)i;
+    }
+  }
+
+  free(variants.hash);
+  return index;
+}
+
+unsigned symspell_search_min(const SymSpellIndex *index, const char *word, unsigned long **results, unsigned long *result_num){
+  Variants variants;
+  SymSpellEntry *entry;
+  EdQuery *query = NULL;
+  uint32_t *candidates = NULL;
+  unsigned *distances = NULL;
+  unsigned long cand_num = 0, cand_capacity = INITIAL_CAPACITY, unique = 0, found_num = 0;
+  unsigned best, distance;
+
+  if(index == NULL){
+    ERROR_EXIT("Index reference can't be NULL");
+  }
+  if(word == NULL){
+    ERROR_EXIT("Word to search is NULL");
+  }
+  if(results == NULL || result_num == NULL){
+    ERROR_EXIT("Results references can't be NULL");
+  }
+
+  *results = NULL;
+  *result_num = 0;
+  best = index->max_depth + 1;
+
+  variants.capacity = INITIAL_CAPACITY;
+  variants.hash = (uint32_t *)malloc(variants.capacity * sizeof(uint32_t));
+  candidates = (uint32_t *)malloc(cand_capacity * sizeof(uint32_t));
+  if(variants.hash == NULL || candidates == NULL){
+    ERROR_EXIT("Unable to allocate memory for search");
+  }
+
+  // candidates are words sharing a variant with word
+  word_variants(&variants, word, index->prefix_len, index->max_depth);
+  for(unsigned long v = 0; v < variants.num; v++){
+    entry = find_entry(index->table, index->capacity, variants.hash[v]);
+    if(entry->key == 0){
+      continue;
+    }
+    if(cand_num + entry->count > cand_capacity){
+      while(cand_num + entry->count > cand_capacity){
+        cand_capacity *= 2;
+      }
+      candidates = (uint32_t *)realloc(candidates, cand_capacity * sizeof(uint32_t));
+      if(candidates == NULL){
+        ERROR_EXIT("Unable to re-allocate candidates");
+      }
+    }
+    memcpy(&candidates[cand_num], &index->postings[entry->start], entry->count * sizeof(uint32_t));
+    cand_num += entry->count;
+  }
+  free(variants.hash);
+
+  qsort(candidates, cand_num, sizeof(uint32_t), compare_index);
+  for(unsigned long i = 0; i < cand_num; i++){
+    if(i == 0 || candidates[i] != candidates[unique - 1]){
+      candidates[unique++] = candidates[i];
+    }
+  }
+  cand_num = unique;
+
+  // verification, distances above best found so far are not needed
+  distances = (unsigned *)malloc((cand_num > 0 ? cand_num : 1) * sizeof(unsigned));
+  if(distances == NULL){
+    ERROR_EXIT("Unable to allocate distances");
+  }
+  query = ed_query_build(word);
+  for(unsigned long i = 0; i < cand_num; i++){
+    distance = ed_query_distance(query, index->words[candidates[i]], best > index->max_depth ? index->max_depth : best);
+    distances[i] = distance;
+    if(distance < best){
+      best = distance;
+    }
+  }
+  ed_query_free(query);
+
+  if(best <= index->max_depth){
+    *results = (unsigned long *)malloc(cand_num * sizeof(unsigned long));
+    if(*results == NULL){
+      ERROR_EXIT("Unable to allocate results");
+    }
+    for(unsigned long i = 0; i < cand_num; i++){
+      if(distances[i] == best){
+        (*results)[found_num++] = candidates[i];
+      }
+    }
+    *result_num = found_num;
+  }
+
+  free(candidates);
+  free(distances);
+  return best;
+}
+
+unsigned long symspell_size(const SymSpellIndex *index){
+  if(index == NULL){
+    ERROR_EXIT("Index reference can't be NULL");
+  }
+  return sizeof(SymSpellIndex) + index->capacity * sizeof(SymSpellEntry) + index->posting_num * sizeof(uint32_t);
+}
+
+void symspell_free(SymSpellIndex *index){
+  if(index != NULL){
+    free(index->table);
+    free(index->postings);
+    free(index);
+  }
+}
@@ -0,0 +1,78 @@
+#ifndef _EDIT_DISTANCE_SYMSPELL_H_
+#define _EDIT_DISTANCE_SYMSPELL_H_
+
+#include <stdint.h>
+
+/**
+ * @brief It rappresents an entry of deletions hash table: hash of a deletion variant
+ *        and range of dictionary words having it in postings array.
+ */
+typedef struct _SymSpellEntry{
+  uint32_t key;     // hash of variant, 0 if entry is empty
+  uint32_t start;   // first word in postings
+  uint32_t count;   // number of words
+} SymSpellEntry;
+
+/**
+ * @brief It rappresents a symmetric delete index over a dictionary with edit distance
+ *        (insertions and deletions only).
+ *        Two words are at distance <= d if they have a common subsequence reachable
+ *        with at most d deletions from each of them, so every string obtained with
+ *        up to max_depth deletions (variant) of a dictionary word is mapped to the word.
+ *        Variants are generated only from the first prefix_len characters of words:
+ *        prefixes of words at distance <= d are still reachable with at most d deletions
+ *        from each side, so no correction is lost and index size doesn't depend on word length.
+ *        Only hashes of variants are stored, candidates are verified with edit distance.
+ */
+typedef struct _SymSpellIndex{
+  char **words;             // dictionary words, not copied
+  unsigned long word_num;   // number of dictionary words
+  unsigned max_depth;       // max number of deletions
+  unsigned prefix_len;      // max length of word prefix used for variants
+  SymSpellEntry *table;     // open addressing hash table of variants
+  unsigned long capacity;   // capacity of table, power of 2
+  unsigned long key_num;    // number of distinct variants
+  uint32_t *postings;       // words of every variant, in dictionary order
+  unsigned long posting_num;// number of postings
+} SymSpellIndex;
+
+/**
+ * @brief Build symmetric delete index of dictionary words. Words are not copied,
+ *        they must live as long as the index.
+ *
+ * @param words         array of dictionary words, can't be NULL if word_num > 0
+ * @param word_num      number of words, less than 2^32
+ * @param max_depth     max number of deletions, max distance of searches
+ * @param prefix_len    length of prefix used for variants, greater than max_depth
+ * @return SymSpellIndex* allocated index, to free with symspell_free
+ */
+SymSpellIndex *symspell_build(char **words, unsigned long word_num, unsigned max_depth, unsigned prefix_len);
+
+/**
+ * @brief Search all dictionary words at minimum distance from word, if it is not greater than max_depth.
+ *
+ * @param index       symmetric delete index, can't be NULL
+ * @param word        word to search, can't be NULL
+ * @param results     address where an allocated array of indexes of found words is stored,
+ *                    in dictionary order, to free by caller (NULL if no word is found)
+ * @param result_num  address where number of found words is stored
+ * @return unsigned   minimum distance, max_depth + 1 if no word is found
+ */
+unsigned symspell_search_min(const SymSpellIndex *index, const char *word, unsigned long **results, unsigned long *result_num);
+
+/**
+ * @brief Calculate memory used by index (not by dictionary words)
+ *
+ * @param index           symmetric delete index, can't be NULL
+ * @return unsigned long  size in bytes
+ */
+unsigned long symspell_size(const SymSpellIndex *index);
+
+/**
+ * @brief Free index (not dictionary words)
+ *
+ * @param index   index to free
+ */
+void symspell_free(SymSpellIndex *index);
+
+#endif
@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "unity/unity.h"
+#include "edit_distance_symspell.h"
+#include "edit_distance_index_test.h"
+
+static unsigned search_min(const void *index, const char *word, unsigned max_distance, unsigned long **results, unsigned long *result_num){
+  (void)max_distance;
+  return symspell_search_min((const SymSpellIndex *)index, word, results, result_num);
+}
+
+static void test_empty_index(void){
+  SymSpellIndex *index = symspell_build(NULL, 0, 2, 7);
+  unsigned long *found, found_num;
+
+  TEST_ASSERT_EQUAL_INT(3, symspell_search_min(index, "casa", &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(0, found_num);
+  TEST_ASSERT_NULL(found);
+  symspell_free(index);
+}
+
+static void test_truncated_words_share_variants(void){
+  char *long_word[] = {"abcdefgh"}, *short_word[] = {"abcd"};
+  SymSpellIndex *index_long = symspell_build(long_word, 1, 2, 4);
+  SymSpellIndex *index_short = symspell_build(short_word, 1, 2, 4);
+  SymSpellIndex *index_full = symspell_build(long_word, 1, 2, 8);
+
+  // only the first 4 characters are indexed
+  TEST_ASSERT_EQUAL_UINT64(index_short->key_num, index_long->key_num);
+  TEST_ASSERT_EQUAL_UINT64(index_short->posting_num, index_long->posting_num);
+  TEST_ASSERT_TRUE(index_long->key_num < index_full->key_num);
+  symspell_free(index_long);
+  symspell_free(index_short);
+  symspell_free(index_full);
+}
+
+static void test_difference_after_prefix(void){
+  char *words[] = {"abcdefgh", "abcdxyzw", "abcd"};
+  SymSpellIndex *index = symspell_build(words, 3, 2, 4);
+  unsigned long *found, found_num;
+
+  // all words are candidates, verification tells them apart
+  TEST_ASSERT_EQUAL_INT(0, symspell_search_min(index, "abcdefgh", &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(1, found_num);
+  TEST_ASSERT_EQUAL_UINT64(0, found[0]);
+  free(found);
+
+  TEST_ASSERT_EQUAL_INT(1, symspell_search_min(index, "abcdxyz", &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(1, found_num);
+  TEST_ASSERT_EQUAL_UINT64(1, found[0]);
+  free(found);
+
+  TEST_ASSERT_EQUAL_INT(2, symspell_search_min(index, "abcdxy", &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(2, found_num);
+  TEST_ASSERT_EQUAL_UINT64(1, found[0]);
+  TEST_ASSERT_EQUAL_UINT64(2, found[1]);
+  free(found);
+  symspell_free(index);
+}
+
+static void test_difference_in_prefix(void){
+  char *words[] = {"passato"};
+  SymSpellIndex *index = symspell_build(words, 1, 2, 3);
+  unsigned long *found, found_num;
+
+  // prefixes "ass" and "pas" meet at "as"
+  TEST_ASSERT_EQUAL_INT(1, symspell_search_min(index, "assato", &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(1, found_num);
+  free(found);
+
+  // prefixes "xxp" and "pas" meet at "p" with 2 deletions each
+  TEST_ASSERT_EQUAL_INT(2, symspell_search_min(index, "xxpassato", &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(1, found_num);
+  free(found);
+
+  TEST_ASSERT_EQUAL_INT(3, symspell_search_min(index, "xxxpassato", &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(0, found_num);
+  TEST_ASSERT_NULL(found);
+  symspell_free(index);
+}
+
+static void test_index_size(void){
+  char *words[] = {"casa", "cassa", "cosa", "tassa", "passato", "pioppo", "cara"};
+  SymSpellIndex *index_1 = symspell_build(words, 7, 1, 7);
+  SymSpellIndex *index_2 = symspell_build(words, 7, 2, 7);
+  SymSpellIndex *index_3 = symspell_build(words, 7, 2, 3);
+
+  TEST_ASSERT_TRUE(symspell_size(index_1) > 0);
+  TEST_ASSERT_TRUE(index_1->posting_num < index_2->posting_num);
+  TEST_ASSERT_TRUE(index_3->posting_num < index_2->posting_num);
+  symspell_free(index_1);
+  symspell_free(index_2);
+  symspell_free(index_3);
+}
+
+static void test_same_as_linear_scan(void){
+  char **words;
+  SymSpellIndex *index;
+
+  srand(31);
+  words = random_words(2000, 14, 4);
+
+  // shortest prefix allowed truncates almost every word
+  for(unsigned max_depth = 1; max_depth <= 3; max_depth++){
+    for(unsigned prefix_len = max_depth + 1; prefix_len <= 10; prefix_len += 9 - max_depth){
+      index = symspell_build(words, 2000, max_depth, prefix_len);
+      assert_same_as_linear_scan(index, search_min, words, 2000, max_depth, 100, 16, 4);
+      symspell_free(index);
+    }
+  }
+  free_random_words(words, 2000);
+}
+
+int main(void){
+
+  // test session
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_index);
+  RUN_TEST(test_truncated_words_share_variants);
+  RUN_TEST(test_difference_after_prefix);
+  RUN_TEST(test_difference_in_prefix);
+  RUN_TEST(test_index_size);
+  RUN_TEST(test_same_as_linear_scan);
+
+  return UNITY_END();
+}
@@ -0,0 +1,291 @@
+/**
+ * @file edit_distance_tokens.c
+ * @author Daniele Di Palma
+ * @brief Loading of words of text files in a single arena, with delimiters found
+ *        by SSE4.1 / AVX2 character class lookup selected at runtime
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "edit_distance_simd.h"
+#include "edit_distance_tokens.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86
+#endif
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+#define ALPHABET_SIZE (UCHAR_MAX + 1)
+#define BLOCK_SIZE (64)         // characters classified at a time, a bit of mask each
+#define NIBBLE_GROUPS (8)       // distinct high nibbles of delimiters supported by SIMD lookup
+#define READ_SIZE (1 << 20)     // bytes read at a time from files that can't be mapped
+
+/**
+ * @brief It rappresents a set of delimiters. A character c is a delimiter if
+ *        low[c & 15] & high[c >> 4] != 0: every distinct high nibble of delimiters has
+ *        its own bit, so the two 16 entries tables are exact with up to 8 of them.
+ */
+typedef struct _DelimiterClass{
+  unsigned char table[ALPHABET_SIZE]; // 1 for delimiters
+  unsigned char low[16];              // bits of high nibbles of delimiters with a low nibble
+  unsigned char high[16];             // bit of a high nibble, 0 if no delimiter has it
+  int nibble_groups;                  // number of distinct high nibbles of delimiters
+} DelimiterClass;
+
+/**
+ * @brief It rappresents a kernel classifying BLOCK_SIZE characters
+ *
+ * @param block       characters
+ * @param delimiters  set of delimiters
+ * @return uint64_t   bit i set if block[i] is a delimiter
+ */
+typedef uint64_t (*ClassKernel)(const unsigned char *block, const DelimiterClass *delimiters);
+
+static void build_class(DelimiterClass *delimiters, const char *chars){
+  const unsigned char *c;
+
+  memset(delimiters, 0, sizeof(DelimiterClass));
+  delimiters->table[0] = 1;
+  for(c = (const unsigned char *)chars; *c != '\0'; c++){
+    delimiters->table[*c] = 1;
+  }
+  for(unsigned i = 0; i < ALPHABET_SIZE; i++){
+    if(delimiters->table[i]){
+      if(delimiters->high[i >> 4] == 0){
+        if(delimiters->nibble_groups++ >= NIBBLE_GROUPS){
+          continue;
+        }
+        delimiters->high[i >> 4] = (unsigned char)(1 << (delimiters->nibble_groups - 1));
+      }
+      delimiters->low[i & 15] |= delimiters->high[i >> 4];
+    }
+  }
+}
+
+/**
+ * @brief Classify a block one character at a time
+ */
+static uint64_t class_scalar(const unsigned char *block, const DelimiterClass *delimiters){
+  uint64_t mask = 0;
+
+  for(unsigned i = 0; i < BLOCK_SIZE; i++){
+    mask |= (uint64_t)delimiters->table[block[i]] << i;
+  }
+  return mask;
+}
+
+#ifdef SIMD_X86
+
+/**
+ * @brief Classify a block 16 characters at a time with SSE4.1
+ */
+__attribute__((target("sse4.1")))
+static uint64_t class_sse41(const unsigned char *block, const DelimiterClass *delimiters){
+  const __m128i low = _mm_loadu_si128((const __m128i *)delimiters->low), high = _mm_loadu_si128((const __m128i *)delimiters->high);
+  const __m128i nibble = _mm_set1_epi8(0x0f), zero = _mm_setzero_si128();
+  __m128i v, groups;
+  uint64_t mask = 0;
+
+  for(unsigned i = 0; i < BLOCK_SIZE; i += 16){
+    v = _mm_loadu_si128((const __m128i *)&block[i]);
+    groups = _mm_and_si128(_mm_shuffle_epi8(low, _mm_and_si128(v, nibble)),
+                           _mm_shuffle_epi8(high, _mm_and_si128(_mm_srli_epi16(v, 4), nibble)));
+    mask |= (uint64_t)(uint16_t)~_mm_movemask_epi8(_mm_cmpeq_epi8(groups, zero)) << i;
+  }
+  return mask;
+}
+
+/**
+ * @brief Classify a block 32 characters at a time with AVX2
+ */
+__attribute__((target("avx2")))
+static uint64_t class_avx2(const unsigned char *block, const DelimiterClass *delimiters){
+  const __m256i low = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)delimiters->low));
+  const __m256i high = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)delimiters->high));
+  const __m256i nibble = _mm256_set1_epi8(0x0f), zero = _mm256_setzero_si256();
+  __m256i v, groups;
+  uint64_t mask = 0;
+
+  for(unsigned i = 0; i < BLOCK_SIZE; i += 32){
+    v = _mm256_loadu_si256((const __m256i *)&block[i]);
+    groups = _mm256_and_si256(_mm256_shuffle_epi8(low, _mm256_and_si256(v, nibble)),
+                              _mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble)));
+    mask |= (uint64_t)(uint32_t)~_mm256_movemask_epi8(_mm256_cmpeq_epi8(groups, zero)) << i;
+  }
+  return mask;
+}
+
+#endif
+
+/**
+ * @brief Scan text block by block: bits of words starting and ending in a block are found from
+ *        its mask, so characters inside words are never looked at one by one.
+ *        Without tokens->word words are only counted, in tokens->word_num and tokens->arena_size,
+ *        otherwise they are copied in arena.
+ *
+ * @param text        text
+ * @param len         length of text
+ * @param delimiters  set of delimiters
+ * @param kernel      kernel classifying blocks
+ * @param tokens      words to count or to fill
+ */
+static void scan_text(const unsigned char *text, unsigned long len, const DelimiterClass *delimiters, ClassKernel kernel, TokenFile *tokens){
+  unsigned char tail[BLOCK_SIZE];
+  unsigned long base, start = 0, end, arena_len = 0, word_num = 0, letters = 0;
+  uint64_t mask, word, starts, ends, events, carry = 0;
+  unsigned bit;
+
+  for(base = 0; base < len; base += BLOCK_SIZE){
+    if(len - base >= BLOCK_SIZE){
+      mask = kernel(&text[base], delimiters);
+    }else{
+      // padding '\0' are delimiters
+      memset(tail, 0, BLOCK_SIZE);
+      memcpy(tail, &text[base], len - base);
+      mask = kernel(tail, delimiters);
+    }
+    word = ~mask;
+    starts = word & ~((word << 1) | carry);
+    ends = mask & ((word << 1) | carry);
+    carry = word >> (BLOCK_SIZE - 1);
+
+    if(tokens->word == NULL){
+      word_num += (unsigned long)__builtin_popcountll(starts);
+      letters += (unsigned long)__builtin_popcountll(word);
+      continue;
+    }
+    // starts and ends alternate
+    for(events = starts | ends; events != 0; events &= events - 1){
+      bit = (unsigned)__builtin_ctzll(events);
+      if(starts >> bit & 1){
+        start = base + bit;
+      }else{
+        end = base + bit;
+        memcpy(&tokens->arena[arena_len], &text[start], end - start);
+        tokens->arena[arena_len + end - start] = '\0';
+        tokens->word[word_num++] = &tokens->arena[arena_len];
+        arena_len += end - start + 1;
+      }
+    }
+  }
+
+  if(tokens->word == NULL){
+    tokens->word_num = word_num;
+    tokens->arena_size = letters + word_num;
+  }else if(carry){
+    // last word reaches end of text
+    memcpy(&tokens->arena[arena_len], &text[start], len - start);
+    tokens->arena[arena_len + len - start] = '\0';
+    tokens->word[word_num++] = &tokens->arena[arena_len];
+  }
+}
+
+TokenFile *token_file_parse_with(const char *text, unsigned long len, const char *delimiters, int kernel){
+  TokenFile *tokens = NULL;
+  DelimiterClass delimiter_class;
+  ClassKernel class_kernel = class_scalar;
+
+  if((text == NULL && len > 0) || delimiters == NULL){
+    ERROR_EXIT("Text and delimiters can't be NULL");
+  }
+  if(kernel < SIMD_KERNEL_SCALAR || kernel > edit_distance_simd_kernel()){
+    ERROR_EXIT("Kernel not supported by cpu");
+  }
+  build_class(&delimiter_class, delimiters);
+#ifdef SIMD_X86
+  if(delimiter_class.nibble_groups <= NIBBLE_GROUPS){
+    if(kernel == SIMD_KERNEL_AVX2){
+      class_kernel = class_avx2;
+    }else if(kernel == SIMD_KERNEL_SSE41){
+      class_kernel = class_sse41;
+    }
+  }
+#endif
+
+  tokens = (TokenFile *)malloc(sizeof(TokenFile));
+  if(tokens == NULL){
+    ERROR_EXIT("Unable to allocate tokens");
+  }
+  tokens->word = NULL;
+  scan_text((const unsigned char *)text, len, &delimiter_class, class_kernel, tokens);
+
+  tokens->arena = (char *)malloc(tokens->arena_size > 0 ? tokens->arena_size : 1);
+  tokens->word = (char **)malloc((tokens->word_num > 0 ? tokens->word_num : 1) * sizeof(char *));
+  if(tokens->arena == NULL || tokens->word == NULL){
+    ERROR_EXIT("Unable to allocate words");
+  }
+  scan_text((const unsigned char *)text, len, &delimiter_class, class_kernel, tokens);
+  return tokens;
+}
+
+TokenFile *token_file_parse(const char *text, unsigned long len, const char *delimiters){
+  return token_file_parse_with(text, len, delimiters, edit_distance_simd_kernel());
+}
+
+TokenFile *token_file_load(const char *path, const char *delimiters){
+  TokenFile *tokens = NULL;
+  struct stat file_stat;
+  char *data = NULL, *grown = NULL;
+  unsigned long len = 0, capacity = READ_SIZE;
+  ssize_t read_size;
+  int fd;
+
+  if(path == NULL){
+    ERROR_EXIT("Path can't be NULL");
+  }
+  fd = open(path, O_RDONLY);
+  if(fd < 0 || fstat(fd, &file_stat) != 0){
+    ERROR_EXIT("Unable to open the file");
+  }
+
+  if(S_ISREG(file_stat.st_mode) && file_stat.st_size > 0 &&
+     (data = (char *)mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) != MAP_FAILED){
+    madvise(data, (size_t)file_stat.st_size, MADV_SEQUENTIAL);
+    tokens = token_file_parse(data, (unsigned long)file_stat.st_size, delimiters);
+    munmap(data, (size_t)file_stat.st_size);
+  }else{
+    data = (char *)malloc(capacity);
+    if(data == NULL){
+      ERROR_EXIT("Unable to allocate buffer");
+    }
+    while((read_size = read(fd, &data[len], capacity - len)) > 0){
+      len += (unsigned long)read_size;
+      if(len == capacity){
+        grown = (char *)realloc(data, capacity * 2);
+        if(grown == NULL){
+          ERROR_EXIT("Unable to re-allocate buffer");
+        }
+        data = grown;
+        capacity *= 2;
+      }
+    }
+    if(read_size < 0){
+      ERROR_EXIT("Unable to read the file");
+    }
+    tokens = token_file_parse(data, len, delimiters);
+    free(data);
+  }
+
+  close(fd);
+  return tokens;
+}
+
+void token_file_free(TokenFile *tokens){
+  if(tokens != NULL){
+    free(tokens->arena);
+    free(tokens->word);
+    free(tokens);
+  }
+}
@@ -0,0 +1,57 @@
+#ifndef _EDIT_DISTANCE_TOKENS_H_
+#define _EDIT_DISTANCE_TOKENS_H_
+
+/**
+ * @brief It rappresents the words of a text split by delimiters, all stored in a single arena:
+ *        every word is followed by '\0', so words are strings that don't need to be freed one by one.
+ *        Loading allocates only the arena and the array of words, both sized exactly by a first
+ *        scan of text, whatever the number of words and the length of lines.
+ */
+typedef struct _TokenFile{
+  char *arena;              // words in text order, each one terminated by '\0'
+  unsigned long arena_size; // size of arena in bytes
+  char **word;              // pointer to every word in arena
+  unsigned long word_num;   // number of words
+} TokenFile;
+
+/**
+ * @brief Split text in words. Delimiters are found 64 characters at a time with a
+ *        character class lookup (SIMD if supported, see edit_distance_simd_kernel);
+ *        '\0' is always a delimiter.
+ *
+ * @param text        text, can't be NULL if len > 0
+ * @param len         length of text
+ * @param delimiters  characters separating words, can't be NULL
+ * @return TokenFile* allocated words, to free with token_file_free
+ */
+TokenFile *token_file_parse(const char *text, unsigned long len, const char *delimiters);
+
+/**
+ * @brief Calculate token_file_parse with a given kernel
+ *
+ * @param text        text, can't be NULL if len > 0
+ * @param len         length of text
+ * @param delimiters  characters separating words, can't be NULL
+ * @param kernel      SIMD_KERNEL_SCALAR, SIMD_KERNEL_SSE41 or SIMD_KERNEL_AVX2, supported by cpu
+ * @return TokenFile* allocated words, to free with token_file_free
+ */
+TokenFile *token_file_parse_with(const char *text, unsigned long len, const char *delimiters, int kernel);
+
+/**
+ * @brief Load words of a file split by delimiters.
+ *        Regular files are mapped in memory, other files (e.g. pipes) are read entirely.
+ *
+ * @param path        path of file, can't be NULL
+ * @param delimiters  characters separating words, can't be NULL
+ * @return TokenFile* allocated words, to free with token_file_free
+ */
+TokenFile *token_file_load(const char *path, const char *delimiters);
+
+/**
+ * @brief Free words and their arena
+ *
+ * @param tokens  words to free
+ */
+void token_file_free(TokenFile *tokens);
+
+#endif
@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "unity/unity.h"
+#include "edit_distance_simd.h"
+#include "edit_distance_tokens.h"
+
+/**
+ * @brief Check words of text against strtok on a copy of text, with every supported kernel
+ */
+static void assert_same_as_strtok(const char *text, unsigned long len, const char *delimiters){
+  char *copy = (char *)malloc(len + 1), *word;
+  const char *zero;
+  TokenFile *tokens;
+  unsigned long i, next;
+
+  for(int kernel = SIMD_KERNEL_SCALAR; kernel <= edit_distance_simd_kernel(); kernel++){
+    memcpy(copy, text, len);
+    copy[len] = '\0';
+    tokens = token_file_parse_with(text, len, delimiters, kernel);
+    i = 0;
+    // '\0' ends text for strtok, so text is split at every '\0' first
+    for(unsigned long from = 0; from <= len; from = next + 1){
+      zero = (const char *)memchr(&text[from], '\0', len - from);
+      next = (zero != NULL) ? (unsigned long)(zero - text) : len;
+      for(word = strtok(&copy[from], delimiters); word != NULL; word = strtok(NULL, delimiters)){
+        TEST_ASSERT_TRUE(i < tokens->word_num);
+        TEST_ASSERT_EQUAL_STRING(word, tokens->word[i]);
+        i++;
+      }
+    }
+    TEST_ASSERT_EQUAL_UINT64(i, tokens->word_num);
+    token_file_free(tokens);
+  }
+  free(copy);
+}
+
+static void test_small_texts(void){
+  TokenFile *tokens = token_file_parse("Quando avevo cinqve anni, mia made", 34, " .,:\n");
+
+  TEST_ASSERT_EQUAL_UINT64(6, tokens->word_num);
+  TEST_ASSERT_EQUAL_STRING("Quando", tokens->word[0]);
+  TEST_ASSERT_EQUAL_STRING("anni", tokens->word[3]);
+  TEST_ASSERT_EQUAL_STRING("made", tokens->word[5]);
+  // words and their terminators only
+  TEST_ASSERT_EQUAL_UINT64(28 + 6, tokens->arena_size);
+  token_file_free(tokens);
+
+  tokens = token_file_parse(NULL, 0, " ");
+  TEST_ASSERT_EQUAL_UINT64(0, tokens->word_num);
+  token_file_free(tokens);
+
+  assert_same_as_strtok(" \n\n  ", 5, " \n");
+  assert_same_as_strtok("uno", 3, " \n");
+  assert_same_as_strtok("uno\0due tre", 11, " \n");
+}
+
+static void test_block_boundaries(void){
+  char text[200];
+
+  // words crossing blocks and ending with text, at every length around blocks
+  for(unsigned long len = 1; len < 200; len++){
+    for(unsigned long i = 0; i < len; i++){
+      text[i] = (i % 7 == 3 || i == 63 || i == 64) ? ' ' : (char)('a' + i % 26);
+    }
+    assert_same_as_strtok(text, len, " ");
+  }
+}
+
+static void test_random_texts(void){
+  char text[5000];
+  const char *delimiter_sets[] = { " .,:\n", " \n", "\x01\x12\x23\x34\x45\x56\x67\x78\x89\x9a", "a\xe0" };
+
+  srand(71);
+  for(int t = 0; t < 400; t++){
+    unsigned long len = (unsigned long)rand() % 5000;
+    for(unsigned long i = 0; i < len; i++){
+      // any byte, delimiters more frequent, long words sometimes
+      if(t % 4 == 0){
+        text[i] = (char)(rand() % 256);
+      }else if(rand() % ((t % 3) ? 6 : 1500) == 0){
+        text[i] = delimiter_sets[t % 4][rand() % (int)strlen(delimiter_sets[t % 4])];
+      }else{
+        text[i] = (char)('A' + rand() % 60);
+      }
+    }
+    assert_same_as_strtok(text, len, delimiter_sets[t % 4]);
+  }
+}
+
+static void test_load_file(void){
+  char path[] = "/tmp/tokens_test_XXXXXX", text[3000];
+  int fd = mkstemp(path);
+  TokenFile *tokens;
+
+  // a line longer than any line buffer
+  memset(text, 'x', 2000);
+  strcpy(&text[2000], "\ncasa cassa\n\ncosa");
+  TEST_ASSERT_TRUE(fd >= 0);
+  TEST_ASSERT_EQUAL_INT64((long)strlen(text), (long)write(fd, text, strlen(text)));
+  close(fd);
+
+  tokens = token_file_load(path, " \n");
+  TEST_ASSERT_EQUAL_UINT64(4, tokens->word_num);
+  TEST_ASSERT_EQUAL_UINT64(2000, strlen(tokens->word[0]));
+  TEST_ASSERT_EQUAL_STRING("cassa", tokens->word[2]);
+  TEST_ASSERT_EQUAL_STRING("cosa", tokens->word[3]);
+  token_file_free(tokens);
+
+  // empty file
+  fd = open(path, O_WRONLY | O_TRUNC);
+  close(fd);
+  tokens = token_file_load(path, " \n");
+  TEST_ASSERT_EQUAL_UINT64(0, tokens->word_num);
+  token_file_free(tokens);
+  unlink(path);
+}
+
+int main(void){
+
+  // test session
+  UNITY_BEGIN();
+  RUN_TEST(test_small_texts);
+  RUN_TEST(test_block_boundaries);
+  RUN_TEST(test_random_texts);
+  RUN_TEST(test_load_file);
+
+  return UNITY_END();
+}
@@ -0,0 +1,304 @@
+/**
+ * @file edit_distance_trie.c
+ * @author Daniele Di Palma
+ * @brief Compact trie over a dictionary for nearest words search with edit distance
+ *        (insertions and deletions only), DP rows are shared by common prefixes
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include "edit_distance_trie.h"
+
+#define ERROR_EXIT(x){  fprintf(stderr, "[%s]-Line:%d >> " x "\n",  \
+                        __FILE__,                                   \
+                        __LINE__);                                  \
+                      exit(EXIT_FAILURE);}
+
+#define INITIAL_CAPACITY (1024)
+#define ALPHABET_SIZE (UCHAR_MAX + 1)
+#define NO_NODE (UINT32_MAX)
+
+/**
+ * @brief It rappresents trie during construction: children of a node are a list
+ *        of siblings sorted by character
+ */
+typedef struct _BuildTrie{
+  uint32_t *first_child;
+  uint32_t *next_sibling;
+  uint32_t *word;
+  uint16_t *depth;
+  unsigned char *c;
+  unsigned long node_num;
+  unsigned long capacity;
+} BuildTrie;
+
+static int compare_index(const void *idx_1, const void *idx_2){
+  unsigned long idx_1_v = *(const unsigned long *)idx_1;
+  unsigned long idx_2_v = *(const unsigned long *)idx_2;
+  return (idx_1_v > idx_2_v) - (idx_1_v < idx_2_v);
+}
+
+/**
+ * @brief Append a node without children to trie under construction
+ *
+ * @param build   trie under construction
+ * @param c       last character of prefix
+ * @param depth   length of prefix
+ * @return uint32_t index of new node
+ */
+static uint32_t new_build_node(BuildTrie *build, unsigned char c, unsigned long depth){
+  if(build->node_num >= build->capacity){
+    build->capacity *= 2;
+    build->first_child = (uint32_t *)realloc(build->first_child, build->capacity * sizeof(uint32_t));
+    build->next_sibling = (uint32_t *)realloc(build->next_sibling, build->capacity * sizeof(uint32_t));
+    build->word = (uint32_t *)realloc(build->word, build->capacity * sizeof(uint32_t));
+    build->depth = (uint16_t *)realloc(build->depth, build->capacity * sizeof(uint16_t));
+    build->c = (unsigned char *)realloc(build->c, build->capacity * sizeof(unsigned char));
+    if(build->first_child == NULL || build->next_sibling == NULL || build->word == NULL || build->depth == NULL || build->c == NULL){
+      ERROR_EXIT("Unable to re-allocate trie nodes");
+    }
+  }
+  if(build->node_num >= NO_NODE){
+    ERROR_EXIT("Too many trie nodes");
+  }
+  build->first_child[build->node_num] = NO_NODE;
+  build->next_sibling[build->node_num] = NO_NODE;
+  build->word[build->node_num] = TRIE_NO_WORD;
+  build->depth[build->node_num] = (uint16_t)depth;
+  build->c[build->node_num] = c;
+  return (uint32_t)build->node_num++;
+}
+
+Trie *trie_build(char **words, unsigned long word_num){
+  Trie *trie = NULL;
+  BuildTrie build;
+  uint32_t *last_word = NULL, *stack = NULL;
+  uint32_t children[ALPHABET_SIZE];
+  unsigned long stack_num = 0, child_num, len, next = 0;
+  uint32_t node, *link;
+  const unsigned char *uword;
+
+  if(words == NULL && word_num > 0){
+    ERROR_EXIT("Dictionary words reference can't be NULL");
+  }
+  if(word_num >= UINT32_MAX){
+    ERROR_EXIT("Too many dictionary words");
+  }
+
+  trie = (Trie *)malloc(sizeof(Trie));
+  if(trie == NULL){
+    ERROR_EXIT("Unable to allocate trie");
+  }
+  trie->words = words;
+  trie->max_depth = 0;
+  trie->next_word = (uint32_t *)malloc((word_num > 0 ? word_num : 1) * sizeof(uint32_t));
+  last_word = (uint32_t *)malloc((word_num > 0 ? word_num : 1) * sizeof(uint32_t));
+
+  build.capacity = INITIAL_CAPACITY;
+  build.node_num = 0;
+  build.first_child = (uint32_t *)malloc(build.capacity * sizeof(uint32_t));
+  build.next_sibling = (uint32_t *)malloc(build.capacity * sizeof(uint32_t));
+  build.word = (uint32_t *)malloc(build.capacity * sizeof(uint32_t));
+  build.depth = (uint16_t *)malloc(build.capacity * sizeof(uint16_t));
+  build.c = (unsigned char *)malloc(build.capacity * sizeof(unsigned char));
+  if(trie->next_word == NULL || last_word == NULL || build.first_child == NULL || build.next_sibling == NULL
+      || build.word == NULL || build.depth == NULL || build.c == NULL){
+    ERROR_EXIT("Unable to allocate trie nodes");
+  }
+  new_build_node(&build, 0, 0);
+
+  // insert words, siblings are kept sorted by character
+  for(unsigned long i = 0; i < word_num; i++){
+    uword = (const unsigned char *)words[i];
+    len = strlen(words[i]);
+    if(len > UINT16_MAX){
+      ERROR_EXIT("Word too long for trie");
+    }
+    if(len > trie->max_depth){
+      trie->max_depth = (unsigned)len;
+    }
+
+    node = 0;
+    for(unsigned long k = 0; k < len; k++){
+      link = &build.first_child[node];
+      while(*link != NO_NODE && build.c[*link] < uword[k]){
+        link = &build.next_sibling[*link];
+      }
+      if(*link == NO_NODE || build.c[*link] != uword[k]){
+        uint32_t new_node = new_build_node(&build, uword[k], k + 1);
+        // link could be moved by reallocation
+        link = &build.first_child[node];
+        while(*link != NO_NODE && build.c[*link] < uword[k]){
+          link = &build.next_sibling[*link];
+        }
+        build.next_sibling[new_node] = *link;
+        *link = new_node;
+      }
+      node = *link;
+    }
+
+    // duplicated words are chained from the first one
+    trie->next_word[i] = TRIE_NO_WORD;
+    if(build.word[node] == TRIE_NO_WORD){
+      build.word[node] = (uint32_t)i;
+    }else{
+      trie->next_word[last_word[build.word[node]]] = (uint32_t)i;
+    }
+    last_word[build.word[node]] = (uint32_t)i;
+  }
+  free(last_word);
+
+  trie->node_num = build.node_num;
+  trie->nodes = (TrieNode *)malloc(build.node_num * sizeof(TrieNode));
+  stack = (uint32_t *)malloc(build.node_num * sizeof(uint32_t));
+  if(trie->nodes == NULL || stack == NULL){
+    ERROR_EXIT("Unable to allocate trie nodes");
+  }
+
+  // preorder layout, children are pushed in reverse order to be visited sorted
+  stack[stack_num++] = 0;
+  while(stack_num > 0){
+    node = stack[--stack_num];
+
+    trie->nodes[next].word = build.word[node];
+    trie->nodes[next].depth = build.depth[node];
+    trie->nodes[next].c = build.c[node];
+    trie->nodes[next].subtree_end = (uint32_t)next;
+    next++;
+
+    child_num = 0;
+    for(uint32_t child = build.first_child[node]; child != NO_NODE; child = build.next_sibling[child]){
+      children[child_num++] = child;
+    }
+    while(child_num > 0){
+      stack[stack_num++] = children[--child_num];
+    }
+  }
+
+  // subtree of node ends at first following node not deeper than it
+  stack_num = 0;
+  for(unsigned long i = 0; i < trie->node_num; i++){
+    while(stack_num > 0 && trie->nodes[stack[stack_num - 1]].depth >= trie->nodes[i].depth){
+      trie->nodes[stack[--stack_num]].subtree_end = (uint32_t)i;
+    }
+    stack[stack_num++] = (uint32_t)i;
+  }
+  while(stack_num > 0){
+    trie->nodes[stack[--stack_num]].subtree_end = (uint32_t)trie->node_num;
+  }
+
+  free(stack);
+  free(build.first_child);
+  free(build.next_sibling);
+  free(build.word);
+  free(build.depth);
+  free(build.c);
+  return trie;
+}
+
+unsigned trie_search_min(const Trie *trie, const char *word, unsigned max_distance, unsigned long **results, unsigned long *result_num){
+  const unsigned char *uword = (const unsigned char *)word;
+  unsigned *rows = NULL, *prev, *cur;
+  unsigned long *found = NULL;
+  unsigned long len, found_num = 0, found_capacity = INITIAL_CAPACITY, i;
+  unsigned radius = max_distance, best, row_min;
+  const TrieNode *node;
+
+  if(trie == NULL){
+    ERROR_EXIT("Trie reference can't be NULL");
+  }
+  if(word == NULL){
+    ERROR_EXIT("Word to search is NULL");
+  }
+  if(results == NULL || result_num == NULL){
+    ERROR_EXIT("Results references can't be NULL");
+  }
+
+  len = strlen(word);
+  if(len + trie->max_depth >= UINT_MAX){
+    ERROR_EXIT("Strings too long");
+  }
+  if(len + 1 > SIZE_MAX / sizeof(unsigned) / (trie->max_depth + 1)){
+    ERROR_EXIT("Word too long for rows of trie depth");
+  }
+  best = (max_distance == UINT_MAX) ? UINT_MAX : max_distance + 1;
+  *results = NULL;
+  *result_num = 0;
+
+  // one row for every depth, row of a node is computed from row of its parent
+  rows = (unsigned *)malloc((trie->max_depth + 1) * (len + 1) * sizeof(unsigned));
+  found = (unsigned long *)malloc(found_capacity * sizeof(unsigned long));
+  if(rows == NULL || found == NULL){
+    ERROR_EXIT("Unable to allocate memory for search");
+  }
+  for(unsigned long j = 0; j <= len; j++){
+    rows[j] = (unsigned)j;
+  }
+
+  i = 0;
+  while(i < trie->node_num){
+    node = &trie->nodes[i];
+
+    if(node->depth == 0){
+      cur = rows;
+      row_min = 0;
+    }else{
+      prev = &rows[(node->depth - 1) * (len + 1)];
+      cur = &rows[node->depth * (len + 1)];
+      cur[0] = node->depth;
+      row_min = cur[0];
+      for(unsigned long j = 1; j <= len; j++){
+        if(node->c == uword[j - 1]){
+          cur[j] = prev[j - 1];
+        }else{
+          cur[j] = ((prev[j] < cur[j - 1]) ? prev[j] : cur[j - 1]) + 1;
+        }
+        if(cur[j] < row_min){
+          row_min = cur[j];
+        }
+      }
+    }
+
+    if(node->word != TRIE_NO_WORD && cur[len] <= radius){
+      if(cur[len] < best){
+        best = cur[len];
+        radius = best;
+        found_num = 0;
+      }
+      for(uint32_t w = node->word; w != TRIE_NO_WORD; w = trie->next_word[w]){
+        if(found_num >= found_capacity){
+          found_capacity *= 2;
+          found = (unsigned long *)realloc(found, found_capacity * sizeof(unsigned long));
+          if(found == NULL){
+            ERROR_EXIT("Unable to re-allocate found words");
+          }
+        }
+        found[found_num++] = w;
+      }
+    }
+
+    // every word with this prefix is at least at row minimum distance
+    i = (row_min > radius) ? node->subtree_end : i + 1;
+  }
+
+  free(rows);
+  if(found_num == 0){
+    free(found);
+    return best;
+  }
+  qsort(found, found_num, sizeof(unsigned long), compare_index);
+  *results = found;
+  *result_num = found_num;
+  return best;
+}
+
+void trie_free(Trie *trie){
+  if(trie != NULL){
+    free(trie->nodes);
+    free(trie->next_word);
+    free(trie);
+  }
+}
@@ -0,0 +1,63 @@
+#ifndef _EDIT_DISTANCE_TRIE_H_
+#define _EDIT_DISTANCE_TRIE_H_
+
+#include <stdint.h>
+
+#define TRIE_NO_WORD (UINT32_MAX)
+
+/**
+ * @brief It rappresents a node of trie stored in preorder: children of node i
+ *        start at i + 1 and its subtree ends (excluded) at subtree_end.
+ */
+typedef struct _TrieNode{
+  uint32_t subtree_end;   // first node after subtree
+  uint32_t word;          // first dictionary word ending in node, TRIE_NO_WORD if none
+  uint16_t depth;         // length of prefix of node (root has depth 0)
+  unsigned char c;        // last character of prefix
+} TrieNode;
+
+/**
+ * @brief It rappresents a compact trie over a dictionary.
+ *        Words sharing a prefix share the DP rows of edit distance (insertions and deletions only)
+ *        of the prefix: a search visits nodes in preorder computing one row per node from the
+ *        row of parent, and skips subtrees whose row minimum exceeds best distance found.
+ */
+typedef struct _Trie{
+  char **words;             // dictionary words, not copied
+  TrieNode *nodes;          // nodes in preorder, nodes[0] is root (empty prefix)
+  unsigned long node_num;   // number of nodes
+  uint32_t *next_word;      // next dictionary word equal to a word, TRIE_NO_WORD if none
+  unsigned max_depth;       // length of longest word
+} Trie;
+
+/**
+ * @brief Build trie of dictionary words. Words are not copied, they must live as long as the trie.
+ *        Duplicated words are kept.
+ *
+ * @param words     array of dictionary words, can't be NULL if word_num > 0
+ * @param word_num  number of words, less than 2^32
+ * @return Trie*    allocated trie, to free with trie_free
+ */
+Trie *trie_build(char **words, unsigned long word_num);
+
+/**
+ * @brief Search all dictionary words at minimum distance from word.
+ *
+ * @param trie          trie, can't be NULL
+ * @param word          word to search, can't be NULL
+ * @param max_distance  max distance of interest, UINT_MAX for no limit
+ * @param results       address where an allocated array of indexes of found words is stored,
+ *                      in dictionary order, to free by caller (NULL if no word is found)
+ * @param result_num    address where number of found words is stored
+ * @return unsigned     minimum distance, max_distance + 1 if no word is found (UINT_MAX if max_distance is UINT_MAX)
+ */
+unsigned trie_search_min(const Trie *trie, const char *word, unsigned max_distance, unsigned long **results, unsigned long *result_num);
+
+/**
+ * @brief Free trie (not dictionary words)
+ *
+ * @param trie  trie to free
+ */
+void trie_free(Trie *trie);
+
+#endif
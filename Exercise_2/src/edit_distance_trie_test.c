@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "unity/unity.h"
+#include "edit_distance_trie.h"
+#include "edit_distance_index_test.h"
+
+static unsigned search_min(const void *trie, const char *word, unsigned max_distance, unsigned long **results, unsigned long *result_num){
+  return trie_search_min((const Trie *)trie, word, max_distance, results, result_num);
+}
+
+static void test_empty_trie(void){
+  Trie *trie = trie_build(NULL, 0);
+  unsigned long *found, found_num;
+
+  TEST_ASSERT_EQUAL_UINT64(1, trie->node_num);
+  TEST_ASSERT_EQUAL_INT(0, trie->max_depth);
+  TEST_ASSERT_EQUAL_INT(UINT_MAX, trie_search_min(trie, "casa", UINT_MAX, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(0, found_num);
+  TEST_ASSERT_NULL(found);
+  trie_free(trie);
+}
+
+static void test_shared_prefixes(void){
+  char *words[] = {"casa", "cassa", "cara", "casa"};
+  Trie *trie = trie_build(words, 4);
+  unsigned long *found, found_num;
+
+  // root, c, ca, car, cara, cas, casa, cass, cassa
+  TEST_ASSERT_EQUAL_UINT64(9, trie->node_num);
+  TEST_ASSERT_EQUAL_INT(5, trie->max_depth);
+  TEST_ASSERT_EQUAL_UINT32(9, trie->nodes[1].subtree_end);
+  TEST_ASSERT_EQUAL_INT('r', trie->nodes[3].c);
+  TEST_ASSERT_EQUAL_UINT32(5, trie->nodes[3].subtree_end);
+  TEST_ASSERT_EQUAL_UINT32(2, trie->nodes[4].word);
+
+  // duplicates end in the same node
+  TEST_ASSERT_EQUAL_UINT32(0, trie->nodes[6].word);
+  TEST_ASSERT_EQUAL_UINT32(3, trie->next_word[0]);
+  TEST_ASSERT_EQUAL_INT(0, trie_search_min(trie, "casa", UINT_MAX, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(2, found_num);
+  TEST_ASSERT_EQUAL_UINT64(0, found[0]);
+  TEST_ASSERT_EQUAL_UINT64(3, found[1]);
+  free(found);
+  trie_free(trie);
+}
+
+static void test_sibling_after_deep_branch(void){
+  char *words[] = {"ac", "abxxxxxx", "bxxxxxxx"};
+  Trie *trie = trie_build(words, 3);
+  unsigned long *found, found_num;
+
+  // "ab..." fills rows up to depth 8 before "ac" reuses the row of "a"
+  TEST_ASSERT_EQUAL_INT(0, trie_search_min(trie, "ac", UINT_MAX, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(1, found_num);
+  TEST_ASSERT_EQUAL_UINT64(0, found[0]);
+  free(found);
+
+  TEST_ASSERT_EQUAL_INT(2, trie_search_min(trie, "ab", UINT_MAX, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(1, found_num);
+  TEST_ASSERT_EQUAL_UINT64(0, found[0]);
+  free(found);
+
+  // "b..." starts again from the root row
+  TEST_ASSERT_EQUAL_INT(0, trie_search_min(trie, "bxxxxxxx", UINT_MAX, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(1, found_num);
+  TEST_ASSERT_EQUAL_UINT64(2, found[0]);
+  free(found);
+  trie_free(trie);
+}
+
+static void test_empty_word_only(void){
+  char *words[] = {""};
+  Trie *trie = trie_build(words, 1);
+  unsigned long *found, found_num;
+
+  // only the root row, word ends in root
+  TEST_ASSERT_EQUAL_INT(0, trie->max_depth);
+  TEST_ASSERT_EQUAL_INT(0, trie_search_min(trie, "", UINT_MAX, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(1, found_num);
+  free(found);
+  TEST_ASSERT_EQUAL_INT(3, trie_search_min(trie, "abc", UINT_MAX, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(1, found_num);
+  free(found);
+  trie_free(trie);
+}
+
+static void test_query_longer_than_max_depth(void){
+  char *words[] = {"ab", "b"};
+  Trie *trie = trie_build(words, 2);
+  unsigned long *found, found_num;
+
+  TEST_ASSERT_EQUAL_INT(8, trie_search_min(trie, "abcdefghij", UINT_MAX, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(1, found_num);
+  TEST_ASSERT_EQUAL_UINT64(0, found[0]);
+  free(found);
+  trie_free(trie);
+}
+
+static void test_max_distance(void){
+  char *words[] = {"casa", "cassa"};
+  Trie *trie = trie_build(words, 2);
+  unsigned long *found, found_num;
+
+  TEST_ASSERT_EQUAL_INT(0, trie_search_min(trie, "casa", 0, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(1, found_num);
+  TEST_ASSERT_EQUAL_UINT64(0, found[0]);
+  free(found);
+
+  TEST_ASSERT_EQUAL_INT(1, trie_search_min(trie, "cas", 0, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(0, found_num);
+  TEST_ASSERT_NULL(found);
+
+  TEST_ASSERT_EQUAL_INT(1, trie_search_min(trie, "cas", 1, &found, &found_num));
+  TEST_ASSERT_EQUAL_UINT64(1, found_num);
+  TEST_ASSERT_EQUAL_UINT64(0, found[0]);
+  free(found);
+  trie_free(trie);
+}
+
+static void test_same_as_linear_scan(void){
+  char **words;
+  Trie *trie;
+
+  srand(29);
+  words = random_words(2000, 10, 4);
+  trie = trie_build(words, 2000);
+  assert_same_as_linear_scan(trie, search_min, words, 2000, UINT_MAX, 200, 12, 4);
+  assert_same_as_linear_scan(trie, search_min, words, 2000, 1, 200, 12, 4);
+  trie_free(trie);
+  free_random_words(words, 2000);
+}
+
+int main(void){
+
+  // test session
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_trie);
+  RUN_TEST(test_shared_prefixes);
+  RUN_TEST(test_sibling_after_deep_branch);
+  RUN_TEST(test_empty_word_only);
+  RUN_TEST(test_query_longer_than_max_depth);
+  RUN_TEST(test_max_distance);
+  RUN_TEST(test_same_as_linear_scan);
+
+  return UNITY_END();
+}